@@ -37,6 +37,11 @@ MAX_NUMBER_OF_LEVELS = 10
 QUICK_TIME = 50
 START_TIME = QUICK_TIME * (MAX_NUMBER_OF_LEVELS + 1)
 
+--How long left or right must be held before the tetromino starts sliding, and the time
+--between each move after that, in milli-seconds.
+SHIFT_REPEAT_DELAY = 170
+SHIFT_REPEAT_INTERVAL = 50
+
 MAIN_FPS = 60
 
 --Effects
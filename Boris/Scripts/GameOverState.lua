@@ -26,6 +26,8 @@ require "Scripts/Constants"
 require "Scripts/ScoreTableState"
 TableHelper = require "Scripts/TableHelperFunctions"
 
+local LogicHelper = require "Scripts/LogicHelperFunctions"
+
 local GameOverState = {}
 
 function EnterGameOverState(currentPlayer)
@@ -36,8 +38,10 @@ function GameOverState:CreateGameOverState(currentPlayer)
 	collectgarbage()	
 	
 	self.currentPlayer = currentPlayer
+	self.exiting = false
 	
 	SDLInstance.LoadTrunk(GAME_0VER_TRUNK_NAME)
+	SDLInstance.PrefetchResources(GAME_0VER_TRUNK_NAME, {TEXT_BOX_KEY_PRESSED})
 	
 	SDLInstance.HaltMusic();
 	SDLInstance.PerformOverlayEffect(GAME_OVERLAY_COLOR)	
@@ -57,6 +61,11 @@ function GameOverState:CreateGameOverState(currentPlayer)
 end
 
 function GameOverState:NameTextBox_NameInputted(input)	
+	if self.exiting then
+		return
+	end
+	
+	self.exiting = true
 	self.currentPlayer.name = input;
 	local scoreTable = dofile(SCORE_FILE_NAME)
 	
@@ -92,11 +101,16 @@ function GameOverState:NameTextBox_NameInputted(input)
 	
 	SDLInstance.FadeOutMusic(FADE_LENGTH);
 	
-	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT)
-	SDLInstance.UnloadTrunk(GAME_0VER_TRUNK_NAME)
+	--The score table is loaded in the background while this form fades out.
+	local fadeAndLoadComplete = LogicHelper.CallOnLastOf(2, function()
+		SDLInstance.UnloadTrunk(GAME_0VER_TRUNK_NAME)
+		
+		SDLInstance.PlayMusic(GLOBAL_TRUNK_NAME, MENU_BACKGROUND_MUSIC, -1, MUSIC_FADE_LENGTH)
+		EnterScoreTableState()	
+	end)
 	
-	SDLInstance.PlayMusic(GLOBAL_TRUNK_NAME, MENU_BACKGROUND_MUSIC, -1, MUSIC_FADE_LENGTH)
-	EnterScoreTableState()	
+	SDLInstance.LoadTrunkAsync(SCORE_TRUNK_NAME, fadeAndLoadComplete)
+	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT, fadeAndLoadComplete)
 end
 
 function GameOverState:NameTextBox_KeyDownHandler(keySym) 
@@ -26,6 +26,7 @@ require "Scripts/Enums"
 require "Scripts/Constants"
 require "Scripts/Player"
 require "Scripts/GameOverState"
+require "Scripts/Tetrominoes"
 
 local StringHelper = require "Scripts/StringHelperFunctions"
 local TableHelper = require "Scripts/TableHelperFunctions"
@@ -40,6 +41,7 @@ function GameState:CreateGameState()
 	collectgarbage()	
 	
 	SDLInstance.LoadTrunk(GAME_TRUNK_NAME)
+	SDLInstance.PrefetchResources(GAME_TRUNK_NAME, {TURN_TETROMINO_SOUND, LINE_REMOVED_SOUND, TETROMINO_REACHES_FLOOR_SOUND})
 	
 	self.mainForm = SDLForm.New("Main", 0, 0, GAME_TRUNK_NAME, GAME_BACKGROUND_IMAGE_NAME)
 	
@@ -48,7 +50,7 @@ function GameState:CreateGameState()
 	self.moveTetraminoTimer = SDLTimer.New(self.currentInterval)
 	self.moveTetraminoTimer:AddCycleCompleteHandler(self, self.MoveTetraminoTimer_CycleComplete)
 	
-	self.tetrominoes = dofile("Scripts/Tetrominoes.lua")
+	self.tetrominoes = GetTetrominoes()
 		
 	self:CreateLabels()
 	self:CreatePanels()
@@ -61,6 +63,9 @@ function GameState:CreateGameState()
 	self.mainForm:AddKeyDownHandler(GameState, self.MainForm_KeyDown)
 	self.mainForm:AddKeyUpHandler(GameState, self.MainForm_KeyUp)
 	
+	SDLInstance.SetKeyRepeat(SDLKeySymbols.SDLK_LEFT, SHIFT_REPEAT_DELAY, SHIFT_REPEAT_INTERVAL)
+	SDLInstance.SetKeyRepeat(SDLKeySymbols.SDLK_RIGHT, SHIFT_REPEAT_DELAY, SHIFT_REPEAT_INTERVAL)
+	
 	self.mainForm:AddChild(self.levelLabel)	
 	self.mainForm:AddChild(self.scoreLabel)
 	self.mainForm:AddChild(self.mainPanel)
@@ -68,7 +73,8 @@ function GameState:CreateGameState()
 	
 	SDLInstance.SetFocus(self.mainForm)
 	
-	math.randomseed(os.time())
+	--The seed comes from the input log while a recorded game is replayed.
+	math.randomseed(SDLInstance.GetRandomSeed())
 	
 	self.currentTetromino = self.tetrominoes[math.random(NUMBER_OF_TETROMINOES)]
 	self.nextTetromino = self.tetrominoes[math.random(NUMBER_OF_TETROMINOES)]
@@ -76,6 +82,7 @@ function GameState:CreateGameState()
 	self:ShowPreviewAndCurrentTetromino()
 	
 	self.paused = false;
+	self.over = false
 	
 	SDLInstance.PlayMusic(GLOBAL_TRUNK_NAME, MAIN_GAME_BACKGROUND_MUSIC, -1, MUSIC_FADE_LENGTH)
 	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_IN)
@@ -121,13 +128,27 @@ function GameState:MoveTetraminoTimer_CycleComplete()
 			
 			self:NextTetromino()
 		else
-			SDLInstance.UnloadTrunk(GAME_TRUNK_NAME)
-			EnterGameOverState(self.currentPlayer)
+			--The game stays on screen, with it's music playing, while the game over trunk is
+			--loaded in the background.
+			self.moveTetraminoTimer:Stop()
+			self.over = true
+			
+			SDLInstance.LoadTrunkAsync(GAME_0VER_TRUNK_NAME, function()
+				--The tetrominoes outlive this game, so they are detached from it's form.
+				self.mainForm:RemoveChild(self.currentTetromino)
+				
+				SDLInstance.UnloadTrunk(GAME_TRUNK_NAME)
+				EnterGameOverState(self.currentPlayer)
+			end)
 		end	
 	end
 end
 
 function GameState:MainForm_KeyDown(keySymbol)
+	if self.over then
+		return
+	end
+	
 	if keySymbol == SDLKeySymbols.SDLK_p then
 		self:TogglePause()
 	end
@@ -167,6 +188,10 @@ function GameState:MainForm_KeyDown(keySymbol)
 end
 
 function GameState:MainForm_KeyUp(keySymbol)	
+	if self.over then
+		return
+	end
+	
 	if keySymbol == SDLKeySymbols.SDLK_DOWN then
 		self.moveTetraminoTimer:SetInterval(self.currentInterval)
 		self.quickTime =  false
@@ -222,29 +247,9 @@ function GameState:RemoveCompletedLinesAndUpdateScore(completeLineIndexes)
 			local heightToFlash = BLOCK_SIZE.height
 			
 			table.insert(portionsToFlash, {x = xToFlash, y = yToFlash, width = widthToFlash, height = heightToFlash})
-						
-			local xToClear = 0
-			local yToClear = currentIndex
-			
-			local widthToClear = MAIN_PANEL_SIZE.width
-			local heightToClear = 1
-			
-			self.mainPanel:ClearCurrentSurfaces({x = xToClear, y = yToClear, width = widthToClear, height = heightToClear})
 		end
 		
-		for _,currentIndex in ipairs(completeLineIndexes) do
-		
-			local xToCopy = 0
-			local yToCopy = 0
-			
-			local widthToCopy = MAIN_PANEL_SIZE.width
-			local heightToCopy = currentIndex
-			
-			local xToCopyTo = 0
-			local yToCopyTo = 1
-			
-			self.mainPanel:MoveCurrentSurfaces({x = xToCopy, y = yToCopy, width = widthToCopy, height = heightToCopy}, xToCopyTo, yToCopyTo)
-		end
+		self.mainPanel:CollapseRows(completeLineIndexes)
 		
 		SDLInstance.PerformFlashEffect(portionsToFlash, 4, 3);
 		
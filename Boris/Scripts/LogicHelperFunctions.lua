@@ -28,4 +28,18 @@ function Module.XNOR(operand1, operand2)
 	return operand1 == operand2
 end
 
+--Returns a function which calls functionToCall the numberOfCalls'th time it is called, so
+--that something can wait for several events, such as a fade and a trunk loading, to finish.
+function Module.CallOnLastOf(numberOfCalls, functionToCall)
+	local callsLeft = numberOfCalls
+	
+	return function()
+		callsLeft = callsLeft - 1
+		
+		if callsLeft == 0 then
+			functionToCall()
+		end
+	end
+end
+
 return Module
\ No newline at end of file
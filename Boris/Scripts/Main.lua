@@ -38,6 +38,7 @@ end
 
 function GameStart()
 	SDLInstance.LoadTrunk(GLOBAL_TRUNK_NAME)
+	SDLInstance.PrefetchResources(GLOBAL_TRUNK_NAME, {MENU_OPTION_SELECT_SOUND})
 	SDLInstance.PlayMusic(GLOBAL_TRUNK_NAME, MENU_BACKGROUND_MUSIC, -1, MUSIC_FADE_LENGTH)
 	
 	EnterMainMenuState()
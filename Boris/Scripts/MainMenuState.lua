@@ -27,6 +27,8 @@ require "Scripts/Enums"
 require "Scripts/ScoreTableState"
 require "Scripts/GameState"
 
+local LogicHelper = require "Scripts/LogicHelperFunctions"
+
 local MainMenuState = {}
 
 function EnterMainMenuState()
@@ -35,6 +37,7 @@ end
 
 function MainMenuState:CreateMainMenuState()		
 	SDLInstance.LoadTrunk(MENU_TRUNK_NAME)
+	SDLInstance.PrefetchResources(MENU_TRUNK_NAME, {MENU_OPTION_CHANGE_SOUND})
 	
 	self.mainMenuForm = SDLForm.New("Main Menu", 0, 0, MENU_TRUNK_NAME, MENU_BACKGROUND_IMAGE_NAME)
 	self.mainMenuForm:AddKeyDownHandler(self, self.MainMenuForm_KeyDown)
@@ -43,6 +46,7 @@ function MainMenuState:CreateMainMenuState()
 		CreateMenuItem("Exit Game", self.Exit)}
 		
 	self.currentOption = 1
+	self.exiting = false
 	
 	self:GenerateMenuList()
 	
@@ -74,6 +78,10 @@ function MainMenuState:GenerateMenuList()
 end
 
 function MainMenuState:MainMenuForm_KeyDown(keySymbol)
+	if self.exiting then
+		return
+	end
+	
 	if keySymbol == SDLKeySymbols.SDLK_DOWN then
 		SDLInstance.PlaySound(MENU_TRUNK_NAME, MENU_OPTION_CHANGE_SOUND)
 		self:SetCurrentOptionEffect(nil)
@@ -93,26 +101,41 @@ end
 function MainMenuState:NewGame()
 	SDLInstance.FadeOutMusic(FADE_LENGTH);
 		
-	self:ExitState()
-	EnterGameState()
+	self:ExitState(EnterGameState, GAME_TRUNK_NAME)
 end
 
 function MainMenuState:HighScores()
-	self:ExitState()
-	EnterScoreTableState()
+	self:ExitState(EnterScoreTableState, SCORE_TRUNK_NAME)
 end
 
 function MainMenuState:Exit()
 	SDLInstance.FadeOutMusic(FADE_LENGTH);
 	
-	self:ExitState()
-	SDLInstance.Quit()
+	self:ExitState(SDLInstance.Quit)
 end
 
-
-function MainMenuState:ExitState()
-	SDLInstance.UnloadTrunk(MENU_TRUNK_NAME)	
-	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT)
+--The menu keeps being drawn while it fades out, so it's trunk is only unloaded, and the
+--next state entered, once the fade is over. The trunk of the next state, if it has one, is
+--loaded in the background during the fade, and the state is only entered once it has loaded.
+function MainMenuState:ExitState(enterNextState, nextTrunkName)
+	self.exiting = true
+	
+	local numberOfEvents = 1
+	
+	if nextTrunkName then
+		numberOfEvents = 2
+	end
+	
+	local fadeAndLoadComplete = LogicHelper.CallOnLastOf(numberOfEvents, function()
+		SDLInstance.UnloadTrunk(MENU_TRUNK_NAME)
+		enterNextState()
+	end)
+	
+	if nextTrunkName then
+		SDLInstance.LoadTrunkAsync(nextTrunkName, fadeAndLoadComplete)
+	end
+	
+	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT, fadeAndLoadComplete)
 end
 
 function MainMenuState:SetCurrentOptionEffect(effect)
@@ -25,6 +25,7 @@ it freely, subject to the following restrictions:
 require "Scripts/Constants"
 require "Scripts/Enums"
 local StringHelper = require "Scripts/StringHelperFunctions"
+local LogicHelper = require "Scripts/LogicHelperFunctions"
 
 local ScoreTableState = {}
 
@@ -43,6 +44,8 @@ function ScoreTableState:CreateScoreTableState()
 	local scoreTable = dofile(SCORE_FILE_NAME)
 	self:GenerateScoreList(scoreTable);
 	
+	self.exiting = false
+	
 	SDLInstance.SetFocus(self.scoreTableForm)	
 	SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_IN)
 end
@@ -62,10 +65,16 @@ function ScoreTableState:GenerateScoreList(scoreTable)
 end
 
 function ScoreTableState:ScoreTableForm_KeyDown(keySymbol)
-	if keySymbol == SDLKeySymbols.SDLK_RETURN then
-		SDLInstance.UnloadTrunk(SCORE_TRUNK_NAME)
-		SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT)
+	if keySymbol == SDLKeySymbols.SDLK_RETURN and not self.exiting then
+		self.exiting = true
+		
+		--The menu is loaded in the background while the score table fades out.
+		local fadeAndLoadComplete = LogicHelper.CallOnLastOf(2, function()
+			SDLInstance.UnloadTrunk(SCORE_TRUNK_NAME)
+			EnterMainMenuState()
+		end)
 		
-		EnterMainMenuState()
+		SDLInstance.LoadTrunkAsync(MENU_TRUNK_NAME, fadeAndLoadComplete)
+		SDLInstance.PerformFadeEffect(NUMBER_OF_FADE_FRAMES, FADE_LENGTH, SDLFadeDirection.SDL_FD_OUT, fadeAndLoadComplete)
 	end
 end
@@ -22,276 +22,38 @@ it freely, subject to the following restrictions:
    source distribution.
 --]]
 
-local tetraLSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"LTetra",
-		{
-			{1, 1, 1},
-			{1, 0, 0}
-		},
-		GAME_TRUNK_NAME,
-		L_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"LTetra1",
-		{
-			{1, 1},
-			{0, 1},
-			{0, 1}
-		},
-		GAME_TRUNK_NAME,
-		L_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"LTetra2",
-		{
-			{0, 0, 1},
-			{1, 1, 1}
-		},
-		GAME_TRUNK_NAME,
-		L_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"LTetra3",
-		{
-			{1, 0},
-			{1, 0},
-			{1, 1}
-		},
-		GAME_TRUNK_NAME,
-		L_TETRA_BLOCK_IMAGE,
-		0, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraL = SDLSurfaceGridComponent.New("L", 0, 0, tetraLSurfaceGrids, SDLClearingMethod.SDL_CM_PRECISE);
-
-local tetraTSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"TTetra",
-		{
-			{1, 1, 1},
-			{0, 1, 0}
-		},
-		GAME_TRUNK_NAME,
-		T_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"TTetra1",
-		{
-			{0, 1},
-			{1, 1},
-			{0, 1}
-		},
-		GAME_TRUNK_NAME,
-		T_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"TTetra2",
-		{
-			{0, 1, 0},
-			{1, 1, 1}
-		},
-		GAME_TRUNK_NAME,
-		T_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"TTetra3",
-		{
-			{1, 0},
-			{1, 1},
-			{1, 0}
-		},
-		GAME_TRUNK_NAME,
-		T_TETRA_BLOCK_IMAGE,
-		0, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraT = SDLSurfaceGridComponent.New("T", 0, 0, tetraTSurfaceGrids, SDLClearingMethod.SDL_CM_PRECISE);
-
-local tetraJSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"JTetra",
-		{
-			{1, 1, 1},
-			{0, 0, 1}
-		},
-		GAME_TRUNK_NAME,
-		J_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"JTetra1",
-		{
-			{0, 1},
-			{0, 1},
-			{1, 1}
-		},
-		GAME_TRUNK_NAME,
-		J_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"JTetra2",
-		{
-			{1, 0, 0},
-			{1, 1, 1}
-		},
-		GAME_TRUNK_NAME,
-		J_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"JTetra3",
-		{
-			{1, 1},
-			{1, 0},
-			{1, 0}
-		},
-		GAME_TRUNK_NAME,
-		J_TETRA_BLOCK_IMAGE,
-		0, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraJ = SDLSurfaceGridComponent.New("J", 0, 0, tetraJSurfaceGrids, SDLClearingMethod.SDL_CM_PRECISE);
-
-local tetraSSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"STetra",
-		{
-			{0, 1, 1},
-			{1, 1, 0}
-		},
-		GAME_TRUNK_NAME,
-		S_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"STetra1",
-		{
-			{1, 0},
-			{1, 1},
-			{0, 1}
-		},
-		GAME_TRUNK_NAME,
-		S_TETRA_BLOCK_IMAGE,
-		0, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraS = SDLSurfaceGridComponent.New("S", 0, 0, tetraSSurfaceGrids, SDLClearingMethod.SDL_CM_PRECISE);
 
-local tetraZSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"ZTetra",
-		{
-			{1, 1, 0},
-			{0, 1, 1}
-		},
-		GAME_TRUNK_NAME,
-		Z_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"ZTetra1",
-		{
-			{0, 1},
-			{1, 1},
-			{1, 0}
-		},
-		GAME_TRUNK_NAME,
-		Z_TETRA_BLOCK_IMAGE,
-		1, 1,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraZ = SDLSurfaceGridComponent.New("Z", 0, 0, tetraZSurfaceGrids, SDLClearingMethod.SDL_CM_PRECISE);	
-
-local tetraOSurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"OTetra",
-		{
-			{1, 1},
-			{1, 1}
-		},
-		GAME_TRUNK_NAME,
-		O_TETRA_BLOCK_IMAGE,
-		1, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraO = SDLSurfaceGridComponent.New("O", 0, 0, tetraOSurfaceGrids, SDLClearingMethod.SDL_CM_BOUNDING_BOX);	
-
-local tetraISurfaceGrids =
-{	
-	SDLSurfaceGrid.New(
-		"ITetra",
-		{
-			{1, 1, 1, 1}
-		},
-		GAME_TRUNK_NAME,
-		I_TETRA_BLOCK_IMAGE,
-		2, 0,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	),
-	SDLSurfaceGrid.New(
-		"ITetra1",
-		{	
-			{1},
-			{1},
-			{1},
-			{1}
-		},
-		GAME_TRUNK_NAME,
-		I_TETRA_BLOCK_IMAGE,
-		0, 2,
-		AnchorPointEnum.SDL_SSP_UPPER_LEFT_CORNER
-	)
-}
-
-local tetraI = SDLSurfaceGridComponent.New("I", 0, 0, tetraISurfaceGrids, SDLClearingMethod.SDL_CM_BOUNDING_BOX);
-
-local tetrominoes = 
+--The shapes of the standard tetrominoes are built into the engine. Further shapes can be
+--added with Tetromino.Define, before they are first requested, and then listed below.
+--For example:
+--
+--	Tetromino.Define("V", 
+--		{
+--			{placement = {{1, 0}, {1, 1}}, anchorX = 0, anchorY = 0},
+--			{placement = {{1, 1}, {1, 0}}, anchorX = 0, anchorY = 1}
+--		},
+--		SDLClearingMethod.SDL_CM_PRECISE
+--	)
+
+local tetrominoBlocks =
 {
-	tetraL,
-	tetraT,
-	tetraJ,
-	tetraS,
-	tetraZ,
-	tetraO,
-	tetraI
-
-}
-
-return tetrominoes	
\ No newline at end of file
+	{name = "L", image = L_TETRA_BLOCK_IMAGE},
+	{name = "T", image = T_TETRA_BLOCK_IMAGE},
+	{name = "J", image = J_TETRA_BLOCK_IMAGE},
+	{name = "S", image = S_TETRA_BLOCK_IMAGE},
+	{name = "Z", image = Z_TETRA_BLOCK_IMAGE},
+	{name = "O", image = O_TETRA_BLOCK_IMAGE},
+	{name = "I", image = I_TETRA_BLOCK_IMAGE}
+}
+
+--Returns the tetromino components for a new game. The components are built once,
+--and the same ones are returned to every game.
+function GetTetrominoes()
+	local tetrominoes = {}
+	
+	for _,currentTetromino in ipairs(tetrominoBlocks) do
+		table.insert(tetrominoes, Tetromino.Get(currentTetromino.name, GAME_TRUNK_NAME, currentTetromino.image))
+	end
+	
+	return tetrominoes
+end
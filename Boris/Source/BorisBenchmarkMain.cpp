@@ -0,0 +1,459 @@
+#include <SDLInterface/SDLInstance.h>
+#include <SDLInterface/SDLInputLog.h>
+#include <SDLInterface/SDLForm.h>
+#include <ResourcePipelineSingleton.h>
+#include <LuaInterface/LuaLibraries.h>
+
+#include <Lua/lua.hpp>
+#include <SDL/SDL.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::fstream;
+using std::setprecision;
+using std::string;
+using std::vector;
+
+using namespace SDLInterfaceLibrary;
+
+//The number of games which are played when none is given.
+const int DEFAULT_NUMBER_OF_GAMES = 1000;
+
+//How many steps of the simulation each frame is made to take, so that the games run as
+//they would at 60 frames per second, however fast frames are actually drawn.
+const int STEPS_PER_FRAME = 16;
+
+//The names of the forms which the synthetic player acts on.
+const char* GAME_FORM_NAME = "Main";
+const char* GAME_OVER_FORM_NAME = "GameOver";
+
+//How many frames the synthetic player waits between the keys it taps outside of a game.
+const int MENU_KEY_INTERVAL = 8;
+
+//The score file is replaced, so that the benchmark leaves the real high scores alone.
+const char* BENCHMARK_SCORE_FILE_NAME = "BenchmarkScores.dat";
+
+//The drivers are set through SDL_putenv, which keeps the strings it is given.
+char VIDEO_DRIVER_VARIABLE[] = "SDL_VIDEODRIVER=dummy";
+char AUDIO_DRIVER_VARIABLE[] = "SDL_AUDIODRIVER=dummy";
+
+//Counted atomically, as resource trunks are loaded on a thread of their own.
+std::atomic<unsigned long> numberOfAllocations(0);
+
+
+void* operator new(size_t size)
+{
+	numberOfAllocations++;
+
+	void* memory = malloc(size == 0 ? 1 : size);
+
+	if(memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+/*
+Function: CountingAllocator
+
+The allocator given to the lua state, which counts the blocks which lua allocates or grows
+alongside those allocated by the game itself.
+*/
+void* CountingAllocator(void*, void* memory, size_t oldSize, size_t newSize)
+{
+	if(newSize == 0)
+	{
+		free(memory);
+		return NULL;
+	}
+
+	if(memory == NULL || newSize > oldSize)
+	{
+		numberOfAllocations++;
+	}
+
+	return realloc(memory, newSize);
+}
+
+/*
+Function: GetPeakMemoryUsage
+
+Returns the largest amount of memory which the process has had resident, in kilobytes.
+*/
+long GetPeakMemoryUsage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+
+	return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	#ifdef __APPLE__
+		return usage.ru_maxrss / 1024;
+	#else
+		return usage.ru_maxrss;
+	#endif
+#endif
+}
+
+/*
+Class: BenchmarkPlayer
+
+Plays the game for the benchmark, either by following an input log or by pressing keys
+in a way which gets through the menus and finishes each game quickly. It counts the games
+which are played, and ends the run once enough of them have been.
+*/
+class BenchmarkPlayer: public ISDLInputSource
+{
+	private:
+		//The number of games which are to be played.
+		int numberOfGames;
+		//The number of games which have ended so far.
+		int numberOfGamesPlayed;
+		//The number of frames which have been read so far.
+		unsigned long numberOfFrames;
+		//The form which had the focus when the last frame was read.
+		SDLForm* lastFocus;
+		//The log which is followed, if any.
+		SDLInputLog* inputLog;
+		//The state of the generator behind the keys which are tapped during a game.
+		unsigned int randomState;
+		//Whether the down key is currently held.
+		bool downKeyHeld;
+
+		//Returns a pseudo random number between 0 and 32767.
+		int GetRandomNumber()
+		{
+			randomState = randomState * 1103515245 + 12345;
+			return (int)((randomState >> 16) & 0x7FFF);
+		}
+
+		//Taps [keySymbol], pressing and releasing it within the same frame.
+		void TapKey(int keySymbol, vector<SDLInputEvent>& events)
+		{
+			SDLInputEvent keyDown = {SDL_IE_KEY_DOWN, keySymbol};
+			SDLInputEvent keyUp = {SDL_IE_KEY_UP, keySymbol};
+
+			events.push_back(keyDown);
+			events.push_back(keyUp);
+		}
+
+		//Sets whether the down key is held.
+		void HoldDownKey(bool held, vector<SDLInputEvent>& events)
+		{
+			if(held != downKeyHeld)
+			{
+				SDLInputEvent keyEvent = {held ? SDL_IE_KEY_DOWN : SDL_IE_KEY_UP, SDLK_DOWN};
+
+				events.push_back(keyEvent);
+				downKeyHeld = held;
+			}
+		}
+
+		//Adds the keys which are pressed in the current frame, given the form which has the focus.
+		void GenerateFrame(SDLForm* focus, vector<SDLInputEvent>& events)
+		{
+			if(focus != NULL && focus->GetName() == GAME_FORM_NAME)
+			{
+				//Blocks are dropped as fast as possible, while being moved and turned
+				//now and then, so that lines are cleared every so often.
+				HoldDownKey(true, events);
+
+				int choice = GetRandomNumber() % 32;
+
+				if(choice == 0)
+				{
+					TapKey(SDLK_LEFT, events);
+				}
+				else if(choice == 1)
+				{
+					TapKey(SDLK_RIGHT, events);
+				}
+				else if(choice == 2)
+				{
+					TapKey(SDLK_UP, events);
+				}
+			}
+			else
+			{
+				HoldDownKey(false, events);
+
+				if(numberOfFrames % MENU_KEY_INTERVAL == 0)
+				{
+					//A name is typed into the text box before it is entered.
+					if(focus != NULL && focus->GetName() == GAME_OVER_FORM_NAME)
+					{
+						TapKey(SDLK_a, events);
+					}
+
+					TapKey(SDLK_RETURN, events);
+				}
+			}
+		}
+
+	public:
+		/*
+			Constructor: BenchmarkPlayer
+
+			Parameters:
+
+				numberOfGames - The number of games after which the run is ended.
+				inputLog - The log which is followed, or NULL if the keys are to be generated.
+		*/
+		BenchmarkPlayer(int numberOfGames, SDLInputLog* inputLog)
+		{
+			this->numberOfGames = numberOfGames;
+			this->inputLog = inputLog;
+
+			numberOfGamesPlayed = 0;
+			numberOfFrames = 0;
+			lastFocus = NULL;
+			randomState = 1;
+			downKeyHeld = false;
+		}
+
+		bool ReadFrame(int& elapsedSteps, vector<SDLInputEvent>& events)
+		{
+			SDLForm* focus = SDLInstance::GetInstance().GetFocus();
+
+			if(focus != lastFocus)
+			{
+				if(focus != NULL && focus->GetName() == GAME_OVER_FORM_NAME)
+				{
+					numberOfGamesPlayed++;
+				}
+
+				lastFocus = focus;
+			}
+
+			if(numberOfGamesPlayed >= numberOfGames)
+			{
+				return false;
+			}
+
+			events.clear();
+
+			if(inputLog != NULL)
+			{
+				if(!inputLog->ReadFrame(elapsedSteps, events))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				elapsedSteps = STEPS_PER_FRAME;
+				GenerateFrame(focus, events);
+			}
+
+			numberOfFrames++;
+
+			return true;
+		}
+
+		/*
+			Function: GetNumberOfGamesPlayed
+
+			Returns the number of games which have ended so far.
+		*/
+		int GetNumberOfGamesPlayed() const
+		{
+			return numberOfGamesPlayed;
+		}
+
+		/*
+			Function: GetNumberOfFrames
+
+			Returns the number of frames which have been read so far.
+		*/
+		unsigned long GetNumberOfFrames() const
+		{
+			return numberOfFrames;
+		}
+};
+
+/*
+Runs the game headless and as fast as it can be run, for a number of games which are
+played either synthetically or from an input log, and reports how fast it ran and how
+much memory it used.
+
+Usage: BorisBenchmark [--games N] [--replay file] [--record file]
+*/
+int main(int argc, char** argv)
+{
+	int numberOfGames = DEFAULT_NUMBER_OF_GAMES;
+	const char* replayFileName = NULL;
+	const char* recordFileName = NULL;
+
+	for(int i = 1; i + 1 < argc; i++)
+	{
+		if(strcmp(argv[i], "--games") == 0)
+		{
+			numberOfGames = atoi(argv[++i]);
+		}
+		else if(strcmp(argv[i], "--replay") == 0)
+		{
+			replayFileName = argv[++i];
+		}
+		else if(strcmp(argv[i], "--record") == 0)
+		{
+			recordFileName = argv[++i];
+		}
+	}
+
+	SDL_putenv(VIDEO_DRIVER_VARIABLE);
+	SDL_putenv(AUDIO_DRIVER_VARIABLE);
+
+	lua_State* luaVM = lua_newstate(CountingAllocator, NULL);
+
+	luaL_openlibs(luaVM);
+
+	RegisterLuaLibraries(luaVM);
+
+	//Trunks loaded through SDLInstance.LoadTrunkAsync are handed over between frames.
+	LoadedTrunkDispatcher trunkDispatcher;
+	SDLInstance::GetInstance().GetFrameHandlers().AddCppEventHandler(&trunkDispatcher,
+		&LoadedTrunkDispatcher::DispatchLoadedTrunks);
+
+	int error = 0;
+
+	SDLInputLog replayLog;
+	BenchmarkPlayer player(numberOfGames, replayFileName != NULL ? &replayLog : NULL);
+
+	std::chrono::steady_clock::duration runTime(0);
+	unsigned long allocationsBeforeRun = 0;
+
+	try
+	{
+		if(replayFileName != NULL)
+		{
+			replayLog.StartReplay(replayFileName);
+			SDLInstance::GetInstance().SetRandomSeed(replayLog.GetSeed());
+		}
+		else
+		{
+			SDLInstance::GetInstance().SetRandomSeed(0);
+		}
+
+		if(recordFileName != NULL)
+		{
+			SDLInstance::GetInstance().StartRecordingInput(recordFileName);
+		}
+
+		SDLInstance::GetInstance().SetInputSource(&player);
+
+		fstream scoreFile;
+		scoreFile.open(BENCHMARK_SCORE_FILE_NAME, fstream::out | fstream::trunc);
+		scoreFile << "local scoreTable = {}\nreturn scoreTable";
+		scoreFile.close();
+
+		error = luaL_dofile(luaVM, "Scripts/Main.lua");
+
+		if(!error)
+		{
+			//The frame rate is left uncapped, and the scores are kept apart.
+			lua_pushinteger(luaVM, 0);
+			lua_setglobal(luaVM, "MAIN_FPS");
+			lua_pushstring(luaVM, BENCHMARK_SCORE_FILE_NAME);
+			lua_setglobal(luaVM, "SCORE_FILE_NAME");
+
+			allocationsBeforeRun = numberOfAllocations;
+			std::chrono::steady_clock::time_point runStart = std::chrono::steady_clock::now();
+
+			lua_getglobal(luaVM, "Main");
+			error = lua_pcall(luaVM, 0, 0, 0);
+
+			runTime = std::chrono::steady_clock::now() - runStart;
+		}
+	}
+	catch(exception& cppException)
+	{
+		luaL_error(luaVM, cppException.what());
+		error = true;
+	}
+
+	unsigned long allocationsDuringRun = numberOfAllocations - allocationsBeforeRun;
+
+	if(error)
+	{
+		cout << "Error: " << lua_tostring(luaVM, -1) << endl;
+
+		lua_pop(luaVM, 1);
+	}
+	else
+	{
+		double seconds = std::chrono::duration<double>(runTime).count();
+		unsigned long numberOfFrames = player.GetNumberOfFrames();
+
+		cout << std::fixed << setprecision(2);
+		cout << "Games:                " << player.GetNumberOfGamesPlayed() << endl;
+		cout << "Frames:               " << numberOfFrames << endl;
+		cout << "Time (s):             " << seconds << endl;
+
+		if(seconds > 0 && numberOfFrames > 0)
+		{
+			cout << "Games per second:     " << player.GetNumberOfGamesPlayed() / seconds << endl;
+			cout << "Frames per second:    " << numberOfFrames / seconds << endl;
+			cout << "Allocations per frame: " << (double)allocationsDuringRun / numberOfFrames << endl;
+		}
+
+		cout << "Peak memory (KB):     " << GetPeakMemoryUsage() << endl;
+	}
+
+	SDLInstance::GetInstance().CleanUp();
+
+	//Trunks which are still loading hold handlers which refer to lua.
+	ResourcePipelineSingleton::GetInstance().UnloadAllTrunks();
+
+	lua_close(luaVM);
+	SDLInstance::GetInstance().CleanUpSDL();
+
+	remove(BENCHMARK_SCORE_FILE_NAME);
+
+	return error ? 1 : 0;
+}
@@ -28,6 +28,7 @@
     #include <stdlib.h>
 #endif
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <exception>
@@ -40,16 +41,7 @@
 #include <EventHandling/KeyEventHandler.h>
 #include <Helpers/ApplicationException.h>
 #include <Helpers/DirectoryTraverser.h>
-#include <LuaInterface/LuaSDLInstance.h>
-#include <LuaInterface/LuaSDLForm.h>
-#include <LuaInterface/LuaSDLText.h>
-#include <LuaInterface/LuaSDLTextBox.h>
-#include <LuaInterface/LuaLoomEffect.h>
-#include <LuaInterface/LuaSDLSurfaceGridComponent.h>
-#include <LuaInterface/LuaSDLSurfaceGrid.h>
-#include <LuaInterface/LuaSDLTimer.h>
-#include <LuaInterface/LuaSDLFontFile.h>
-#include <LuaInterface/LuaSDLComponent.h>
+#include <LuaInterface/LuaLibraries.h>
 
 using namespace std;
 using namespace EventHandling;
@@ -60,22 +52,31 @@ int main(int argc, char** argv)
 
 	luaL_openlibs(luaVM);
 
-	RegisterSDLFontFileLibrary(luaVM);
-	RegisterSDLInstanceLibrary(luaVM);
-	RegisterSDLFormLibrary(luaVM);
-	RegisterSDLTextLibrary(luaVM);
-	RegisterSDLTextBoxLibrary(luaVM);
-	RegisterLoomEffectLibrary(luaVM);
-	RegisterSDLSurfaceGridLibrary(luaVM);
-	RegisterSDLSurfaceGridComponentLibrary(luaVM);
-	RegisterSDLTimerLibrary(luaVM);
-	RegisterSDLComponentLibrary(luaVM);
+	RegisterLuaLibraries(luaVM);
+
+	//Trunks loaded through SDLInstance.LoadTrunkAsync are handed over between frames.
+	LoadedTrunkDispatcher trunkDispatcher;
+	SDLInstance::GetInstance().GetFrameHandlers().AddCppEventHandler(&trunkDispatcher,
+		&LoadedTrunkDispatcher::DispatchLoadedTrunks);
 
     int error = 0;
 
 
 	try
 	{
+		//"--record file" saves the input of the run, which "--replay file" plays back.
+		for(int i = 1; i + 1 < argc; i++)
+		{
+			if(strcmp(argv[i], "--record") == 0)
+			{
+				SDLInstance::GetInstance().StartRecordingInput(argv[++i]);
+			}
+			else if(strcmp(argv[i], "--replay") == 0)
+			{
+				SDLInstance::GetInstance().StartReplayingInput(argv[++i]);
+			}
+		}
+
 		error = luaL_dofile(luaVM, "Scripts/Main.lua");
 
 		if(!error)
@@ -101,11 +102,18 @@ int main(int argc, char** argv)
 		lua_pop(luaVM, 1);
 	}
 
-	SDLInstance::GetInstance().CleanUp();
+	//Frame statistics, when requested, are written next to the error log.
+	if(SDLInstance::GetInstance().FrameStatsAreWrittenOnExit())
+	{
+		SDLInstance::GetInstance().GetFrameStats().WriteCSV("framestats.csv");
+	}
 
-	lua_close(luaVM);
+	SDLInstance::GetInstance().CleanUp();
 
+	//Trunks which are still loading hold handlers which refer to lua.
 	ResourcePipelineSingleton::GetInstance().UnloadAllTrunks();
+
+	lua_close(luaVM);
 	SDLInstance::GetInstance().CleanUpSDL();
 
 
@@ -0,0 +1,605 @@
+#include <SDLInterface/SDLSurfaceGrid.h>
+#include <SDLInterface/SDLException.h>
+#include <Helpers/Grid.h>
+#include <Helpers/ApplicationException.h>
+
+#include <SDL/SDL.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::setw;
+using std::string;
+using std::vector;
+
+using namespace SDLInterfaceLibrary;
+using namespace Helpers;
+
+//The size of the main panel, in cells.
+const int BOARD_WIDTH = 12;
+const int BOARD_HEIGHT = 24;
+//The size of a block, in pixels.
+const int TILE_SIZE = 22;
+
+//The size of the screen which the boards are drawn unto.
+const int SCREEN_WIDTH = 800;
+const int SCREEN_HEIGHT = 600;
+
+//How long each routine is run for, in seconds.
+const double MINIMUM_DURATION = 0.25;
+
+//Written to by every routine, so that the compiler cannot drop the work they do.
+volatile unsigned long checksum = 0;
+
+/*
+	Class: PerCellGrid
+
+	The layout Grid used before it kept its cells in a single buffer: an array of pointers,
+	with every cell allocated on the heap when it is first written. Kept here so that the
+	two can be compared.
+*/
+template <class CellClass>
+class PerCellGrid
+{
+	private:
+		vector<CellClass*> cells;
+		unsigned int width;
+		unsigned int height;
+
+	public:
+		PerCellGrid(unsigned int width, unsigned int height):
+			cells(width * height, (CellClass*)NULL)
+		{
+			this->width = width;
+			this->height = height;
+		}
+
+		PerCellGrid(const PerCellGrid<CellClass>& source):
+			cells(source.cells.size(), (CellClass*)NULL)
+		{
+			this->width = source.width;
+			this->height = source.height;
+
+			for(unsigned int y = 0; y < height; y++)
+			{
+				for(unsigned int x = 0; x < width; x++)
+				{
+					Set(x, y, source.Get(x, y));
+				}
+			}
+		}
+
+		CellClass Get(unsigned int x, unsigned int y) const
+		{
+			if(x >= width || y >= height || cells[y*width + x] == NULL)
+			{
+				throw GridException("Attempted to read from an invalid location.");
+			}
+
+			return *cells[y*width + x];
+		}
+
+		void Set(unsigned int x, unsigned int y, CellClass newObject)
+		{
+			if(x >= width || y >= height)
+			{
+				throw GridException("Attempted to write to an out-of-bounds location.");
+			}
+
+			if(cells[y*width + x] == NULL)
+			{
+				cells[y*width + x] = new CellClass(newObject);
+			}
+			else
+			{
+				*cells[y*width + x] = newObject;
+			}
+		}
+
+		~PerCellGrid()
+		{
+			for(size_t i = 0; i < cells.size(); i++)
+			{
+				delete cells[i];
+			}
+		}
+};
+
+/*
+Function: CreateSurface
+
+Returns:
+	A [width] by [height], 32 bit surface filled with [color].
+*/
+SDL_Surface* CreateSurface(int width, int height, Uint32 color)
+{
+	SDL_Surface* surface = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32,
+		0x00FF0000, 0x0000FF00, 0x000000FF, 0);
+
+	if(surface == NULL)
+	{
+		throw SDLException();
+	}
+
+	if(SDL_FillRect(surface, NULL, color) == -1)
+	{
+		SDL_FreeSurface(surface);
+		throw SDLException();
+	}
+
+	return surface;
+}
+
+/*
+Function: CellWalkCollides
+
+The collision test SDLSurfaceGridComponent::SurfacesCollide made before the surface grids
+kept row masks: every cell of [target] is looked up in [board], and a lookup outside the
+board is caught as a GridException.
+*/
+bool CellWalkCollides(const SDLSurfaceGrid& board, const SDLSurfaceGrid& target,
+	const Vector2D<int>& targetBlockPosition, bool treatOutsideBoundsAsCollision)
+{
+	for(int x = 0; x < target.GetWidth(); x++)
+	{
+		for(int y = 0; y < target.GetHeight(); y++)
+		{
+			SDL_Surface* targetSurface = target.GetSurface(Vector2D<int>(x, y));
+
+			try
+			{
+				SDL_Surface* boardSurface = board.GetSurface(Vector2D<int>(x, y) + targetBlockPosition);
+
+				if(boardSurface != NULL && targetSurface != NULL)
+				{
+					return true;
+				}
+			}
+			catch(GridException&)
+			{
+				if(treatOutsideBoundsAsCollision && targetSurface != NULL)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+/*
+Function: CellWalkFullRowIndexes
+
+The search for complete lines made before the surface grids kept row masks, which looks
+up every cell of a row until it finds an empty one.
+*/
+vector<int> CellWalkFullRowIndexes(const SDLSurfaceGrid& board)
+{
+	vector<int> fullRowIndexes;
+
+	for(int y = 0; y < board.GetHeight(); y++)
+	{
+		bool rowFull = true;
+
+		for(int x = 0; x < board.GetWidth(); x++)
+		{
+			if(board.GetSurface(Vector2D<int>(x, y)) == NULL)
+			{
+				rowFull = false;
+				break;
+			}
+		}
+
+		if(rowFull)
+		{
+			fullRowIndexes.push_back(y);
+		}
+	}
+
+	return fullRowIndexes;
+}
+
+/*
+Function: CreateBoard
+
+Returns:
+	A board the size of the main panel, whose bottom rows are filled with [tile] as they
+	would be late in a game. Every third of them is complete.
+*/
+SDLSurfaceGrid CreateBoard(SDL_Surface* tile)
+{
+	SDLSurfaceGrid board("Board", Bounds2D<int>(BOARD_WIDTH, BOARD_HEIGHT), Bounds2D<int>(TILE_SIZE, TILE_SIZE),
+		Vector2D<int>(0, 0), SDL_SSP_UPPER_LEFT_CORNER);
+
+	for(int y = BOARD_HEIGHT / 2; y < BOARD_HEIGHT; y++)
+	{
+		for(int x = 0; x < BOARD_WIDTH; x++)
+		{
+			if(y % 3 == 0 || x != y % BOARD_WIDTH)
+			{
+				board.Replace(tile, Vector2D<int>(x, y));
+			}
+		}
+	}
+
+	return board;
+}
+
+/*
+Function: CreatePiece
+
+Returns:
+	An L shaped piece made of [tile].
+*/
+SDLSurfaceGrid CreatePiece(SDL_Surface* tile)
+{
+	Grid<unsigned int> placementMap(2, 3);
+
+	placementMap.Set(0, 0, 1);
+	placementMap.Set(0, 1, 1);
+	placementMap.Set(0, 2, 1);
+	placementMap.Set(1, 2, 1);
+
+	return SDLSurfaceGrid("Piece", placementMap, vector<SDL_Surface*>(1, tile), Vector2D<int>(0, 0),
+		SDL_SSP_UPPER_LEFT_CORNER);
+}
+
+/*
+Function: VerifyCollisions
+
+Checks that the row masks find the same collisions and complete lines as the cell walk,
+at every position of [piece] on and around [board].
+*/
+void VerifyCollisions(const SDLSurfaceGrid& board, const SDLSurfaceGrid& piece)
+{
+	for(int y = -piece.GetHeight(); y <= BOARD_HEIGHT; y++)
+	{
+		for(int x = -piece.GetWidth(); x <= BOARD_WIDTH; x++)
+		{
+			for(int outsideCollides = 0; outsideCollides < 2; outsideCollides++)
+			{
+				if(board.Collides(piece, Vector2D<int>(x, y), outsideCollides != 0) !=
+					CellWalkCollides(board, piece, Vector2D<int>(x, y), outsideCollides != 0))
+				{
+					throw ApplicationException("The row masks do not find the same collisions as the cell walk");
+				}
+			}
+		}
+	}
+
+	if(board.GetFullRowIndexes() != CellWalkFullRowIndexes(board))
+	{
+		throw ApplicationException("The row masks do not find the same complete lines as the cell walk");
+	}
+}
+
+/*
+Function: CreateFullBoard
+
+Returns:
+	A board the size of the main panel, every cell of which holds one of [tiles].
+*/
+SDLSurfaceGrid CreateFullBoard(SDL_Surface* tiles[2])
+{
+	SDLSurfaceGrid board("Board", Bounds2D<int>(BOARD_WIDTH, BOARD_HEIGHT), Bounds2D<int>(TILE_SIZE, TILE_SIZE),
+		Vector2D<int>(0, 0), SDL_SSP_UPPER_LEFT_CORNER);
+
+	for(int y = 0; y < BOARD_HEIGHT; y++)
+	{
+		for(int x = 0; x < BOARD_WIDTH; x++)
+		{
+			board.Replace(tiles[(x + y) % 2], Vector2D<int>(x, y));
+		}
+	}
+
+	return board;
+}
+
+/*
+Function: VerifyBlits
+
+Checks that a cached board draws exactly the same pixels as one blitted a cell at a time,
+once full, and again after lines are cleared and collapsed.
+*/
+void VerifyBlits(SDL_Surface* tiles[2], SDL_Surface* expectedScreen, SDL_Surface* actualScreen)
+{
+	SDLSurfaceGrid board = CreateFullBoard(tiles);
+	SDLSurfaceGrid cachedBoard = CreateFullBoard(tiles);
+
+	cachedBoard.SetCached(true);
+
+	for(int step = 0; step < 2; step++)
+	{
+		if(step == 1)
+		{
+			Dimensions2D<int> piece(4, 3, 3, 2);
+			vector<int> clearedRows(1, BOARD_HEIGHT - 1);
+
+			clearedRows.push_back(BOARD_HEIGHT / 2);
+
+			board.ClearSurfaceGrid(&piece);
+			cachedBoard.ClearSurfaceGrid(&piece);
+			board.CollapseRows(clearedRows);
+			cachedBoard.CollapseRows(clearedRows);
+		}
+
+		SDL_FillRect(expectedScreen, NULL, 0);
+		SDL_FillRect(actualScreen, NULL, 0);
+
+		board.Blit(Vector2D<int>(35, 28), expectedScreen);
+		cachedBoard.Blit(Vector2D<int>(35, 28), actualScreen);
+
+		for(int y = 0; y < SCREEN_HEIGHT; y++)
+		{
+			if(memcmp((Uint8*)expectedScreen->pixels + y * expectedScreen->pitch,
+				(Uint8*)actualScreen->pixels + y * actualScreen->pitch, SCREEN_WIDTH * 4) != 0)
+			{
+				throw ApplicationException("The cached board does not draw the same pixels as the uncached one");
+			}
+		}
+	}
+}
+
+/*
+Function: Measure
+
+Returns:
+	The number of nano-seconds [routine] takes to run once, on average.
+*/
+template <class Routine>
+double Measure(Routine routine)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	long long numberOfRuns = 0;
+	double elapsedTime = 0;
+
+	Clock::time_point startTime = Clock::now();
+
+	while(elapsedTime < MINIMUM_DURATION)
+	{
+		routine();
+
+		numberOfRuns++;
+		elapsedTime = std::chrono::duration<double>(Clock::now() - startTime).count();
+	}
+
+	return elapsedTime * 1000000000.0 / numberOfRuns;
+}
+
+/*
+Function: Report
+
+Writes the time [routine] takes to run once under [description].
+*/
+template <class Routine>
+void Report(const string& description, Routine routine)
+{
+	cout << std::left << setw(40) << description << std::right;
+	cout << setw(12) << std::fixed << std::setprecision(1) << Measure(routine) << " ns" << endl;
+}
+
+/*
+Function: ReportGrid
+
+Scans and copies a full board of pointers, as Grid stores them and as PerCellGrid did.
+*/
+void ReportGrid()
+{
+	vector<int> cellValues(BOARD_WIDTH * BOARD_HEIGHT);
+
+	Grid<int*> grid(BOARD_WIDTH, BOARD_HEIGHT);
+	PerCellGrid<int*> perCellGrid(BOARD_WIDTH, BOARD_HEIGHT);
+
+	for(int y = 0; y < BOARD_HEIGHT; y++)
+	{
+		for(int x = 0; x < BOARD_WIDTH; x++)
+		{
+			grid.Set(x, y, &cellValues[y*BOARD_WIDTH + x]);
+			perCellGrid.Set(x, y, &cellValues[y*BOARD_WIDTH + x]);
+		}
+	}
+
+	cout << "Grid, " << BOARD_WIDTH << "x" << BOARD_HEIGHT << " cells:" << endl;
+
+	Report("  scan, per cell Get", [&]()
+	{
+		unsigned long sum = 0;
+
+		for(int y = 0; y < BOARD_HEIGHT; y++)
+		{
+			for(int x = 0; x < BOARD_WIDTH; x++)
+			{
+				sum += (unsigned long)perCellGrid.Get(x, y);
+			}
+		}
+
+		checksum += sum;
+	});
+
+	Report("  scan, Get", [&]()
+	{
+		unsigned long sum = 0;
+
+		for(int y = 0; y < BOARD_HEIGHT; y++)
+		{
+			for(int x = 0; x < BOARD_WIDTH; x++)
+			{
+				sum += (unsigned long)grid.Get(x, y);
+			}
+		}
+
+		checksum += sum;
+	});
+
+	Report("  scan, operator()", [&]()
+	{
+		unsigned long sum = 0;
+
+		for(int y = 0; y < BOARD_HEIGHT; y++)
+		{
+			for(int x = 0; x < BOARD_WIDTH; x++)
+			{
+				sum += (unsigned long)grid(x, y);
+			}
+		}
+
+		checksum += sum;
+	});
+
+	Report("  copy, per cell", [&]()
+	{
+		PerCellGrid<int*> copy(perCellGrid);
+		checksum += (unsigned long)copy.Get(0, 0);
+	});
+
+	Report("  copy, copy constructor", [&]()
+	{
+		Grid<int*> copy(grid);
+		checksum += (unsigned long)copy(0, 0);
+	});
+}
+
+/*
+Function: ReportCollisions
+
+Tests a piece for collisions with a board, and the board for complete lines, with the row
+masks of the surface grids and with the cell walk they replaced.
+*/
+void ReportCollisions(SDL_Surface* tile)
+{
+	SDLSurfaceGrid board = CreateBoard(tile);
+	SDLSurfaceGrid piece = CreatePiece(tile);
+
+	VerifyCollisions(board, piece);
+
+	const char* positionNames[] = {"in open space", "against a wall", "on the floor"};
+	const Vector2D<int> positions[] = {Vector2D<int>(5, 2), Vector2D<int>(-1, 6),
+		Vector2D<int>(5, BOARD_HEIGHT / 2 - 3)};
+
+	cout << "Collisions, " << BOARD_WIDTH << "x" << BOARD_HEIGHT << " board and an L piece:" << endl;
+
+	for(int i = 0; i < 3; i++)
+	{
+		Vector2D<int> position = positions[i];
+
+		Report(string("  collide ") + positionNames[i] + ", cell walk", [&]()
+		{
+			checksum += CellWalkCollides(board, piece, position, true);
+		});
+
+		Report(string("  collide ") + positionNames[i] + ", masks", [&]()
+		{
+			checksum += board.Collides(piece, position, true);
+		});
+	}
+
+	Report("  complete lines, cell walk", [&]()
+	{
+		checksum += CellWalkFullRowIndexes(board).size();
+	});
+
+	Report("  complete lines, masks", [&]()
+	{
+		checksum += board.GetFullRowIndexes().size();
+	});
+}
+
+/*
+Function: ReportBlits
+
+Draws a full board unto a screen sized surface a cell at a time, and through the composite
+surface of cached mode.
+*/
+void ReportBlits(SDL_Surface* tiles[2], SDL_Surface* screen, SDL_Surface* verificationScreen)
+{
+	VerifyBlits(tiles, screen, verificationScreen);
+
+	SDLSurfaceGrid board = CreateFullBoard(tiles);
+	Vector2D<int> position(35, 28);
+
+	cout << "Blits, full " << BOARD_WIDTH << "x" << BOARD_HEIGHT << " board of " << TILE_SIZE << "x";
+	cout << TILE_SIZE << " tiles:" << endl;
+
+	Report("  per cell blits", [&]()
+	{
+		board.Blit(position, screen);
+	});
+
+	board.SetCached(true);
+	board.Blit(position, screen);
+
+	Report("  cached, unchanged", [&]()
+	{
+		board.Blit(position, screen);
+	});
+
+	int numberOfChanges = 0;
+
+	Report("  cached, 4 cells changed", [&]()
+	{
+		numberOfChanges++;
+
+		for(int x = 4; x < 8; x++)
+		{
+			board.Replace(tiles[(x + numberOfChanges) % 2], Vector2D<int>(x, BOARD_HEIGHT - 1));
+		}
+
+		board.Blit(position, screen);
+	});
+
+	Report("  cached, full rebuild", [&]()
+	{
+		board.SetCached(true);
+		board.Blit(position, screen);
+	});
+}
+
+/*
+Measures the board operations which were reworked for speed against the way they used to be
+done, on a board the size of the main panel.
+*/
+int main()
+{
+	SDL_Surface* tiles[2] = {NULL, NULL};
+	SDL_Surface* screen = NULL;
+	SDL_Surface* verificationScreen = NULL;
+	int error = 0;
+
+	try
+	{
+		tiles[0] = CreateSurface(TILE_SIZE, TILE_SIZE, 0x00C08040);
+		tiles[1] = CreateSurface(TILE_SIZE, TILE_SIZE, 0x004080C0);
+		screen = CreateSurface(SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+		verificationScreen = CreateSurface(SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+
+		ReportGrid();
+		ReportCollisions(tiles[0]);
+		ReportBlits(tiles, screen, verificationScreen);
+	}
+	catch(exception& benchmarkException)
+	{
+		cout << benchmarkException.what() << endl;
+		error = 1;
+	}
+
+	SDL_Surface* surfaces[] = {tiles[0], tiles[1], screen, verificationScreen};
+
+	for(int i = 0; i < 4; i++)
+	{
+		if(surfaces[i] != NULL)
+		{
+			SDL_FreeSurface(surfaces[i]);
+		}
+	}
+
+	return error;
+}
@@ -31,12 +31,20 @@ using std::string;
 using  namespace Helpers;
 
 
+std::atomic<unsigned int> ApplicationException::numberCreated(0);
+
 ApplicationException::ApplicationException(const char* errorMessage)
 {
     this->errorMessage = errorMessage;
+    numberCreated++;
 }
 
 const char* ApplicationException::what() const throw()
 {
     return errorMessage.c_str();
 }
+
+unsigned int ApplicationException::GetNumberCreated()
+{
+    return numberCreated;
+}
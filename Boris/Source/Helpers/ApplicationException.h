@@ -25,6 +25,7 @@
 #ifndef APPLICATION_EXCEPTION_H
 #define APPLICATION_EXCEPTION_H
 
+#include <atomic>
 #include <exception>
 #include <string>
 
@@ -47,6 +48,10 @@ namespace Helpers
 	{
 		private:
 			string errorMessage;
+
+			//The number of application exceptions constructed since start up. Exceptions are
+			//also constructed by the threads which load trunks, hence the atomic.
+			static std::atomic<unsigned int> numberCreated;
 		public:
 			/*
 			Constructor: ApplicationException
@@ -65,6 +70,15 @@ namespace Helpers
 				The error message previously entered when intializing this class.
 			*/
             const char* what() const throw();
+			/*
+			Function: GetNumberCreated
+
+			Returns:
+				The number of application exceptions (Including those of derived classes)
+				which have been constructed since the application started, on any thread.
+				Comparing two readings tells how many were thrown in between.
+			*/
+			static unsigned int GetNumberCreated();
 
             ~ApplicationException() throw() {};
 	};
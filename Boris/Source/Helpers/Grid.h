@@ -26,8 +26,11 @@
 #define GRID_H
 
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include <Helpers/ApplicationException.h>
+#include <Helpers/GeometricStructures2D.h>
 
 using namespace std;
 
@@ -51,7 +54,9 @@ namespace Helpers
 	/*
 		Class: Grid
 
-		Abstracts and manages a two-dimensional array of objects.
+		Abstracts and manages a two-dimensional array of objects. The objects are
+		stored by value, in a single row-major buffer, so that cell (x, y) lies at
+		offset y*width + x and neighbouring cells in a row are neighbours in memory.
 		
 		Template: CellClass
 		
@@ -61,11 +66,25 @@ namespace Helpers
 	class Grid
 	{
 		private:
-			CellClass** grid;
+			vector<CellClass> cells;
 			unsigned int width;
 			unsigned int height;
 
-			unsigned int totalSize;
+			//Throws a GridException if ([x], [y]) lies outside the grid. [operation] is
+			//used to describe the failed access in the error message.
+			void ConfirmBounds(unsigned int x, unsigned int y, const char* operation) const
+			{
+				if(x >= width || y >= height)
+				{
+					stringstream error;
+
+					error << "Attempted to " << operation << " out-of-bounds location : ";
+					error  << "(" << x << ", " << y << "). When legal bounds within ";
+					error  << "(" << width << ", " << height << ").";
+
+					throw GridException(error.str().c_str());
+				}
+			}
 
 		public:
 			/*
@@ -75,42 +94,73 @@ namespace Helpers
 					width - The horizontal number of cells in the grid.
 					
 					height - The vertical number of cells in the grid.
+
+					initialValue - The value every cell will hold once the grid is created.
+								   Default: A value initialized CellClass (NULL for pointers, 0 for
+								   numbers).
 			*/
-			Grid(unsigned int width, unsigned int height)
+			Grid(unsigned int width, unsigned int height, const CellClass& initialValue = CellClass()):
+				cells(width * height, initialValue)
 			{
 				this->width = width;
 				this->height = height;
+			}
+			
+			/*
+				Constructor: Grid
 
-				this->totalSize = width * height;
+				Copies every cell of [source] into a new buffer.
+			*/
+			Grid(const Grid<CellClass>& source):
+				cells(source.cells)
+			{
+				this->width = source.width;
+				this->height = source.height;
+			}
 
-				this->grid = new CellClass*[totalSize];
+			/*
+				Constructor: Grid
 
-				for(unsigned int i = 0; i < totalSize; i++)
+				Takes over the buffer of [source], which is left as an empty 0x0 grid.
+			*/
+			Grid(Grid<CellClass>&& source):
+				cells(std::move(source.cells))
+			{
+				this->width = source.width;
+				this->height = source.height;
+
+				source.width = 0;
+				source.height = 0;
+			}
+
+			Grid<CellClass>& operator=(const Grid<CellClass>& source)
+			{
+				if(this != &source)
 				{
-					this->grid[i] = NULL;
+					cells = source.cells;
+
+					width = source.width;
+					height = source.height;
 				}
+
+				return *this;
 			}
-			
-			Grid(const Grid<CellClass>& source)
+
+			Grid<CellClass>& operator=(Grid<CellClass>&& source)
 			{
-				this->width = source.GetWidth();
-				this->height = source.GetHeight();
+				if(this != &source)
+				{
+					cells = std::move(source.cells);
 
-				this->totalSize = this->width * this->height;
+					width = source.width;
+					height = source.height;
 
-				for(int i = 0; i < totalSize; i++)
-				{
-					if(source.grid[i] == NULL)
-					{
-						this->grid[i] = source.grid[i];
-					}
-					else
-					{
-						*(this->grid[i]) = *source.grid[i];
-					}
+					source.width = 0;
+					source.height = 0;
 				}
-			}
 
+				return *this;
+			}
 			
 			/*
 				Function: Get
@@ -126,29 +176,9 @@ namespace Helpers
 			*/
 			CellClass Get(unsigned int x, unsigned int y) const
 			{
-				if(x >= width || y >= height)
-				{
-					stringstream error;
-
-					error << "Attempted to read from out-of-bounds location : ";
-					error  << "(" << x << ", " << y << "). When legal bounds within ";
-					error  << "(" << width << ", " << height << ").";
+				ConfirmBounds(x, y, "read from");
 
-					throw GridException(error.str().c_str());
-				}
-
-				CellClass* result = grid[y*width + x];
-
-				if(result == NULL)
-				{
-					stringstream error;
-
-					error << "Attempted to load object from null location.";
-
-					throw GridException(error.str().c_str());
-				}
-
-				return *grid[y*width + x];
+				return cells[y*width + x];
 			}
 
 			/*
@@ -166,29 +196,104 @@ namespace Helpers
 				
 				
 			*/
-			void Set(unsigned int x, unsigned int y, CellClass newObject)
+			void Set(unsigned int x, unsigned int y, const CellClass& newObject)
 			{
-				if(x >= width || y >= height)
-				{
-					stringstream error;
+				ConfirmBounds(x, y, "write to");
 
-					error << "Attempted to write to out-of-bounds location : ";
-					error  << "(" << x << ", " << y << "). When legal bounds within ";
-					error  << "(" << width << ", " << height << ").";
+				cells[y*width + x] = newObject;
+			}
+			/*
+				Function: Contains
 
-					throw GridException(error.str().c_str());
+				Returns:
+					True if ([x], [y]) lies within the grid.
+			*/
+			bool Contains(int x, int y) const
+			{
+				return x >= 0 && y >= 0 && (unsigned int)x < width && (unsigned int)y < height;
+			}
+			/*
+				Function: TryGet
+
+				Non-throwing alternative to <Grid::Get>, for callers which expect to read
+				outside the grid as part of their normal operation.
+
+				Parameters:
+
+					x - The horizontal position of the object you wish to retrieve.
+
+					y - The vertical position of the object you wish to retrieve.
+
+					result - Receives the object at ([x], [y]). Left untouched if that
+							 location is outside the grid.
+
+				Returns:
+					True if ([x], [y]) lies within the grid, false otherwise.
+			*/
+			bool TryGet(int x, int y, CellClass& result) const
+			{
+				if(!Contains(x, y))
+				{
+					return false;
 				}
 
-				CellClass* currentValue = grid[y*width + x];
+				result = cells[y*width + x];
+				return true;
+			}
+			/*
+				Function: Clip
+
+				Parameters:
+					range - A rectangle of cells, which may lie partly or entirely outside the grid.
+
+				Returns:
+					The portion of [range] which lies within the grid. If the two do not overlap,
+					the returned rectangle has a width and height of 0.
+			*/
+			Dimensions2D<int> Clip(const Dimensions2D<int>& range) const
+			{
+				int firstX = (range.position.x > 0)? range.position.x: 0;
+				int firstY = (range.position.y > 0)? range.position.y: 0;
+
+				int endX = range.position.x + range.size.width;
+				int endY = range.position.y + range.size.height;
+
+				if(endX > (int)width)
+				{
+					endX = width;
+				}
 
-				if(currentValue == NULL)
+				if(endY > (int)height)
 				{
-					grid[y*width + x] = new CellClass(newObject);
+					endY = height;
 				}
-				else
+
+				if(endX <= firstX || endY <= firstY)
 				{
-					*grid[y*width + x] = newObject;
+					return Dimensions2D<int>(firstX, firstY, 0, 0);
 				}
+
+				return Dimensions2D<int>(firstX, firstY, endX - firstX, endY - firstY);
+			}
+			/*
+				Operator: ()
+
+				Unchecked access to the object at ([x], [y]). Unlike <Grid::Get> and <Grid::Set>
+				no bounds check is performed, so the caller must guarantee that
+				x < <GetWidth> and y < <GetHeight>. Meant for loops which already iterate
+				within the bounds of the grid.
+
+				Returns:
+					A reference to the object at ([x], [y]).
+			*/
+			CellClass& operator()(unsigned int x, unsigned int y)
+			{
+				return cells[y*width + x];
+			}
+
+			const CellClass& operator()(unsigned int x, unsigned int y) const
+			{
+				return cells[y*width + x];
 			}
 			/*
 				Function: GetWidth
@@ -210,19 +315,6 @@ namespace Helpers
 			{
 				return height;
 			}
-
-			~Grid()
-			{
-				for(unsigned int i = 0; i < totalSize; i++)
-				{
-					if(grid[i] != NULL)
-					{
-						delete grid[i];
-					}
-				}
-
-				delete [] grid;
-			}
 	};
 }
 
@@ -0,0 +1,171 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <Helpers/MappedFile.h>
+
+#ifndef _WIN32
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace Helpers;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string& filePath)
+{
+	data = NULL;
+	size = 0;
+	mappingHandle = NULL;
+
+	fileHandle = CreateFile(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+							FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if(fileHandle == INVALID_HANDLE_VALUE)
+	{
+		string error = "File " + filePath + " could not be opened";
+		throw FileSystemException(error.c_str());
+	}
+
+	LARGE_INTEGER fileSize;
+
+	if(!GetFileSizeEx(fileHandle, &fileSize))
+	{
+		CloseHandle(fileHandle);
+
+		string error = "The size of file " + filePath + " could not be read";
+		throw FileSystemException(error.c_str());
+	}
+
+	size = (size_t)fileSize.QuadPart;
+
+	//Empty files cannot be mapped.
+	if(size == 0)
+	{
+		return;
+	}
+
+	mappingHandle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if(mappingHandle != NULL)
+	{
+		data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	if(data == NULL)
+	{
+		if(mappingHandle != NULL)
+		{
+			CloseHandle(mappingHandle);
+		}
+
+		CloseHandle(fileHandle);
+
+		string error = "File " + filePath + " could not be mapped";
+		throw FileSystemException(error.c_str());
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if(data != NULL)
+	{
+		UnmapViewOfFile(data);
+	}
+
+	if(mappingHandle != NULL)
+	{
+		CloseHandle(mappingHandle);
+	}
+
+	CloseHandle(fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const string& filePath)
+{
+	data = NULL;
+	size = 0;
+
+	int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+	if(fileDescriptor == -1)
+	{
+		string error = "File " + filePath + " could not be opened: " + strerror(errno);
+		throw FileSystemException(error.c_str());
+	}
+
+	struct stat fileStatus;
+
+	if(fstat(fileDescriptor, &fileStatus) == -1)
+	{
+		close(fileDescriptor);
+
+		string error = "The size of file " + filePath + " could not be read: " + strerror(errno);
+		throw FileSystemException(error.c_str());
+	}
+
+	size = (size_t)fileStatus.st_size;
+
+	//Empty files cannot be mapped.
+	if(size > 0)
+	{
+		void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+		if(mapping == MAP_FAILED)
+		{
+			close(fileDescriptor);
+
+			string error = "File " + filePath + " could not be mapped: " + strerror(errno);
+			throw FileSystemException(error.c_str());
+		}
+
+		data = (const char*)mapping;
+	}
+
+	//The mapping holds its own reference to the file.
+	close(fileDescriptor);
+}
+
+MappedFile::~MappedFile()
+{
+	if(data != NULL)
+	{
+		munmap((void*)data, size);
+	}
+}
+
+#endif
+
+const char* MappedFile::GetData() const
+{
+	return data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size;
+}
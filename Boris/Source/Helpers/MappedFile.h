@@ -0,0 +1,98 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+
+#include <Helpers/DirectoryTraverser.h>
+#include <Helpers/IUncopyable.h>
+
+using std::string;
+
+/*
+File: MappedFile.h
+
+Contains the class MappedFile, which is a wrapper to OS specific memory mapping functions.
+*/
+namespace Helpers
+{
+	/*
+	Class: MappedFile
+
+	Maps a whole file into memory, read only, for as long as the object exists. Pages of the
+	file are only read from the disk when they are first touched, and are shared with the OS
+	file cache rather than copied into the heap.
+	*/
+	class MappedFile: public IUncopyable
+	{
+		private:
+			//The first byte of the mapping, or NULL if the file is empty.
+			const char* data;
+			//The size of the file, in bytes.
+			size_t size;
+
+			#ifdef _WIN32
+				HANDLE fileHandle;
+				HANDLE mappingHandle;
+			#endif
+
+		public:
+			/*
+				Constructor: MappedFile
+
+				Parameters:
+					filePath - The location of the file which will be mapped. This can be a
+							   static path, or one relative to the compiled exe.
+
+				Throws:
+					FileSystemException - If the file could not be opened or mapped.
+			*/
+			MappedFile(const string& filePath);
+			/*
+				Function: GetData
+
+				Returns:
+					The contents of the file, which stay valid until the object is destroyed.
+					NULL if the file is empty.
+			*/
+			const char* GetData() const;
+			/*
+				Function: GetSize
+
+				Returns:
+					The size of the file, in bytes.
+			*/
+			size_t GetSize() const;
+			/*
+				Destructor: ~MappedFile
+
+				Unmaps the file.
+			*/
+			~MappedFile();
+	};
+}
+
+#endif
@@ -0,0 +1,358 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <Helpers/PixelKernels.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+	#define PIXEL_KERNELS_X86
+
+	#include <emmintrin.h>
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+
+		//Visual C++ allows any intrinsic in any function.
+		#define PIXEL_KERNELS_TARGET(instructionSet)
+	#else
+		#include <cpuid.h>
+
+		//Lets the SSE2 and AVX2 routines be compiled without building the whole program for
+		//those instruction sets; they are only called once CPUID says they are supported.
+		#define PIXEL_KERNELS_TARGET(instructionSet) __attribute__((target(instructionSet)))
+	#endif
+#endif
+
+using namespace Helpers;
+
+//Returns (first * (255 - alpha) + second * alpha) / 255 for a single channel, rounded to
+//the nearest value. The vector routines compute exactly the same thing in 16 bit lanes.
+static inline Uint32 BlendChannel(Uint32 first, Uint32 second, Uint32 alpha)
+{
+	Uint32 sum = first * (255 - alpha) + second * alpha + 128;
+	return (sum + (sum >> 8)) >> 8;
+}
+
+static inline Uint32 BlendPixel(Uint32 first, Uint32 second, Uint32 alpha)
+{
+	return BlendChannel(first & 0xFF, second & 0xFF, alpha) |
+		(BlendChannel((first >> 8) & 0xFF, (second >> 8) & 0xFF, alpha) << 8) |
+		(BlendChannel((first >> 16) & 0xFF, (second >> 16) & 0xFF, alpha) << 16) |
+		(BlendChannel(first >> 24, second >> 24, alpha) << 24);
+}
+
+static void BlendColorScalar(Uint32* destination, const Uint32* source, int numberOfPixels,
+	Uint32 color, Uint8 alpha)
+{
+	for(int i = 0; i < numberOfPixels; i++)
+	{
+		destination[i] = BlendPixel(source[i], color, alpha);
+	}
+}
+
+static void CrossFadeScalar(Uint32* destination, const Uint32* first, const Uint32* second,
+	int numberOfPixels, Uint8 alpha)
+{
+	for(int i = 0; i < numberOfPixels; i++)
+	{
+		destination[i] = BlendPixel(first[i], second[i], alpha);
+	}
+}
+
+static void FillScalar(Uint32* destination, int numberOfPixels, Uint32 color)
+{
+	for(int i = 0; i < numberOfPixels; i++)
+	{
+		destination[i] = color;
+	}
+}
+
+static const PixelKernels SCALAR_KERNELS = {"C++", BlendColorScalar, CrossFadeScalar, FillScalar};
+
+#ifdef PIXEL_KERNELS_X86
+
+//Finishes a blend of 16 bit lanes holding first * (255 - alpha) + second * alpha + 128, and
+//packs the results back into bytes.
+PIXEL_KERNELS_TARGET("sse2")
+static inline __m128i PackBlendSSE2(__m128i low, __m128i high)
+{
+	low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+	high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+	return _mm_packus_epi16(low, high);
+}
+
+PIXEL_KERNELS_TARGET("sse2")
+static void BlendColorSSE2(Uint32* destination, const Uint32* source, int numberOfPixels,
+	Uint32 color, Uint8 alpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i inverseAlpha = _mm_set1_epi16((short)(255 - alpha));
+
+	//color * alpha + 128, for every channel of two pixels.
+	const __m128i colorTerm = _mm_add_epi16(
+		_mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero), _mm_set1_epi16(alpha)),
+		_mm_set1_epi16(128));
+
+	int i = 0;
+
+	for(; i + 4 <= numberOfPixels; i += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(source + i));
+
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverseAlpha), colorTerm);
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverseAlpha), colorTerm);
+
+		_mm_storeu_si128((__m128i*)(destination + i), PackBlendSSE2(low, high));
+	}
+
+	BlendColorScalar(destination + i, source + i, numberOfPixels - i, color, alpha);
+}
+
+PIXEL_KERNELS_TARGET("sse2")
+static void CrossFadeSSE2(Uint32* destination, const Uint32* first, const Uint32* second,
+	int numberOfPixels, Uint8 alpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i inverseAlpha = _mm_set1_epi16((short)(255 - alpha));
+	const __m128i alphas = _mm_set1_epi16(alpha);
+	const __m128i half = _mm_set1_epi16(128);
+
+	int i = 0;
+
+	for(; i + 4 <= numberOfPixels; i += 4)
+	{
+		__m128i firstPixels = _mm_loadu_si128((const __m128i*)(first + i));
+		__m128i secondPixels = _mm_loadu_si128((const __m128i*)(second + i));
+
+		__m128i low = _mm_add_epi16(
+			_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(firstPixels, zero), inverseAlpha),
+				_mm_mullo_epi16(_mm_unpacklo_epi8(secondPixels, zero), alphas)), half);
+		__m128i high = _mm_add_epi16(
+			_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(firstPixels, zero), inverseAlpha),
+				_mm_mullo_epi16(_mm_unpackhi_epi8(secondPixels, zero), alphas)), half);
+
+		_mm_storeu_si128((__m128i*)(destination + i), PackBlendSSE2(low, high));
+	}
+
+	CrossFadeScalar(destination + i, first + i, second + i, numberOfPixels - i, alpha);
+}
+
+PIXEL_KERNELS_TARGET("sse2")
+static void FillSSE2(Uint32* destination, int numberOfPixels, Uint32 color)
+{
+	const __m128i colors = _mm_set1_epi32((int)color);
+
+	int i = 0;
+
+	for(; i + 4 <= numberOfPixels; i += 4)
+	{
+		_mm_storeu_si128((__m128i*)(destination + i), colors);
+	}
+
+	FillScalar(destination + i, numberOfPixels - i, color);
+}
+
+//The AVX2 routines work on two 128 bit halves independently; unpacking and packing both
+//stay within a half, so the pixels come out in the order they went in.
+PIXEL_KERNELS_TARGET("avx2")
+static inline __m256i PackBlendAVX2(__m256i low, __m256i high)
+{
+	low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+	high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+
+	return _mm256_packus_epi16(low, high);
+}
+
+PIXEL_KERNELS_TARGET("avx2")
+static void BlendColorAVX2(Uint32* destination, const Uint32* source, int numberOfPixels,
+	Uint32 color, Uint8 alpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i inverseAlpha = _mm256_set1_epi16((short)(255 - alpha));
+
+	const __m256i colorTerm = _mm256_add_epi16(
+		_mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), zero), _mm256_set1_epi16(alpha)),
+		_mm256_set1_epi16(128));
+
+	int i = 0;
+
+	for(; i + 8 <= numberOfPixels; i += 8)
+	{
+		__m256i pixels = _mm256_loadu_si256((const __m256i*)(source + i));
+
+		__m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), inverseAlpha), colorTerm);
+		__m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), inverseAlpha), colorTerm);
+
+		_mm256_storeu_si256((__m256i*)(destination + i), PackBlendAVX2(low, high));
+	}
+
+	BlendColorSSE2(destination + i, source + i, numberOfPixels - i, color, alpha);
+}
+
+PIXEL_KERNELS_TARGET("avx2")
+static void CrossFadeAVX2(Uint32* destination, const Uint32* first, const Uint32* second,
+	int numberOfPixels, Uint8 alpha)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i inverseAlpha = _mm256_set1_epi16((short)(255 - alpha));
+	const __m256i alphas = _mm256_set1_epi16(alpha);
+	const __m256i half = _mm256_set1_epi16(128);
+
+	int i = 0;
+
+	for(; i + 8 <= numberOfPixels; i += 8)
+	{
+		__m256i firstPixels = _mm256_loadu_si256((const __m256i*)(first + i));
+		__m256i secondPixels = _mm256_loadu_si256((const __m256i*)(second + i));
+
+		__m256i low = _mm256_add_epi16(
+			_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(firstPixels, zero), inverseAlpha),
+				_mm256_mullo_epi16(_mm256_unpacklo_epi8(secondPixels, zero), alphas)), half);
+		__m256i high = _mm256_add_epi16(
+			_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(firstPixels, zero), inverseAlpha),
+				_mm256_mullo_epi16(_mm256_unpackhi_epi8(secondPixels, zero), alphas)), half);
+
+		_mm256_storeu_si256((__m256i*)(destination + i), PackBlendAVX2(low, high));
+	}
+
+	CrossFadeSSE2(destination + i, first + i, second + i, numberOfPixels - i, alpha);
+}
+
+PIXEL_KERNELS_TARGET("avx2")
+static void FillAVX2(Uint32* destination, int numberOfPixels, Uint32 color)
+{
+	const __m256i colors = _mm256_set1_epi32((int)color);
+
+	int i = 0;
+
+	for(; i + 8 <= numberOfPixels; i += 8)
+	{
+		_mm256_storeu_si256((__m256i*)(destination + i), colors);
+	}
+
+	FillSSE2(destination + i, numberOfPixels - i, color);
+}
+
+static const PixelKernels SSE2_KERNELS = {"SSE2", BlendColorSSE2, CrossFadeSSE2, FillSSE2};
+static const PixelKernels AVX2_KERNELS = {"AVX2", BlendColorAVX2, CrossFadeAVX2, FillAVX2};
+
+//Fills [registers] with eax, ebx, ecx and edx, as returned by CPUID for [leaf] and [subleaf].
+static void ReadCPUID(unsigned int leaf, unsigned int subleaf, unsigned int registers[4])
+{
+#ifdef _MSC_VER
+	int values[4];
+	__cpuidex(values, (int)leaf, (int)subleaf);
+
+	for(int i = 0; i < 4; i++)
+	{
+		registers[i] = (unsigned int)values[i];
+	}
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+//Returns the lower half of the XCR0 register, which tells which registers the operating
+//system saves on a context switch.
+static unsigned int ReadXCR0()
+{
+#ifdef _MSC_VER
+	return (unsigned int)_xgetbv(0);
+#else
+	unsigned int low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+
+	return low;
+#endif
+}
+
+static bool SupportsSSE2()
+{
+	unsigned int registers[4];
+	ReadCPUID(0, 0, registers);
+
+	if(registers[0] < 1)
+	{
+		return false;
+	}
+
+	ReadCPUID(1, 0, registers);
+
+	return (registers[3] & (1 << 26)) != 0;
+}
+
+static bool SupportsAVX2()
+{
+	unsigned int registers[4];
+	ReadCPUID(0, 0, registers);
+
+	if(registers[0] < 7)
+	{
+		return false;
+	}
+
+	ReadCPUID(1, 0, registers);
+
+	//AVX needs both the processor (Bit 28) and the operating system (OSXSAVE, bit 27,
+	//and the XMM and YMM state in XCR0) to support it.
+	bool avxEnabled = (registers[2] & (1 << 27)) != 0 && (registers[2] & (1 << 28)) != 0 &&
+		(ReadXCR0() & 0x6) == 0x6;
+
+	if(!avxEnabled)
+	{
+		return false;
+	}
+
+	ReadCPUID(7, 0, registers);
+
+	return (registers[1] & (1 << 5)) != 0;
+}
+
+#endif
+
+vector<const PixelKernels*> Helpers::GetSupportedPixelKernels()
+{
+	vector<const PixelKernels*> supportedKernels(1, &SCALAR_KERNELS);
+
+#ifdef PIXEL_KERNELS_X86
+	if(SupportsSSE2())
+	{
+		supportedKernels.push_back(&SSE2_KERNELS);
+
+		if(SupportsAVX2())
+		{
+			supportedKernels.push_back(&AVX2_KERNELS);
+		}
+	}
+#endif
+
+	return supportedKernels;
+}
+
+const PixelKernels& Helpers::GetPixelKernels()
+{
+	static const PixelKernels& selectedKernels = *GetSupportedPixelKernels().back();
+	return selectedKernels;
+}
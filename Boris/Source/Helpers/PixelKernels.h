@@ -0,0 +1,104 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <vector>
+
+#include <SDL/SDL_stdinc.h>
+
+using std::vector;
+
+/*
+File: PixelKernels.h
+
+Contains the routines used to blend and fill rows of 32 bit pixels, and the selection of
+the fastest set of them which the processor supports.
+*/
+namespace Helpers
+{
+	/*
+		Struct: PixelKernels
+
+		A set of routines which work on rows of 32 bit pixels, such as ARGB or XRGB pixels.
+		Every channel, alpha included, is treated alike, so the colours passed should be
+		mapped to the format of the pixels being written.
+
+		Blending rounds to the nearest value, so that every set produces exactly the same
+		pixels. A blend at an alpha of 0 leaves the pixels as they are, while one at 255
+		replaces them.
+
+		See Also:
+			<GetPixelKernels>
+	*/
+	struct PixelKernels
+	{
+		//The name of the instruction set which the routines are written for.
+		const char* name;
+
+		/*
+			Function: BlendColor
+
+			Sets each of the [numberOfPixels] pixels in [destination] to the one in [source],
+			with [color] blended over it at [alpha]. [source] may be [destination].
+		*/
+		void (*BlendColor)(Uint32* destination, const Uint32* source, int numberOfPixels,
+			Uint32 color, Uint8 alpha);
+		/*
+			Function: CrossFade
+
+			Sets each of the [numberOfPixels] pixels in [destination] to the one in [first],
+			with the one in [second] blended over it at [alpha]. Either source may be
+			[destination].
+		*/
+		void (*CrossFade)(Uint32* destination, const Uint32* first, const Uint32* second,
+			int numberOfPixels, Uint8 alpha);
+		/*
+			Function: Fill
+
+			Sets each of the [numberOfPixels] pixels in [destination] to [color].
+		*/
+		void (*Fill)(Uint32* destination, int numberOfPixels, Uint32 color);
+	};
+	/*
+		Function: GetPixelKernels
+
+		Returns:
+			The fastest set of pixel kernels which the processor supports: AVX2, SSE2, or
+			plain C++ if neither is available. The processor is queried through CPUID the
+			first time this is called.
+	*/
+	extern const PixelKernels& GetPixelKernels();
+	/*
+		Function: GetSupportedPixelKernels
+
+		Returns:
+			Every set of pixel kernels which the processor supports, slowest first. The
+			plain C++ set is always the first.
+	*/
+	extern vector<const PixelKernels*> GetSupportedPixelKernels();
+}
+
+#endif
@@ -22,7 +22,10 @@
 	   source distribution.
 */
 
+#include <algorithm>
+
 #include <Helpers/SDLHelperFunctions.h>
+#include <Helpers/PixelKernels.h>
 
 SDL_Surface* Helpers::CreateSurface(const Bounds2D<int>& size, int colorDepth)
 {
@@ -59,6 +62,12 @@ SDL_Surface* Helpers::CreateSurface(const Bounds2D<int>& size, int colorDepth, U
 	return newSurface;
 }
 
+SDL_Surface* Helpers::CreateSurface(const Bounds2D<int>& size, const SDL_PixelFormat* format)
+{
+	return SDL_CreateRGBSurface(SDL_SWSURFACE, size.width, size.height, format->BitsPerPixel,
+		format->Rmask, format->Gmask, format->Bmask, 0);
+}
+
 SDL_Surface* Helpers::CopySurface(SDL_Surface* srcSurface)
 {
 	SDL_Surface* newSurface = SDL_ConvertSurface(srcSurface, srcSurface->format, srcSurface->flags);
@@ -111,3 +120,113 @@ SDL_Surface* Helpers::CreateOverlaidCopy(SDL_Surface* srcSurface, int red, int g
 
 	return newSurface;
 }
+
+bool Helpers::BlendColor(SDL_Surface* srcSurface, const SDL_Rect& portion, SDL_Surface* destSurface,
+					const SDL_Rect& position, Uint32 color, Uint8 alpha)
+{
+	const SDL_PixelFormat* srcFormat = srcSurface->format;
+	const SDL_PixelFormat* destFormat = destSurface->format;
+
+	if(srcFormat->BytesPerPixel != 4 || destFormat->BytesPerPixel != 4 ||
+		srcFormat->Rmask != destFormat->Rmask || srcFormat->Gmask != destFormat->Gmask ||
+		srcFormat->Bmask != destFormat->Bmask)
+	{
+		return false;
+	}
+
+	int srcX = portion.x;
+	int srcY = portion.y;
+	int destX = position.x;
+	int destY = position.y;
+	int width = portion.w;
+	int height = portion.h;
+
+	//Clip to the source surface.
+	if(srcX < 0)
+	{
+		destX -= srcX;
+		width += srcX;
+		srcX = 0;
+	}
+
+	if(srcY < 0)
+	{
+		destY -= srcY;
+		height += srcY;
+		srcY = 0;
+	}
+
+	width = std::min(width, srcSurface->w - srcX);
+	height = std::min(height, srcSurface->h - srcY);
+
+	//Clip to the destination's clipping rectangle.
+	const SDL_Rect& clip = destSurface->clip_rect;
+
+	if(destX < clip.x)
+	{
+		srcX += clip.x - destX;
+		width -= clip.x - destX;
+		destX = clip.x;
+	}
+
+	if(destY < clip.y)
+	{
+		srcY += clip.y - destY;
+		height -= clip.y - destY;
+		destY = clip.y;
+	}
+
+	width = std::min(width, clip.x + clip.w - destX);
+	height = std::min(height, clip.y + clip.h - destY);
+
+	if(width <= 0 || height <= 0)
+	{
+		return true;
+	}
+
+	if(SDL_MUSTLOCK(srcSurface) && SDL_LockSurface(srcSurface) == -1)
+	{
+		return false;
+	}
+
+	if(SDL_MUSTLOCK(destSurface) && SDL_LockSurface(destSurface) == -1)
+	{
+		if(SDL_MUSTLOCK(srcSurface))
+		{
+			SDL_UnlockSurface(srcSurface);
+		}
+
+		return false;
+	}
+
+	const PixelKernels& kernels = GetPixelKernels();
+
+	for(int row = 0; row < height; row++)
+	{
+		const Uint32* srcPixels = (const Uint32*)((const Uint8*)srcSurface->pixels +
+			(srcY + row) * srcSurface->pitch) + srcX;
+		Uint32* destPixels = (Uint32*)((Uint8*)destSurface->pixels +
+			(destY + row) * destSurface->pitch) + destX;
+
+		if(alpha == SDL_ALPHA_OPAQUE)
+		{
+			kernels.Fill(destPixels, width, color);
+		}
+		else
+		{
+			kernels.BlendColor(destPixels, srcPixels, width, color, alpha);
+		}
+	}
+
+	if(SDL_MUSTLOCK(destSurface))
+	{
+		SDL_UnlockSurface(destSurface);
+	}
+
+	if(SDL_MUSTLOCK(srcSurface))
+	{
+		SDL_UnlockSurface(srcSurface);
+	}
+
+	return true;
+}
@@ -66,6 +66,18 @@ namespace Helpers
 	*/
 	extern SDL_Surface* CreateSurface(const Bounds2D<int>& size, int colorDepth, Uint8 red,
 							Uint8 green, Uint8 blue, Uint8 alpha);
+	/*
+		Function: CreateSurface
+
+		Parameters:
+			size - The size of the new surface.
+			format - The pixel format of the new surface. Any alpha channel is left out.
+
+		Returns:
+			An empty SDL_Surface with size [size], which can be blitted to, and from, surfaces
+			in [format] without any conversion.
+	*/
+	extern SDL_Surface* CreateSurface(const Bounds2D<int>& size, const SDL_PixelFormat* format);
 	/*
 		Function: CopySurface
 
@@ -102,5 +114,30 @@ namespace Helpers
 			A copy of srcSurface blended with the color {red, green, blue, alpha}
 	*/
 	extern SDL_Surface* CreateOverlaidCopy(SDL_Surface* srcSurface, int red, int green, int blue, int alpha);
+	/*
+		Function: BlendColor
+
+		Copies a portion of a 32 bit surface onto another surface with the same format,
+		blending a color over it on the way. This is done with the fastest <PixelKernels>
+		which the processor supports, rather than with SDL's generic blitter.
+
+		Parameters:
+			srcSurface - The surface to copy from.
+			portion - The area of srcSurface which is copied.
+			destSurface - The surface to copy to. This may be srcSurface itself, as long as
+			position is the same as portion, to blend the color over it in place.
+			position - The position on destSurface which the copy is placed at. The copy is
+			clipped to the clipping rectangle of destSurface.
+			color - The color, mapped to the format of destSurface, which is blended over
+			the copy.
+			alpha - The alpha value at which color is blended. At SDL_ALPHA_OPAQUE the area
+			is simply filled with color.
+
+		Returns:
+			False, leaving destSurface untouched, if the surfaces are not both 32 bit
+			surfaces with the same color masks, or either cannot be locked. True otherwise.
+	*/
+	extern bool BlendColor(SDL_Surface* srcSurface, const SDL_Rect& portion, SDL_Surface* destSurface,
+					const SDL_Rect& position, Uint32 color, Uint8 alpha);
 }
 #endif
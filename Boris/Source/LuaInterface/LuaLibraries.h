@@ -0,0 +1,63 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef LUA_LIBRARIES_H
+#define LUA_LIBRARIES_H
+
+#include <Lua/lua.hpp>
+
+#include <LuaInterface/LuaSDLInstance.h>
+#include <LuaInterface/LuaSDLForm.h>
+#include <LuaInterface/LuaSDLText.h>
+#include <LuaInterface/LuaSDLTextBox.h>
+#include <LuaInterface/LuaLoomEffect.h>
+#include <LuaInterface/LuaSDLSurfaceGridComponent.h>
+#include <LuaInterface/LuaSDLSurfaceGrid.h>
+#include <LuaInterface/LuaSDLTimer.h>
+#include <LuaInterface/LuaSDLFontFile.h>
+#include <LuaInterface/LuaSDLComponent.h>
+#include <LuaInterface/LuaTetromino.h>
+
+/*
+Function: RegisterLuaLibraries
+
+Registers every library which the scripts use with [luaVM]. Since the lua interface is
+defined in headers, this should only be included by the source file holding main.
+*/
+void RegisterLuaLibraries(lua_State* luaVM)
+{
+	RegisterSDLFontFileLibrary(luaVM);
+	RegisterSDLInstanceLibrary(luaVM);
+	RegisterSDLFormLibrary(luaVM);
+	RegisterSDLTextLibrary(luaVM);
+	RegisterSDLTextBoxLibrary(luaVM);
+	RegisterLoomEffectLibrary(luaVM);
+	RegisterSDLSurfaceGridLibrary(luaVM);
+	RegisterSDLSurfaceGridComponentLibrary(luaVM);
+	RegisterSDLTimerLibrary(luaVM);
+	RegisterSDLComponentLibrary(luaVM);
+	RegisterTetrominoLibrary(luaVM);
+}
+
+#endif
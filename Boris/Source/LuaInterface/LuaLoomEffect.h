@@ -44,6 +44,16 @@ int LoomEffect_New(lua_State* luaVM)
 	return 1;
 }
 
+int LoomEffect_GetCacheSize(lua_State* luaVM)
+{
+	LoomEffect* loomEffectInstance = RetrieveCPPObject<LoomEffect>(luaVM, 1);
+
+	lua_pushinteger(luaVM, loomEffectInstance->GetCacheSize());
+	lua_pushinteger(luaVM, loomEffectInstance->GetNumberOfCachedImages());
+
+	return 2;
+}
+
 int LoomEffect_DestroyInstance(lua_State* luaVM)
 {
 	LoomEffect* loomEffectInstance = RetrieveCPPObject<LoomEffect>(luaVM, 1);
@@ -55,6 +65,7 @@ int LoomEffect_DestroyInstance(lua_State* luaVM)
 struct luaL_Reg LoomEffectMetaTable [] =
 {
 	{"New", LoomEffect_New},
+	{"GetCacheSize", LoomEffect_GetCacheSize},
 	{NULL, NULL}
 };
 
@@ -1,4 +1,4 @@
-/*
+/*
 	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
 
 	This software is provided 'as-is', without any express or
@@ -19,7 +19,7 @@
 	   and must not be misrepresented as being the original software.
 
 	3. This notice may not be removed or altered from any
-	   source distribution.
+	   source distribution.
 */
 
 #ifndef LUA_SDL_INSTANCE_H
@@ -110,6 +110,23 @@ int SDLInstance_SetFocus(lua_State* luaVM)
 }
 
 
+//Starts [screenEffect], registering the complete handler, (container, function) or (function),
+//which follows the first [numberOfArguments] arguments if one was passed.
+void PerformLuaScreenEffect(lua_State* luaVM, ISDLScreenEffect* screenEffect, int numberOfArguments)
+{
+	if(lua_gettop(luaVM) > numberOfArguments)
+	{
+		for(int i = 0; i < numberOfArguments; i++)
+		{
+			lua_remove(luaVM, 1);
+		}
+
+		screenEffect->GetCompleteHandlers().AddLuaEventHandler(luaVM);
+	}
+
+	SDLInstance::GetInstance().PerformScreenEffect(screenEffect);
+}
+
 int SDLInstance_PerformFlashEffect(lua_State* luaVM)
 {
 	vector< Dimensions2D<int> > portions;
@@ -127,10 +144,7 @@ int SDLInstance_PerformFlashEffect(lua_State* luaVM)
 	int numberOfFrames = luaL_checkint(luaVM, 2);
 	int numberOfIterations = luaL_checkint(luaVM, 3);
 
-	FlashScreenEffect effect(portions, numberOfFrames, numberOfIterations);
-
-	SDLInstance& sdlInstance = SDLInstance::GetInstance();
-	sdlInstance.PerformScreenEffect(effect);
+	PerformLuaScreenEffect(luaVM, new FlashScreenEffect(portions, numberOfFrames, numberOfIterations), 3);
 
 	return 0;
 }
@@ -146,12 +160,16 @@ int SDLInstance_PerformOverlayEffect(lua_State* luaVM)
 
 	lua_pushvalue(luaVM, 1);
 
-	vector< Dimensions2D<int> > entireWindowPortion(1, Dimensions2D<int>(0, 0, sdlInstance.GetWindowWidth(), sdlInstance.GetWindowHeight()));
+	int red = GetIntField(luaVM, "r");
+	int green = GetIntField(luaVM, "g");
+	int blue = GetIntField(luaVM, "b");
+	int alpha = GetIntField(luaVM, "a");
+
+	lua_pop(luaVM, 1);
 
-	OverlayScreenEffect effect(entireWindowPortion, GetIntField(luaVM, "r"), GetIntField(luaVM, "g"),
-						GetIntField(luaVM, "b"), GetIntField(luaVM, "a"));
+	vector< Dimensions2D<int> > entireWindowPortion(1, Dimensions2D<int>(0, 0, sdlInstance.GetWindowWidth(), sdlInstance.GetWindowHeight()));
 
-	sdlInstance.PerformScreenEffect(effect);
+	PerformLuaScreenEffect(luaVM, new OverlayScreenEffect(entireWindowPortion, red, green, blue, alpha), 1);
 
 	return 0;
 }
@@ -219,13 +237,21 @@ int SDLInstance_PerformFadeEffect(lua_State* luaVM)
 	}
 
 	vector< Dimensions2D<int> > entireWindowPortion(1, Dimensions2D<int>(0, 0, sdlInstance.GetWindowWidth(), sdlInstance.GetWindowHeight()));
-	FadeScreenEffect effect(entireWindowPortion, numberOfFrames, animationLength, (SDLFadeDirection)fadeDirection);
-
-	sdlInstance.PerformScreenEffect(effect);
+	PerformLuaScreenEffect(luaVM, new FadeScreenEffect(entireWindowPortion, numberOfFrames, animationLength,
+		(SDLFadeDirection)fadeDirection), 3);
 
 	return 0;
 }
 
+int SDLInstance_IsPerformingScreenEffect(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushboolean(luaVM, sdlInstance.IsPerformingScreenEffect());
+
+	return 1;
+}
+
 int SDLInstance_Run(lua_State* luaVM)
 {
 	SDLInstance& sdlInstance = SDLInstance::GetInstance();
@@ -251,6 +277,24 @@ int SDLInstance_LoadTrunk(lua_State* luaVM)
 	return 0;
 }
 
+//Starts loading the trunk at 1 in the background. The handler after it, if there is one, is
+//raised once the trunk has been loaded.
+int SDLInstance_LoadTrunkAsync(lua_State* luaVM)
+{
+	string trunkName = luaL_checkstring(luaVM, 1);
+
+	GenericEventHandlerCollection& trunkLoadedHandlers =
+		ResourcePipelineSingleton::GetInstance().LoadResourceTrunkAsync(trunkName);
+
+	if(lua_gettop(luaVM) > 1)
+	{
+		lua_remove(luaVM, 1);
+		trunkLoadedHandlers.AddLuaEventHandler(luaVM);
+	}
+
+	return 0;
+}
+
 int SDLInstance_UnloadTrunk(lua_State* luaVM)
 {
 	string trunkName = luaL_checkstring(luaVM, 1);
@@ -260,6 +304,63 @@ int SDLInstance_UnloadTrunk(lua_State* luaVM)
 	return 0;
 }
 
+//Decodes the resources named in the array at 2, from the trunk at 1, so that the frames
+//which first use them are not stalled.
+int SDLInstance_PrefetchResources(lua_State* luaVM)
+{
+	string trunkName = luaL_checkstring(luaVM, 1);
+
+	if(!lua_istable(luaVM, 2))
+	{
+		luaL_argerror(luaVM, 2, "Expected table");
+	}
+
+	int numberOfResources = lua_objlen(luaVM, 2);
+	vector<string> resourceNames;
+
+	for(int i = 1; i <= numberOfResources; i++)
+	{
+		lua_rawgeti(luaVM, 2, i);
+
+		resourceNames.push_back(luaL_checkstring(luaVM, -1));
+
+		lua_pop(luaVM, 1);
+	}
+
+	//The resources are decoded together, so that they can be decoded in parallel.
+	ResourcePipelineSingleton::GetInstance().PrefetchResources(trunkName, resourceNames);
+
+	return 0;
+}
+
+//Returns a table holding, for each resource of the trunk at 1 which has been decoded, how
+//long it took to decode in micro-seconds. The times of resources which share a name are added.
+int SDLInstance_GetDecodeTimes(lua_State* luaVM)
+{
+	string trunkName = luaL_checkstring(luaVM, 1);
+
+	const map< pair<ResourceType, string>, int >& decodeTimes =
+		ResourcePipelineSingleton::GetInstance().GetDecodeTimes(trunkName);
+
+	lua_newtable(luaVM);
+
+	for(map< pair<ResourceType, string>, int >::const_iterator decodeTime = decodeTimes.begin();
+		decodeTime != decodeTimes.end();
+		decodeTime++)
+	{
+		lua_getfield(luaVM, -1, decodeTime->first.second.c_str());
+
+		int totalTime = lua_tointeger(luaVM, -1) + decodeTime->second;
+
+		lua_pop(luaVM, 1);
+
+		lua_pushinteger(luaVM, totalTime);
+		lua_setfield(luaVM, -2, decodeTime->first.second.c_str());
+	}
+
+	return 1;
+}
+
 int SDLInstance_KeyIsPressed(lua_State* luaVM)
 {
 	SDLInstance& sdlInstance = SDLInstance::GetInstance();
@@ -272,6 +373,119 @@ int SDLInstance_KeyIsPressed(lua_State* luaVM)
 	return 1;
 }
 
+int SDLInstance_GetRandomSeed(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushnumber(luaVM, sdlInstance.GetRandomSeed());
+
+	return 1;
+}
+
+int SDLInstance_SetKeyRepeat(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	int keySym = luaL_checkint(luaVM, 1);
+	int delay = luaL_checkint(luaVM, 2);
+	int interval = luaL_checkint(luaVM, 3);
+
+	sdlInstance.SetKeyRepeat(keySym, delay, interval);
+
+	return 0;
+}
+
+int SDLInstance_SetDefaultKeyRepeat(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	int delay = luaL_checkint(luaVM, 1);
+	int interval = luaL_checkint(luaVM, 2);
+
+	sdlInstance.SetDefaultKeyRepeat(delay, interval);
+
+	return 0;
+}
+
+int SDLInstance_GetExceptionsThrownLastFrame(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushinteger(luaVM, sdlInstance.GetExceptionsThrownLastFrame());
+
+	return 1;
+}
+
+int SDLInstance_GetPixelsPresentedLastFrame(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushinteger(luaVM, sdlInstance.GetPixelsPresentedLastFrame());
+
+	return 1;
+}
+
+int SDLInstance_GetBlitsLastFrame(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushinteger(luaVM, sdlInstance.GetBlitsLastFrame());
+
+	return 1;
+}
+
+int SDLInstance_GetDrawTimeLastFrame(lua_State* luaVM)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	lua_pushinteger(luaVM, sdlInstance.GetDrawTimeLastFrame());
+
+	return 1;
+}
+
+int SDLInstance_SetFrameStatsEnabled(lua_State* luaVM)
+{
+	bool enabled = LuaCheckBoolean(luaVM, 1);
+	bool writtenOnExit = lua_toboolean(luaVM, 2) != 0;
+
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+	sdlInstance.SetFrameStatsEnabled(enabled, writtenOnExit);
+
+	return 0;
+}
+
+//Returns a table holding, for each phase name, a table with the fields p50, p95, p99 and
+//max, in microseconds. The field frames holds the number of frames these are taken from.
+int SDLInstance_GetFrameStats(lua_State* luaVM)
+{
+	const SDLFrameStats& frameStats = SDLInstance::GetInstance().GetFrameStats();
+
+	lua_newtable(luaVM);
+
+	for(int phaseIndex = 0; phaseIndex < SDL_FP_NUMBER_OF_PHASES; phaseIndex++)
+	{
+		SDLFramePhase phase = (SDLFramePhase)phaseIndex;
+
+		lua_newtable(luaVM);
+
+		lua_pushinteger(luaVM, frameStats.GetPercentile(phase, 50));
+		lua_setfield(luaVM, -2, "p50");
+		lua_pushinteger(luaVM, frameStats.GetPercentile(phase, 95));
+		lua_setfield(luaVM, -2, "p95");
+		lua_pushinteger(luaVM, frameStats.GetPercentile(phase, 99));
+		lua_setfield(luaVM, -2, "p99");
+		lua_pushinteger(luaVM, frameStats.GetMaximum(phase));
+		lua_setfield(luaVM, -2, "max");
+
+		lua_setfield(luaVM, -2, SDLFrameStats::GetPhaseName(phase));
+	}
+
+	lua_pushinteger(luaVM, frameStats.GetNumberOfFrames());
+	lua_setfield(luaVM, -2, "frames");
+
+	return 1;
+}
+
 struct luaL_Reg SDLInstanceMetaTable [] =
 {
 	{"InitializeVideo", SDLInstance_InitializeVideo},
@@ -284,15 +498,28 @@ struct luaL_Reg SDLInstanceMetaTable [] =
 	{"PerformFlashEffect", SDLInstance_PerformFlashEffect},
 	{"PerformOverlayEffect", SDLInstance_PerformOverlayEffect},
 	{"PerformFadeEffect", SDLInstance_PerformFadeEffect},
+	{"IsPerformingScreenEffect", SDLInstance_IsPerformingScreenEffect},
 	{"Run", SDLInstance_Run},
 	{"Quit", SDLInstance_Quit},
 	{"LoadTrunk", SDLInstance_LoadTrunk},
+	{"LoadTrunkAsync", SDLInstance_LoadTrunkAsync},
 	{"UnloadTrunk", SDLInstance_UnloadTrunk},
+	{"PrefetchResources", SDLInstance_PrefetchResources},
+	{"GetDecodeTimes", SDLInstance_GetDecodeTimes},
 	{"KeyIsPressed", SDLInstance_KeyIsPressed},
+	{"SetKeyRepeat", SDLInstance_SetKeyRepeat},
+	{"GetRandomSeed", SDLInstance_GetRandomSeed},
+	{"SetDefaultKeyRepeat", SDLInstance_SetDefaultKeyRepeat},
 	{"PlayMusic", SDLInstance_PlayMusic},
 	{"PlaySound", SDLInstance_PlaySound},
 	{"FadeOutMusic", SDLInstance_FadeOutMusic},
 	{"HaltMusic", SDLInstance_HaltMusic},
+	{"GetExceptionsThrownLastFrame", SDLInstance_GetExceptionsThrownLastFrame},
+	{"GetPixelsPresentedLastFrame", SDLInstance_GetPixelsPresentedLastFrame},
+	{"GetDrawTimeLastFrame", SDLInstance_GetDrawTimeLastFrame},
+	{"GetBlitsLastFrame", SDLInstance_GetBlitsLastFrame},
+	{"SetFrameStatsEnabled", SDLInstance_SetFrameStatsEnabled},
+	{"GetFrameStats", SDLInstance_GetFrameStats},
 	{NULL, NULL}
 };
 
@@ -36,6 +36,55 @@
 using namespace SDLInterfaceLibrary;
 using namespace Helpers;
 
+//Reads the placement table at [tableIndex], a table of rows which each hold a number per cell, into a
+//grid. Raises an error on argument [argumentIndex] if the table is empty, or if its rows differ in length.
+Grid<unsigned int> ReadPlacementMap(lua_State* luaVM, int tableIndex, int argumentIndex)
+{
+	lua_pushvalue(luaVM, tableIndex);
+	vector< vector<unsigned int> > placementMap;
+
+	for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
+	{
+		if(!lua_istable(luaVM, -1))
+		{
+			luaL_argerror(luaVM, argumentIndex, "Expected a table for each row of the placement table");
+		}
+
+		vector<unsigned int> currentRow;
+
+		for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
+		{
+			currentRow.push_back(luaL_checkint(luaVM, -1));
+		}
+
+		if(!placementMap.empty() && currentRow.size() != placementMap[0].size())
+		{
+			luaL_argerror(luaVM, argumentIndex, "Every row of the placement table should be as long as the first");
+		}
+
+		placementMap.push_back(currentRow);
+	}
+
+	lua_pop(luaVM, 1);
+
+	if(placementMap.empty() || placementMap[0].empty())
+	{
+		luaL_argerror(luaVM, argumentIndex, "Empty placement table");
+	}
+
+	Grid<unsigned int> placementGrid(placementMap[0].size(), placementMap.size());
+
+	for(int y = 0; y < placementGrid.GetHeight(); y++)
+	{
+		for(int x = 0; x < placementGrid.GetWidth(); x++)
+		{
+			placementGrid(x, y) = placementMap[y][x];
+		}
+	}
+
+	return placementGrid;
+}
+
 int SDLSurfaceGrid_New(lua_State* luaVM)
 {
 	string name = luaL_checkstring(luaVM, 1);
@@ -58,31 +107,7 @@ int SDLSurfaceGrid_New(lua_State* luaVM)
 	}
 	else
 	{
-		lua_pushvalue(luaVM, 2);
-		vector< vector<unsigned int> > placementMap;
-
-		for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
-		{
-			vector<unsigned int> currentRow;
-
-			for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
-			{
-				currentRow.push_back(luaL_checkint(luaVM, -1));
-			}
-
-			placementMap.push_back(currentRow);
-		}
-
-		lua_pop(luaVM, 1);
-
-		Grid<unsigned int> placementGrid(placementMap[0].size(), placementMap.size());
-		for(int x = 0; x < placementGrid.GetWidth(); x++)
-		{
-			for(int y = 0; y < placementGrid.GetHeight(); y++)
-			{
-				placementGrid.Set(x, y, placementMap[y][x]);
-			}
-		}
+		Grid<unsigned int> placementGrid = ReadPlacementMap(luaVM, 2, 2);
 
 		string trunkName = luaL_checkstring(luaVM, 3);
 		string imageName = luaL_checkstring(luaVM, 4);
@@ -40,7 +40,7 @@ int SDLSurfaceGridComponent_New(lua_State* luaVM)
 	string name = luaL_checkstring(luaVM, 1);
 	Vector2D<int> position = Vector2D<int>(luaL_checkint(luaVM, 2), luaL_checkint(luaVM, 3));
 
-	vector<SDLSurfaceGrid> surfaceGrids;
+	vector<SharedSDLSurfaceGrid> surfaceGrids;
 
 	if(lua_istable(luaVM, 4))
 	{
@@ -49,7 +49,7 @@ int SDLSurfaceGridComponent_New(lua_State* luaVM)
 		for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
 		{
 			SDLSurfaceGrid* sdlSurfaceGridInstance = (SDLSurfaceGrid*)luaL_checkudata(luaVM, -1, typeid(SDLSurfaceGrid).name());
-			surfaceGrids.push_back(*sdlSurfaceGridInstance);
+			surfaceGrids.push_back(make_shared<SDLSurfaceGrid>(*sdlSurfaceGridInstance));
 		}
 
 		lua_pop(luaVM, 1);
@@ -57,7 +57,7 @@ int SDLSurfaceGridComponent_New(lua_State* luaVM)
 	else
 	{
 		SDLSurfaceGrid* surfaceGridInstance = (SDLSurfaceGrid*)luaL_checkudata(luaVM, 4, typeid(SDLSurfaceGrid).name());
-		surfaceGrids.push_back(*surfaceGridInstance);
+		surfaceGrids.push_back(make_shared<SDLSurfaceGrid>(*surfaceGridInstance));
 	}
 
 
@@ -170,7 +170,7 @@ int SDLSurfaceGridComponent_ReplaceCurrentSurfaces(lua_State* luaVM)
 	Vector2D<int> positionToCopyTo(luaL_checkint(luaVM, 4), luaL_checkint(luaVM, 5));
 	bool nullOverwrite = LuaCheckBoolean(luaVM, 6);
 
-	sdlSurfaceGridComponentInstance->ReplaceCurrentSurfaces(target->GetCurrentSurfaceGrid(), positionToCopyTo, nullOverwrite, pPortionToCopy);
+	sdlSurfaceGridComponentInstance->ReplaceCurrentSurfaces(target->GetConstCurrentSurfaceGrid(), positionToCopyTo, nullOverwrite, pPortionToCopy);
 	return 0;
 }
 
@@ -206,6 +206,38 @@ int SDLSurfaceGridComponent_MoveCurrentSurfaces(lua_State* luaVM)
 	return 0;
 }
 
+int SDLSurfaceGridComponent_CollapseRows(lua_State* luaVM)
+{
+	SDLSurfaceGridComponent* sdlSurfaceGridComponentInstance = RetrieveCPPObject<SDLSurfaceGridComponent>(luaVM, 1);
+
+	if(!lua_istable(luaVM, 2))
+	{
+		luaL_argerror(luaVM, 2, "Expected table");
+	}
+
+	vector<int> rowIndexes;
+
+	lua_pushvalue(luaVM, 2);
+
+	for(lua_pushnil(luaVM); lua_next(luaVM, -2); lua_pop(luaVM, 1))
+	{
+		rowIndexes.push_back(luaL_checkint(luaVM, -1));
+	}
+
+	lua_pop(luaVM, 1);
+
+	sdlSurfaceGridComponentInstance->CollapseCurrentRows(rowIndexes);
+	return 0;
+}
+
+int SDLSurfaceGridComponent_SetCached(lua_State* luaVM)
+{
+	SDLSurfaceGridComponent* sdlSurfaceGridComponentInstance = RetrieveCPPObject<SDLSurfaceGridComponent>(luaVM, 1);
+	bool cached = LuaCheckBoolean(luaVM, 2);
+
+	sdlSurfaceGridComponentInstance->SetCached(cached);
+	return 0;
+}
 
 int SDLSurfaceGridComponent_GetWidth(lua_State* luaVM)
 {
@@ -298,29 +330,10 @@ int SDLSurfaceGridComponent_DestroyInstance(lua_State* luaVM)
 int SDLSurfaceGridComponent_GetCompleteLineIndexes(lua_State* luaVM)
 {
 	SDLSurfaceGridComponent* sdlSurfaceGridComponentInstance = RetrieveCPPObject<SDLSurfaceGridComponent>(luaVM, 1);
-	SDLSurfaceGrid& surfaceGridToCheck  = sdlSurfaceGridComponentInstance->GetCurrentSurfaceGrid();
+	const SDLSurfaceGrid& surfaceGridToCheck  = sdlSurfaceGridComponentInstance->GetConstCurrentSurfaceGrid();
 
 	//Find completed lines indexes
-	vector<int> completeLineIndexes;
-
-	for(int y = 0; y < surfaceGridToCheck.GetHeight(); y++)
-	{
-		bool lineComplete = true;
-
-		for(int x = 0; x < surfaceGridToCheck.GetWidth(); x++)
-		{
-			if(surfaceGridToCheck.GetSurface(Vector2D<int>(x, y)) == NULL)
-			{
-				lineComplete = false;
-				break;
-			}
-		}
-
-		if(lineComplete)
-		{
-			completeLineIndexes.push_back(y);
-		}
-	}
+	vector<int> completeLineIndexes = surfaceGridToCheck.GetFullRowIndexes();
 
 	//Push complete line indexes to lua
 
@@ -356,6 +369,8 @@ struct luaL_Reg SDLSurfaceGridComponentInstance [] =
 	{"ClearCurrentSurfaces", SDLSurfaceGridComponent_ClearCurrentSurfaces},
 	{"ReplaceCurrentSurfaces", SDLSurfaceGridComponent_ReplaceCurrentSurfaces},
 	{"MoveCurrentSurfaces", SDLSurfaceGridComponent_MoveCurrentSurfaces},
+	{"CollapseRows", SDLSurfaceGridComponent_CollapseRows},
+	{"SetCached", SDLSurfaceGridComponent_SetCached},
 	{"GetLeft", SDLSurfaceGridComponent_GetLeft},
 	{"GetTop", SDLSurfaceGridComponent_GetTop},
 	{"GetWidth", SDLSurfaceGridComponent_GetWidth},
@@ -25,7 +25,9 @@
 #ifndef LUA_SDL_TIMER_H
 #define LUA_SDL_TIMER_H
 
+#include <SDLInterface/SDLInstance.h>
 #include <SDLInterface/SDLTimer.h>
+#include <SDLInterface/SDLTimerWheel.h>
 #include <Helpers/LuaHelperFunctions.h>
 #include <EventHandling/GenericEventHandler.h>
 
@@ -35,9 +37,11 @@ using namespace Helpers;
 int SDLTimer_New(lua_State* luaVM)
 {
 	int interval = luaL_checkint(luaVM, 1);
+	bool repeating = lua_isnoneornil(luaVM, 2) || lua_toboolean(luaVM, 2);
+
 	void* timer = CreateLuaInstanceBasedOnClass<SDLTimer>(luaVM);
 
-	new(timer) SDLTimer(interval);
+	new(timer) SDLTimer(interval, repeating);
 
 	return 1;
 }
@@ -78,9 +82,70 @@ int SDLTimer_Continue(lua_State* luaVM)
 	return 0;
 }
 
+int SDLTimer_Start(lua_State* luaVM)
+{
+	SDLTimer* sdlTimerInstance = RetrieveCPPObject<SDLTimer>(luaVM, 1);
+	sdlTimerInstance->Start();
+
+	return 0;
+}
+
+int SDLTimer_Stop(lua_State* luaVM)
+{
+	SDLTimer* sdlTimerInstance = RetrieveCPPObject<SDLTimer>(luaVM, 1);
+	sdlTimerInstance->Stop();
+
+	return 0;
+}
+
+int SDLTimer_DestroyInstance(lua_State* luaVM)
+{
+	SDLTimer* sdlTimerInstance = RetrieveCPPObject<SDLTimer>(luaVM, 1);
+	sdlTimerInstance->~SDLTimer();
+
+	return 0;
+}
+
+//Schedules the handler, (container, function) or (function), which follows the interval
+//on the timer wheel, and pushes it's handle.
+int ScheduleLuaHandler(lua_State* luaVM, bool repeating)
+{
+	int interval = luaL_checkint(luaVM, 1);
+	lua_remove(luaVM, 1);
+
+	SDLTimerHandle handle = SDLInstance::GetInstance().GetTimerWheel().Schedule(interval,
+		repeating? interval: 0, new LuaGenericEventHandler(luaVM));
+
+	lua_pushinteger(luaVM, handle);
+
+	return 1;
+}
+
+int SDLTimer_After(lua_State* luaVM)
+{
+	return ScheduleLuaHandler(luaVM, false);
+}
+
+int SDLTimer_Every(lua_State* luaVM)
+{
+	return ScheduleLuaHandler(luaVM, true);
+}
+
+int SDLTimer_Cancel(lua_State* luaVM)
+{
+	SDLTimerHandle handle = (SDLTimerHandle)luaL_checkinteger(luaVM, 1);
+
+	lua_pushboolean(luaVM, SDLInstance::GetInstance().GetTimerWheel().Cancel(handle));
+
+	return 1;
+}
+
 struct luaL_Reg SDLTimerMetaTable [] =
 {
 	{"New", SDLTimer_New},
+	{"After", SDLTimer_After},
+	{"Every", SDLTimer_Every},
+	{"Cancel", SDLTimer_Cancel},
 	{NULL, NULL}
 };
 
@@ -90,6 +155,9 @@ struct luaL_Reg SDLTimerInstance [] =
 	{"SetInterval", SDLTimer_SetInterval},
 	{"Pause", SDLTimer_Pause},
 	{"Continue", SDLTimer_Continue},
+	{"Start", SDLTimer_Start},
+	{"Stop", SDLTimer_Stop},
+	{"__gc", SDLTimer_DestroyInstance},
 	{NULL, NULL}
 };
 
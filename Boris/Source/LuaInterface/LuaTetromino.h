@@ -0,0 +1,187 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef LUA_TETROMINO_H
+#define LUA_TETROMINO_H
+
+#include <string>
+#include <vector>
+
+#include <Lua/lua.hpp>
+
+#include <ResourcePipelineSingleton.h>
+#include <Helpers/LuaHelperFunctions.h>
+#include <LuaInterface/LuaSDLSurfaceGrid.h>
+#include <SDLInterface/SDLSurfaceGridComponent.h>
+#include <SDLInterface/TetrominoBank.h>
+
+using namespace SDLInterfaceLibrary;
+using namespace Helpers;
+
+//The key, in the lua registry, of the table which holds the components returned by
+//Tetromino.Get, indexed by tetromino name.
+const char* const TETROMINO_COMPONENT_CACHE = "TetrominoComponentCache";
+
+//Pushes the component cache unto the stack, creating it if it doesn't exist yet.
+void PushTetrominoComponentCache(lua_State* luaVM)
+{
+	lua_getfield(luaVM, LUA_REGISTRYINDEX, TETROMINO_COMPONENT_CACHE);
+
+	if(lua_isnil(luaVM, -1))
+	{
+		lua_pop(luaVM, 1);
+
+		lua_newtable(luaVM);
+		lua_pushvalue(luaVM, -1);
+		lua_setfield(luaVM, LUA_REGISTRYINDEX, TETROMINO_COMPONENT_CACHE);
+	}
+}
+
+int Tetromino_Get(lua_State* luaVM)
+{
+	string name = luaL_checkstring(luaVM, 1);
+	string trunkName = luaL_checkstring(luaVM, 2);
+	string imageName = luaL_checkstring(luaVM, 3);
+
+	TetrominoBank& tetrominoBank = TetrominoBank::GetInstance();
+
+	if(!tetrominoBank.IsDefined(name))
+	{
+		luaL_argerror(luaVM, 1, "Undefined tetromino");
+	}
+
+	SDL_Surface* blockSurface = ResourcePipelineSingleton::GetInstance().GetImage(trunkName, imageName);
+	const vector<SharedSDLSurfaceGrid>& surfaceGrids = tetrominoBank.GetSurfaceGrids(name, blockSurface);
+
+	PushTetrominoComponentCache(luaVM);
+	lua_getfield(luaVM, -1, name.c_str());
+
+	if(lua_isnil(luaVM, -1))
+	{
+		lua_pop(luaVM, 1);
+
+		void* sdlSurfaceGridComponentInstance = CreateLuaInstanceBasedOnClass<SDLSurfaceGridComponent>(luaVM);
+		new(sdlSurfaceGridComponentInstance) SDLSurfaceGridComponent(name, Vector2D<int>(0, 0), surfaceGrids,
+			tetrominoBank.GetClearingMethod(name));
+
+		lua_pushvalue(luaVM, -1);
+		lua_setfield(luaVM, -3, name.c_str());
+	}
+
+	return 1;
+}
+
+int Tetromino_Define(lua_State* luaVM)
+{
+	string name = luaL_checkstring(luaVM, 1);
+
+	if(!lua_istable(luaVM, 2))
+	{
+		luaL_argerror(luaVM, 2, "Expected table");
+	}
+
+	vector< Grid<unsigned int> > placementMaps;
+	vector< Vector2D<int> > anchorBlockPositions;
+
+	//The rotations are taken in order, so the table must be a list of them and nothing else.
+	int numberOfRotations = lua_objlen(luaVM, 2);
+	int numberOfFields = 0;
+
+	for(lua_pushnil(luaVM); lua_next(luaVM, 2); lua_pop(luaVM, 1))
+	{
+		numberOfFields++;
+	}
+
+	if(numberOfRotations == 0 || numberOfFields != numberOfRotations)
+	{
+		luaL_argerror(luaVM, 2, "Expected a list of rotations");
+	}
+
+	for(int i = 1; i <= numberOfRotations; i++)
+	{
+		lua_rawgeti(luaVM, 2, i);
+
+		if(!lua_istable(luaVM, -1))
+		{
+			luaL_argerror(luaVM, 2, "Expected a table for each rotation");
+		}
+
+		anchorBlockPositions.push_back(Vector2D<int>(GetIntField(luaVM, "anchorX"), GetIntField(luaVM, "anchorY")));
+
+		lua_getfield(luaVM, -1, "placement");
+
+		if(!lua_istable(luaVM, -1))
+		{
+			luaL_argerror(luaVM, 2, "Expected a placement table for each rotation");
+		}
+
+		Grid<unsigned int> placementGrid = ReadPlacementMap(luaVM, -1, 2);
+
+		lua_pop(luaVM, 1);
+
+		//Every block of a tetromino uses the same image.
+		for(int y = 0; y < placementGrid.GetHeight(); y++)
+		{
+			for(int x = 0; x < placementGrid.GetWidth(); x++)
+			{
+				placementGrid(x, y) = placementGrid(x, y) != 0? 1: 0;
+			}
+		}
+
+		placementMaps.push_back(placementGrid);
+
+		lua_pop(luaVM, 1);
+	}
+
+	int clearingMethod = luaL_checkint(luaVM, 3);
+
+	if(clearingMethod > 1 || clearingMethod < 0)
+	{
+		luaL_argerror(luaVM, 3, "Invalid clearing method value");
+	}
+
+	TetrominoBank::GetInstance().Define(name, placementMaps, anchorBlockPositions, (SDLClearingMethod)clearingMethod);
+
+	//Any component built from a previous definition is discarded.
+	PushTetrominoComponentCache(luaVM);
+	lua_pushnil(luaVM);
+	lua_setfield(luaVM, -2, name.c_str());
+	lua_pop(luaVM, 1);
+
+	return 0;
+}
+
+struct luaL_Reg TetrominoMetaTable [] =
+{
+	{"Get", Tetromino_Get},
+	{"Define", Tetromino_Define},
+	{NULL, NULL}
+};
+
+void RegisterTetrominoLibrary(lua_State* luaVM)
+{
+	luaL_openlib(luaVM, "Tetromino", TetrominoMetaTable, 0);
+}
+
+#endif
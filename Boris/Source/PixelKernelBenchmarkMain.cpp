@@ -0,0 +1,180 @@
+#include <Helpers/PixelKernels.h>
+#include <Helpers/ApplicationException.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::setw;
+using std::string;
+using std::vector;
+
+using namespace Helpers;
+
+//The size of the screen, which is what the screen effects blend.
+const int WIDTH = 800;
+const int HEIGHT = 600;
+const int NUMBER_OF_PIXELS = WIDTH * HEIGHT;
+
+//How long each routine is run for, in seconds.
+const double MINIMUM_DURATION = 0.25;
+
+enum KernelOperation
+{
+	OPERATION_BLEND_COLOR,
+	OPERATION_CROSS_FADE,
+	OPERATION_FILL,
+	NUMBER_OF_OPERATIONS
+};
+
+const char* OPERATION_NAMES[NUMBER_OF_OPERATIONS] = {"BlendColor", "CrossFade", "Fill"};
+
+/*
+Function: Run
+
+Runs a single operation from a set of kernels over [numberOfPixels] pixels.
+*/
+void Run(const PixelKernels& kernels, KernelOperation operation, Uint32* destination,
+	const Uint32* first, const Uint32* second, int numberOfPixels, Uint8 alpha)
+{
+	switch(operation)
+	{
+	case OPERATION_BLEND_COLOR:
+		kernels.BlendColor(destination, first, numberOfPixels, 0x00C08040, alpha);
+		break;
+	case OPERATION_CROSS_FADE:
+		kernels.CrossFade(destination, first, second, numberOfPixels, alpha);
+		break;
+	default:
+		kernels.Fill(destination, numberOfPixels, 0x00C08040);
+		break;
+	}
+}
+
+/*
+Function: Verify
+
+Checks that a set of kernels produces exactly the same pixels as the plain C++ set, at every
+alpha value and for row lengths which leave a remainder after the vector loops.
+*/
+void Verify(const PixelKernels& kernels, const PixelKernels& reference, const vector<Uint32>& first,
+	const vector<Uint32>& second)
+{
+	const int lengths[] = {0, 1, 3, 7, 15, 17, 33, 803};
+
+	vector<Uint32> expected(first.size());
+	vector<Uint32> actual(first.size());
+
+	for(int operation = 0; operation < NUMBER_OF_OPERATIONS; operation++)
+	{
+		for(int alpha = 0; alpha <= 255; alpha++)
+		{
+			for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+			{
+				Run(reference, (KernelOperation)operation, &expected[0], &first[0], &second[0],
+					lengths[i], (Uint8)alpha);
+				Run(kernels, (KernelOperation)operation, &actual[0], &first[0], &second[0],
+					lengths[i], (Uint8)alpha);
+
+				if(!std::equal(expected.begin(), expected.begin() + lengths[i], actual.begin()))
+				{
+					string message = string(kernels.name) + " " + OPERATION_NAMES[operation] +
+						" does not match " + reference.name;
+
+					throw ApplicationException(message.c_str());
+				}
+			}
+		}
+	}
+}
+
+/*
+Function: Measure
+
+Returns:
+	The number of megapixels per second which an operation from a set of kernels processes
+	over a screen sized buffer.
+*/
+double Measure(const PixelKernels& kernels, KernelOperation operation, vector<Uint32>& destination,
+	const vector<Uint32>& first, const vector<Uint32>& second)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	long long pixelsProcessed = 0;
+	double elapsedTime = 0;
+
+	Clock::time_point startTime = Clock::now();
+
+	for(int iteration = 0; elapsedTime < MINIMUM_DURATION; iteration++)
+	{
+		Run(kernels, operation, &destination[0], &first[0], &second[0], NUMBER_OF_PIXELS,
+			(Uint8)(iteration & 0xFF));
+
+		pixelsProcessed += NUMBER_OF_PIXELS;
+		elapsedTime = std::chrono::duration<double>(Clock::now() - startTime).count();
+	}
+
+	return pixelsProcessed / elapsedTime / 1000000.0;
+}
+
+int main()
+{
+	try
+	{
+		vector<Uint32> first(NUMBER_OF_PIXELS);
+		vector<Uint32> second(NUMBER_OF_PIXELS);
+		vector<Uint32> destination(NUMBER_OF_PIXELS);
+
+		srand(0);
+
+		for(int i = 0; i < NUMBER_OF_PIXELS; i++)
+		{
+			first[i] = ((Uint32)rand() << 16) ^ (Uint32)rand();
+			second[i] = ((Uint32)rand() << 16) ^ (Uint32)rand();
+		}
+
+		vector<const PixelKernels*> supportedKernels = GetSupportedPixelKernels();
+
+		cout << "Selected: " << GetPixelKernels().name << endl;
+		cout << "Megapixels per second over " << WIDTH << "x" << HEIGHT << " pixels:" << endl;
+
+		cout << setw(8) << "";
+
+		for(int operation = 0; operation < NUMBER_OF_OPERATIONS; operation++)
+		{
+			cout << setw(12) << OPERATION_NAMES[operation];
+		}
+
+		cout << endl;
+
+		for(size_t i = 0; i < supportedKernels.size(); i++)
+		{
+			const PixelKernels& kernels = *supportedKernels[i];
+
+			Verify(kernels, *supportedKernels[0], first, second);
+
+			cout << setw(8) << kernels.name << std::fixed << std::setprecision(0);
+
+			for(int operation = 0; operation < NUMBER_OF_OPERATIONS; operation++)
+			{
+				cout << setw(12) << Measure(kernels, (KernelOperation)operation, destination, first, second);
+			}
+
+			cout << endl;
+		}
+	}
+	catch(exception& error)
+	{
+		cout << error.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+#include <SDLInterface/SDLInstance.h>
+#include <SDLInterface/SDLInputLog.h>
+#include <SDLInterface/SDLForm.h>
+#include <ResourcePipelineSingleton.h>
+
+#include <SDL/SDL.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using namespace SDLInterfaceLibrary;
+
+//The trunk which is loaded on the way from the menu to the game, when none is given.
+const char* DEFAULT_TRUNK_NAME = "Data/Score.dat";
+
+//The log which the first run is recorded to, and the second replayed from.
+const char* LOG_FILE_NAME = "ReplayCheck.log";
+
+//How many frames the recorded run lasts, and how many steps each of them takes.
+const int NUMBER_OF_FRAMES = 120;
+const int STEPS_PER_FRAME = 16;
+
+//The frame on which the menu is left, by loading the trunk in the background.
+const int MENU_EXIT_FRAME = 10;
+
+//The drivers are set through SDL_putenv, which keeps the strings it is given.
+char VIDEO_DRIVER_VARIABLE[] = "SDL_VIDEODRIVER=dummy";
+char AUDIO_DRIVER_VARIABLE[] = "SDL_AUDIODRIVER=dummy";
+
+/*
+	Class: ScriptedPlayer
+
+	Taps a key on every frame of the recorded run. Return is tapped on MENU_EXIT_FRAME, and
+	the letters of the alphabet, in turn, on each of the others.
+*/
+class ScriptedPlayer: public ISDLInputSource
+{
+	private:
+		//The number of frames which have been read so far.
+		int numberOfFrames;
+
+	public:
+		ScriptedPlayer(): numberOfFrames(0) {}
+
+		bool ReadFrame(int& elapsedSteps, vector<SDLInputEvent>& events)
+		{
+			if(numberOfFrames >= NUMBER_OF_FRAMES)
+			{
+				return false;
+			}
+
+			int keySymbol = (numberOfFrames == MENU_EXIT_FRAME)? SDLK_RETURN: SDLK_a + numberOfFrames % 26;
+
+			SDLInputEvent keyDown = {SDL_IE_KEY_DOWN, keySymbol};
+			SDLInputEvent keyUp = {SDL_IE_KEY_UP, keySymbol};
+
+			events.clear();
+			events.push_back(keyDown);
+			events.push_back(keyUp);
+
+			elapsedSteps = STEPS_PER_FRAME;
+			numberOfFrames++;
+
+			return true;
+		}
+};
+
+/*
+	Class: CheckGame
+
+	A game of two states, a menu and the game itself, which are forms of their own. Return
+	leaves the menu by loading a trunk in the background, and the game is entered once the
+	trunk has been loaded. Every key pressed, and the change of state, is traced along with
+	the frame it happened on.
+*/
+class CheckGame
+{
+	private:
+		SDLForm menuForm;
+		SDLForm gameForm;
+
+		string trunkName;
+
+		//The number of frames which have been run so far.
+		int frame;
+		stringstream trace;
+
+		void MenuKeyDown(int keySymbol)
+		{
+			trace << frame << " menu " << keySymbol << endl;
+
+			if(keySymbol == SDLK_RETURN)
+			{
+				ResourcePipelineSingleton::GetInstance().LoadResourceTrunkAsync(trunkName).AddCppEventHandler(this,
+					&CheckGame::EnterGame);
+			}
+		}
+
+		void GameKeyDown(int keySymbol)
+		{
+			trace << frame << " game " << keySymbol << endl;
+		}
+
+		void EnterGame()
+		{
+			trace << frame << " loaded" << endl;
+
+			SDLInstance::GetInstance().SetFocus(&gameForm);
+		}
+
+		void CountFrame()
+		{
+			frame++;
+		}
+
+	public:
+		/*
+			Constructor: CheckGame
+
+			Creates the game, which is to load [trunkName], and adds it to the frame handlers
+			of the SDLInstance. It must outlive every run.
+		*/
+		CheckGame(const string& trunkName):
+			menuForm("Menu", Vector2D<int>(0, 0), NULL),
+			gameForm("Game", Vector2D<int>(0, 0), NULL)
+		{
+			this->trunkName = trunkName;
+			frame = 0;
+
+			menuForm.GetKeyDownHandlers().AddCppEventHandler(this, &CheckGame::MenuKeyDown);
+			gameForm.GetKeyDownHandlers().AddCppEventHandler(this, &CheckGame::GameKeyDown);
+
+			SDLInstance::GetInstance().GetFrameHandlers().AddCppEventHandler(this, &CheckGame::CountFrame);
+		}
+
+		/*
+			Function: Run
+
+			Plays the game from the menu until the input runs out, and unloads the trunk.
+
+			Returns:
+				The trace of the run.
+		*/
+		string Run()
+		{
+			SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+			frame = 0;
+			trace.str("");
+
+			sdlInstance.SetFocus(&menuForm);
+			sdlInstance.Run();
+
+			//This stops the input log, and flushes it when it is being recorded.
+			sdlInstance.CleanUp();
+			ResourcePipelineSingleton::GetInstance().UnloadAllTrunks();
+
+			return trace.str();
+		}
+};
+
+/*
+Function: GetLoadedFrame
+
+Returns:
+	The frame on which [trace] entered the game, or -1 if it never did.
+*/
+int GetLoadedFrame(const string& trace)
+{
+	stringstream traceStream(trace);
+	string line;
+
+	while(getline(traceStream, line))
+	{
+		if(line.find(" loaded") != string::npos)
+		{
+			return atoi(line.c_str());
+		}
+	}
+
+	return -1;
+}
+
+/*
+Records a run which leaves the menu by loading a trunk in the background, replays it, and
+checks that the replay changes state on the same frame, and then presses the same keys in the
+same state, as the recording.
+
+Usage: ReplayCheck [trunk]
+*/
+int main(int argc, char** argv)
+{
+	int error = 0;
+
+	SDL_putenv(VIDEO_DRIVER_VARIABLE);
+	SDL_putenv(AUDIO_DRIVER_VARIABLE);
+
+	//Trunks loaded through LoadResourceTrunkAsync are handed over between frames.
+	LoadedTrunkDispatcher trunkDispatcher;
+	SDLInstance::GetInstance().GetFrameHandlers().AddCppEventHandler(&trunkDispatcher,
+		&LoadedTrunkDispatcher::DispatchLoadedTrunks);
+
+	try
+	{
+		SDLInstance& sdlInstance = SDLInstance::GetInstance();
+		CheckGame game(argc > 1 ? argv[1] : DEFAULT_TRUNK_NAME);
+		ScriptedPlayer player;
+
+		sdlInstance.InitializeAudio(44100, 1024);
+
+		//The video is initialized for each run, since cleaning up after one deletes the
+		//frame rate manager.
+		sdlInstance.InitializeVideo(false, Bounds2D<int>(64, 64), 32, 0);
+		sdlInstance.SetRandomSeed(0);
+		sdlInstance.StartRecordingInput(LOG_FILE_NAME);
+		sdlInstance.SetInputSource(&player);
+
+		string recordedTrace = game.Run();
+
+		sdlInstance.InitializeVideo(false, Bounds2D<int>(64, 64), 32, 0);
+		sdlInstance.StartReplayingInput(LOG_FILE_NAME);
+
+		string replayedTrace = game.Run();
+
+		int recordedLoadedFrame = GetLoadedFrame(recordedTrace);
+		int replayedLoadedFrame = GetLoadedFrame(replayedTrace);
+
+		cout << "Entered the game on frame " << recordedLoadedFrame << " when recorded, and on frame ";
+		cout << replayedLoadedFrame << " when replayed." << endl;
+
+		if(recordedLoadedFrame < 0 || recordedTrace != replayedTrace)
+		{
+			cout << "FAILED: The replay does not match the recording." << endl;
+			error = 1;
+		}
+		else
+		{
+			cout << "passed" << endl;
+		}
+	}
+	catch(exception& checkException)
+	{
+		cout << checkException.what() << endl;
+		error = 1;
+	}
+
+	SDLInstance::GetInstance().CleanUp();
+	ResourcePipelineSingleton::GetInstance().UnloadAllTrunks();
+	SDLInstance::GetInstance().CleanUpSDL();
+
+	remove(LOG_FILE_NAME);
+
+	return error;
+}
@@ -1,5 +1,6 @@
 #include <SDLInterface/SDLResourcePipeline.h>
 #include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/ResourcePack.h>
 
 #include <SDL/SDL.h>
 #include <SDL/SDL_mixer.h>
@@ -28,6 +29,35 @@ struct ResourceInfo
 	ResourceType type;
 };
 
+/*
+Function: ReadFile
+
+Returns the contents of the file [fileName].
+*/
+vector<char> ReadFile(const string& fileName)
+{
+	fstream srcFile(fileName.c_str(), fstream::in | std::ios::binary);
+
+	if(!srcFile)
+	{
+		throw ApplicationException(("Could not open " + fileName).c_str());
+	}
+
+	srcFile.seekg(0, ios_base::end);
+	int fileLength = srcFile.tellg();
+
+	srcFile.seekg(0, ios_base::beg);
+
+	vector<char> file(fileLength);
+
+	if(fileLength > 0)
+	{
+		srcFile.read(&file[0], fileLength);
+	}
+
+	return file;
+}
+
 /*
 Function: Pack
 
@@ -41,16 +71,8 @@ void Pack(const string& sourceFolder, const string& destinationFileName)
 {
 	/*Pack File Format:
 
-
-	byte 0: Number of files contained within this package.
-
-	For each file:
-
-	byte 0: Filetype. 0 == Bitmap, 1 == Music File, 2 == Sound file 
-	byte 1: Number of characters in file name. :- nameLength
-	byte 2 - nameLength: Filename.
-	byte nameLength + 2 - nameLength + 5: Number of bytes in file. :- fileLength
-	byte nameLength + 6 - nameLength + 5 + fileLength. :- file.
+	A header and a table of contents, which gives the type, name, offset, size and hash
+	of every file, followed by the files themselves. See ResourcePack.h.
 	*/
 	Directory trunkDirectory(sourceFolder);
 
@@ -90,42 +112,46 @@ void Pack(const string& sourceFolder, const string& destinationFileName)
 		currentFile = trunkDirectory.GetNextFile();
 	}
 
-	fstream packedFile(destinationFileName.c_str(), fstream::out | fstream::binary);
-
-	//Write number of files
-	int numberOfFiles = resources.size();
-	packedFile << (char)numberOfFiles;
+	//The table of contents comes first, so every file is measured and hashed before any is written.
+	vector<ResourcePackEntry> entries;
 
-	//Write music files
 	for(vector<ResourceInfo>::const_iterator resourceIterator = resources.begin();
 		resourceIterator != resources.end();
 		resourceIterator++)
 	{
-		//Write type
-		packedFile << (char)resourceIterator->type;
+		vector<char> file = ReadFile(resourceIterator->source);
 
-		//Write name		
-		packedFile << (char)resourceIterator->name.size();
-		packedFile << resourceIterator->name.c_str();
+		ResourcePackEntry entry;
 
-		//Get file and write file length
-		int fileLength = 0;
-		fstream srcFile(resourceIterator->source.c_str(), fstream::in | std::ios::binary);
+		entry.type = resourceIterator->type;
+		entry.name = resourceIterator->name;
+		entry.offset = 0;
+		entry.size = file.size();
+		entry.hash = HashResourceData(file.empty() ? NULL : &file[0], file.size());
 
-		srcFile.seekg(0, ios_base::end);
-		fileLength = srcFile.tellg();
+		entries.push_back(entry);
+	}
+
+	fstream packedFile(destinationFileName.c_str(), fstream::out | fstream::trunc | fstream::binary);
 
-		srcFile.seekg(0, ios_base::beg);
+	if(!packedFile)
+	{
+		throw ApplicationException(("Could not open " + destinationFileName + " for writing").c_str());
+	}
 
-		packedFile << fileLength;		
-		
-		//write file
-		char* buffer = new char[fileLength];
-		
-		srcFile.read(buffer, fileLength);
-		packedFile.write(buffer, fileLength);
+	WriteResourcePackHeader(packedFile, entries);
 
-		delete [] buffer;
+	//Write files, in the order of the table of contents
+	for(vector<ResourceInfo>::const_iterator resourceIterator = resources.begin();
+		resourceIterator != resources.end();
+		resourceIterator++)
+	{
+		vector<char> file = ReadFile(resourceIterator->source);
+
+		if(!file.empty())
+		{
+			packedFile.write(&file[0], file.size());
+		}
 	}
 
 	packedFile.flush();
@@ -1,4 +1,4 @@
-/*
+/*
 	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
 
 	This software is provided 'as-is', without any express or
@@ -19,7 +19,7 @@
 	   and must not be misrepresented as being the original software.
 
 	3. This notice may not be removed or altered from any
-	   source distribution.
+	   source distribution.
 */
 
 #ifndef RESOURCE_PIPELINE_SINGLETON_H
@@ -37,18 +37,32 @@ class ResourcePipelineSingleton
 
 	public:
 	#ifdef DEBUG
-		static SDLResourcePipeline<FolderResourceTrunk>& GetInstance() 
+		typedef SDLResourcePipeline<FolderResourceTrunk> PipelineType;
+	#else
+		typedef SDLResourcePipeline<MappedFileResourceTrunk> PipelineType;
+	#endif
+
+		static PipelineType& GetInstance() 
 		{
-			static SDLResourcePipeline<FolderResourceTrunk> instance;
+			static PipelineType instance;
 			return instance;
 		}
-	#else
-		static SDLResourcePipeline<FileResourceTrunk>& GetInstance() 
+};
+
+/*
+	Class: LoadedTrunkDispatcher
+
+	Hands the trunks which were loaded in the background to the pipeline once a frame, when
+	it is registered as a frame handler of the <SDLInstance>. Since the pipeline can only be
+	created once SDL has been initialized, it is not looked up until the first frame is run.
+*/
+class LoadedTrunkDispatcher
+{
+	public:
+		void DispatchLoadedTrunks()
 		{
-			static SDLResourcePipeline<FileResourceTrunk> instance;
-			return instance;
+			ResourcePipelineSingleton::GetInstance().DispatchLoadedTrunks();
 		}
-	#endif
 };
 
 #endif
\ No newline at end of file
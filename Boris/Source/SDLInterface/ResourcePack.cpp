@@ -0,0 +1,405 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/ResourcePack.h>
+
+#include <sstream>
+#include <streambuf>
+
+using namespace std;
+using namespace SDLInterfaceLibrary;
+
+//Limits which are implied by the sizes of the fields of the table of contents.
+const Uint64 MAXIMUM_NAME_LENGTH = 0xFFFF;
+const Uint64 MAXIMUM_NUMBER_OF_ENTRIES = 0xFFFFFFFF;
+const Uint64 MAXIMUM_TABLE_SIZE = 0xFFFFFFFF;
+
+//The size of an entry of the table of contents whose name is empty: its type, name length,
+//offset, size and hash.
+const Uint64 MINIMUM_ENTRY_SIZE = 1 + 2 + 8 + 8 + 8;
+
+/*
+Class: MemoryBuffer
+
+A read only stream buffer over a block of memory, so that packs in memory can be read
+like packs on the disk without being copied.
+*/
+class MemoryBuffer: public streambuf
+{
+	public:
+		MemoryBuffer(const char* data, size_t size)
+		{
+			char* start = const_cast<char*>(data);
+			setg(start, start, start + size);
+		}
+
+	protected:
+		pos_type seekoff(off_type offset, ios_base::seekdir direction, ios_base::openmode mode)
+		{
+			char* position = gptr();
+
+			if(direction == ios_base::beg)
+			{
+				position = eback() + offset;
+			}
+			else if(direction == ios_base::cur)
+			{
+				position = gptr() + offset;
+			}
+			else if(direction == ios_base::end)
+			{
+				position = egptr() + offset;
+			}
+
+			if(!(mode & ios_base::in) || position < eback() || position > egptr())
+			{
+				return pos_type(off_type(-1));
+			}
+
+			setg(eback(), position, egptr());
+
+			return pos_type(position - eback());
+		}
+
+		pos_type seekpos(pos_type position, ios_base::openmode mode)
+		{
+			return seekoff(off_type(position), ios_base::beg, mode);
+		}
+};
+
+Uint64 SDLInterfaceLibrary::HashResourceData(const char* data, size_t size)
+{
+	Uint64 hash = 14695981039346656037ULL;
+
+	for(size_t i = 0; i < size; i++)
+	{
+		hash ^= (Uint8)data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash == 0 ? 1 : hash;
+}
+
+void SDLInterfaceLibrary::WriteLittleEndian(ostream& stream, Uint64 value, int numberOfBytes)
+{
+	for(int i = 0; i < numberOfBytes; i++)
+	{
+		stream.put((char)((value >> (8 * i)) & 0xFF));
+	}
+}
+
+Uint64 SDLInterfaceLibrary::ReadLittleEndian(istream& stream, int numberOfBytes)
+{
+	Uint64 value = 0;
+
+	for(int i = 0; i < numberOfBytes; i++)
+	{
+		int currentByte = stream.get();
+
+		if(currentByte == EOF)
+		{
+			throw ResourceException("Error in resource pack: The pack ends unexpectedly.");
+		}
+
+		value |= (Uint64)(Uint8)currentByte << (8 * i);
+	}
+
+	return value;
+}
+
+void SDLInterfaceLibrary::WriteResourcePackHeader(ostream& stream, vector<ResourcePackEntry>& entries)
+{
+	if(entries.size() > MAXIMUM_NUMBER_OF_ENTRIES)
+	{
+		throw ResourceException("Error in resource pack: Too many resources to pack.");
+	}
+
+	Uint64 tableSize = 0;
+
+	for(vector<ResourcePackEntry>::const_iterator currentEntry = entries.begin();
+		currentEntry != entries.end();
+		currentEntry++)
+	{
+		if(currentEntry->name.size() > MAXIMUM_NAME_LENGTH)
+		{
+			stringstream error;
+
+			error << "Error in resource pack: ";
+			error << "The name of '" << currentEntry->name.substr(0, 32) << "...' is too long.";
+
+			throw ResourceException(error.str().c_str());
+		}
+
+		tableSize += MINIMUM_ENTRY_SIZE + currentEntry->name.size();
+	}
+
+	if(tableSize > MAXIMUM_TABLE_SIZE)
+	{
+		throw ResourceException("Error in resource pack: Too many resources to pack.");
+	}
+
+	Uint64 offset = RESOURCE_PACK_HEADER_SIZE + tableSize;
+
+	stream.write(RESOURCE_PACK_SIGNATURE, sizeof(RESOURCE_PACK_SIGNATURE));
+	WriteLittleEndian(stream, RESOURCE_PACK_VERSION, 1);
+	WriteLittleEndian(stream, 0, 3);
+	WriteLittleEndian(stream, entries.size(), 4);
+	WriteLittleEndian(stream, tableSize, 4);
+
+	for(vector<ResourcePackEntry>::iterator currentEntry = entries.begin();
+		currentEntry != entries.end();
+		currentEntry++)
+	{
+		currentEntry->offset = offset;
+		offset += currentEntry->size;
+
+		WriteLittleEndian(stream, currentEntry->type, 1);
+		WriteLittleEndian(stream, currentEntry->name.size(), 2);
+		stream.write(currentEntry->name.data(), currentEntry->name.size());
+		WriteLittleEndian(stream, currentEntry->offset, 8);
+		WriteLittleEndian(stream, currentEntry->size, 8);
+		WriteLittleEndian(stream, currentEntry->hash, 8);
+	}
+}
+
+ResourcePackIndex::ResourcePackIndex()
+{
+	version = 0;
+}
+
+void ResourcePackIndex::Read(istream& packFile, const string& packName)
+{
+	entries.clear();
+	entryPositions.clear();
+	version = 0;
+
+	if(!packFile)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": The file could not be opened.";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	char signature[sizeof(RESOURCE_PACK_SIGNATURE)];
+	packFile.read(signature, sizeof(signature));
+
+	if(packFile.gcount() == sizeof(signature) &&
+		string(signature, sizeof(signature)) == string(RESOURCE_PACK_SIGNATURE, sizeof(RESOURCE_PACK_SIGNATURE)))
+	{
+		ReadVersion2(packFile, packName);
+	}
+	else
+	{
+		packFile.clear();
+		packFile.seekg(0, ios_base::beg);
+
+		ReadVersion1(packFile, packName, (int)ReadLittleEndian(packFile, 1));
+	}
+
+	//The data of every resource has to lie within the pack.
+	packFile.clear();
+	packFile.seekg(0, ios_base::end);
+
+	Uint64 packSize = (Uint64)packFile.tellg();
+
+	for(vector<ResourcePackEntry>::const_iterator currentEntry = entries.begin();
+		currentEntry != entries.end();
+		currentEntry++)
+	{
+		if(currentEntry->offset > packSize || currentEntry->size > packSize - currentEntry->offset)
+		{
+			stringstream error;
+
+			error << "Error in trunk " << packName << ": ";
+			error << "Resource '" << currentEntry->name << "' lies past the end of the file.";
+
+			throw ResourceException(error.str().c_str());
+		}
+	}
+}
+
+void ResourcePackIndex::Read(const char* pack, size_t packSize, const string& packName)
+{
+	MemoryBuffer packBuffer(pack, packSize);
+	istream packStream(&packBuffer);
+
+	Read(packStream, packName);
+}
+
+void ResourcePackIndex::ReadVersion1(istream& packFile, const string& packName, int numberOfFiles)
+{
+	for(int i = 0; i < numberOfFiles; i++)
+	{
+		ResourcePackEntry entry;
+
+		entry.type = (ResourceType)ReadLittleEndian(packFile, 1);
+
+		int nameLength = (int)ReadLittleEndian(packFile, 1);
+		entry.name.resize(nameLength);
+		packFile.read(&entry.name[0], nameLength);
+
+		//The length of each file is written as text, right before the file.
+		int fileLength = -1;
+		packFile >> fileLength;
+
+		if(!packFile || fileLength < 0)
+		{
+			stringstream error;
+
+			error << "Error in trunk " << packName << ": ";
+			error << "The length of resource '" << entry.name << "' could not be read.";
+
+			throw ResourceException(error.str().c_str());
+		}
+
+		entry.offset = (Uint64)packFile.tellg();
+		entry.size = fileLength;
+		entry.hash = 0;
+
+		AddEntry(entry, packName);
+
+		packFile.seekg(fileLength, ios_base::cur);
+	}
+
+	version = 1;
+}
+
+void ResourcePackIndex::ReadVersion2(istream& packFile, const string& packName)
+{
+	int packVersion = (int)ReadLittleEndian(packFile, 1);
+
+	if(packVersion != RESOURCE_PACK_VERSION)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": ";
+		error << "Version " << packVersion << " of the pack format is not supported.";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	ReadLittleEndian(packFile, 3);
+
+	Uint64 numberOfEntries = ReadLittleEndian(packFile, 4);
+	Uint64 tableSize = ReadLittleEndian(packFile, 4);
+
+	istream::pos_type tableStart = packFile.tellg();
+	packFile.seekg(0, ios_base::end);
+	Uint64 packSize = (Uint64)packFile.tellg();
+	packFile.seekg(tableStart);
+
+	//Both numbers come from the file, so they are checked against each other and against the
+	//size of the pack before any room is set aside for the entries.
+	if(tableSize > packSize - RESOURCE_PACK_HEADER_SIZE || numberOfEntries > tableSize / MINIMUM_ENTRY_SIZE)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": ";
+		error << "The table of contents lists " << numberOfEntries << " resources in " << tableSize;
+		error << " bytes, which do not fit in the pack.";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	entries.reserve((size_t)numberOfEntries);
+
+	for(Uint64 i = 0; i < numberOfEntries; i++)
+	{
+		ResourcePackEntry entry;
+
+		entry.type = (ResourceType)ReadLittleEndian(packFile, 1);
+
+		size_t nameLength = (size_t)ReadLittleEndian(packFile, 2);
+		entry.name.resize(nameLength);
+		packFile.read(&entry.name[0], nameLength);
+
+		entry.offset = ReadLittleEndian(packFile, 8);
+		entry.size = ReadLittleEndian(packFile, 8);
+		entry.hash = ReadLittleEndian(packFile, 8);
+
+		AddEntry(entry, packName);
+	}
+
+	if((Uint64)packFile.tellg() != RESOURCE_PACK_HEADER_SIZE + tableSize)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": ";
+		error << "The table of contents is not of the size given in the header.";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	version = RESOURCE_PACK_VERSION;
+}
+
+void ResourcePackIndex::AddEntry(const ResourcePackEntry& entry, const string& packName)
+{
+	if(entry.type != RESOURCE_TYPE_IMAGE && entry.type != RESOURCE_TYPE_MUSIC && entry.type != RESOURCE_TYPE_SOUND)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": ";
+		error << "Resource '" << entry.name << "' is of unknown type " << (int)entry.type << ".";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	if(!entryPositions.insert(make_pair(make_pair(entry.type, entry.name), entries.size())).second)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << packName << ": ";
+		error << "Resource '" << entry.name << "' is listed twice.";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	entries.push_back(entry);
+}
+
+int ResourcePackIndex::GetVersion() const
+{
+	return version;
+}
+
+const vector<ResourcePackEntry>& ResourcePackIndex::GetEntries() const
+{
+	return entries;
+}
+
+const ResourcePackEntry* ResourcePackIndex::Find(ResourceType type, const string& name) const
+{
+	map< pair<ResourceType, string>, size_t >::const_iterator entryPosition =
+		entryPositions.find(make_pair(type, name));
+
+	if(entryPosition == entryPositions.end())
+	{
+		return NULL;
+	}
+
+	return &entries[entryPosition->second];
+}
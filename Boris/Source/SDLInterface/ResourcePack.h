@@ -0,0 +1,241 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef RESOURCE_PACK_H
+#define RESOURCE_PACK_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <utility>
+
+#include <SDL/SDL_stdinc.h>
+
+#include <SDLInterface/ResourceException.h>
+
+using namespace std;
+
+/*
+	File: ResourcePack.h
+	Contains the layout of the files written by the resource packer, and the index used
+	to find the resources within them.
+*/
+namespace SDLInterfaceLibrary
+{
+	/*
+		Enum: ResourceType
+
+		Used to identify the type of a resource.
+
+		RESOURCE_TYPE_IMAGE - Image resource
+		RESOURCE_TYPE_MUSIC - Music resource
+		RESOURCE_TYPE_SOUND - Sound resource
+	*/
+	enum ResourceType
+	{
+		RESOURCE_TYPE_IMAGE,
+		RESOURCE_TYPE_MUSIC,
+		RESOURCE_TYPE_SOUND
+	};
+
+	/*
+		Constants: Resource Pack Format
+
+		A version 2 pack starts with a header of RESOURCE_PACK_HEADER_SIZE bytes, which is
+		followed by a table of contents and then by the data of every resource. All numbers
+		are unsigned and little endian.
+
+			bytes 0 - 3: RESOURCE_PACK_SIGNATURE.
+			byte 4: Version, which is RESOURCE_PACK_VERSION.
+			bytes 5 - 7: Reserved, zero.
+			bytes 8 - 11: Number of entries in the table of contents. :- numberOfEntries
+			bytes 12 - 15: Size of the table of contents, in bytes.
+
+		For each of the numberOfEntries entries:
+
+			byte 0: Filetype. 0 == Bitmap, 1 == Music File, 2 == Sound file
+			bytes 1 - 2: Number of characters in file name. :- nameLength
+			bytes 3 - nameLength + 2: Filename.
+			next 8 bytes: Offset of the file from the start of the pack.
+			next 8 bytes: Number of bytes in file.
+			next 8 bytes: Hash of the file, see <HashResourceData>.
+
+		Version 1 packs have no header, and are described in <FileResourceTrunk>.
+
+		RESOURCE_PACK_SIGNATURE - The characters which open a version 2 pack. Since the first
+								  byte of a version 1 pack is its number of files, which is
+								  followed by a type of 0 to 2, the two cannot be confused.
+		RESOURCE_PACK_VERSION - The version which the packer writes.
+		RESOURCE_PACK_HEADER_SIZE - The size of the header of a version 2 pack.
+	*/
+	const char RESOURCE_PACK_SIGNATURE[4] = {'B', 'R', 'T', 'K'};
+	const Uint8 RESOURCE_PACK_VERSION = 2;
+	const int RESOURCE_PACK_HEADER_SIZE = 16;
+
+	/*
+		Struct: ResourcePackEntry
+
+		Describes where a resource lies within a pack.
+
+		type - The type of the resource.
+		name - The name of the resource.
+		offset - The position of the first byte of the resource, from the start of the pack.
+		size - The number of bytes in the resource.
+		hash - The hash of the resource, or 0 if the pack does not store one.
+	*/
+	struct ResourcePackEntry
+	{
+		ResourceType type;
+		string name;
+		Uint64 offset;
+		Uint64 size;
+		Uint64 hash;
+	};
+
+	/*
+		Function: HashResourceData
+
+		Returns:
+			The 64 bit FNV-1a hash of [size] bytes at [data]. It is never 0, so that 0 can
+			stand for a missing hash.
+	*/
+	Uint64 HashResourceData(const char* data, size_t size);
+
+	/*
+		Function: WriteLittleEndian
+
+		Writes the lowest [numberOfBytes] bytes of [value] to [stream], least significant first.
+	*/
+	void WriteLittleEndian(ostream& stream, Uint64 value, int numberOfBytes);
+
+	/*
+		Function: ReadLittleEndian
+
+		Reads a number of [numberOfBytes] bytes from [stream], which was written by
+		<WriteLittleEndian>.
+
+		Throws:
+			ResourceException - If the stream ends first.
+	*/
+	Uint64 ReadLittleEndian(istream& stream, int numberOfBytes);
+
+	/*
+		Function: WriteResourcePackHeader
+
+		Writes the header and the table of contents of a version 2 pack, which lists [entries],
+		to [stream]. The offsets of [entries] are set to follow each other, in order, from the
+		end of the table of contents. The data of the resources should be written after it, in
+		the same order.
+
+		Throws:
+			ResourceException - If a name is too long to be stored, or there are too many
+								resources for the header to describe.
+	*/
+	void WriteResourcePackHeader(ostream& stream, vector<ResourcePackEntry>& entries);
+
+	/*
+		Class: ResourcePackIndex
+
+		The table of contents of a pack, which gives the position of every resource in it so
+		that each can be read on its own. Both versions of the format are read; for version 1
+		packs the data is skipped over to find where each resource lies, and no hashes are known.
+	*/
+	class ResourcePackIndex
+	{
+		private:
+			//The entries of the pack, in the order they are stored in.
+			vector<ResourcePackEntry> entries;
+			//The position of each entry in entries, by type and name.
+			map< pair<ResourceType, string>, size_t > entryPositions;
+			//The version of the pack.
+			int version;
+
+			//Reads the entries of a version 1 pack, whose first byte has already been read.
+			void ReadVersion1(istream& packFile, const string& packName, int numberOfFiles);
+			//Reads the entries of a version 2 pack, whose signature has already been read.
+			void ReadVersion2(istream& packFile, const string& packName);
+			//Adds [entry] to the index.
+			void AddEntry(const ResourcePackEntry& entry, const string& packName);
+
+		public:
+			/*
+				Constructor: ResourcePackIndex
+
+				Creates an empty index.
+			*/
+			ResourcePackIndex();
+			/*
+				Function: Read
+
+				Replaces the contents of the index with those of the pack in [packFile], which
+				must be open in binary mode and positioned at the start of the pack.
+
+				Parameters:
+					packFile - The pack.
+					packName - The name of the pack, used in error messages.
+
+				Throws:
+					ResourceException - If the pack is truncated, of an unknown version, has a
+										table of contents which does not match its header, or
+										lists a resource twice.
+			*/
+			void Read(istream& packFile, const string& packName);
+			/*
+				Function: Read
+
+				Replaces the contents of the index with those of the pack of [packSize] bytes
+				at [pack], such as a pack which has been mapped into memory.
+
+				Throws:
+					ResourceException - As above.
+			*/
+			void Read(const char* pack, size_t packSize, const string& packName);
+			/*
+				Function: GetVersion
+
+				Returns:
+					The version of the pack which was read, or 0 if none was.
+			*/
+			int GetVersion() const;
+			/*
+				Function: GetEntries
+
+				Returns:
+					Every entry of the pack, in the order they are stored in.
+			*/
+			const vector<ResourcePackEntry>& GetEntries() const;
+			/*
+				Function: Find
+
+				Returns:
+					The entry of the resource [name] of type [type], or NULL if the pack does not
+					contain it.
+			*/
+			const ResourcePackEntry* Find(ResourceType type, const string& name) const;
+	};
+}
+
+#endif
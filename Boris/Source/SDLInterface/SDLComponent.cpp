@@ -25,6 +25,7 @@
 #include <SDLInterface/SDLEffects.h>
 #include <SDLInterface/SDLComponent.h>
 #include <SDLInterface/SDLForm.h>
+#include <SDLInterface/SDLInstance.h>
 
 using namespace SDLInterfaceLibrary;
 
@@ -56,6 +57,8 @@ void SDLComponent::Blit()
 			throw SDLException();
 		}
 
+		AddDamage(offset);
+
 		previousOffsetToOrigin = Vector2D<int>(GetLeftFromOrigin() + effectOffsetX, GetTopFromOrigin() + effectOffsetY);
 
 		//The following two conditionals are a safety catch to prevent the
@@ -71,13 +74,6 @@ void SDLComponent::Blit()
 		}
 
 		previousDimensions = Dimensions2D<int>(GetLeftFromParent(), GetTopFromParent(), imageToUpdate->w, imageToUpdate->h);
-
-		//In the case of effects, the drawn image must be cleared because it will
-		//not be used again.
-		if(currentEffect != NULL)
-		{
-			SDL_FreeSurface(imageToUpdate);
-		}
 	}
 }
 
@@ -106,6 +102,8 @@ void SDLComponent::Clear()
 		{
 			throw SDLException();
 		}
+
+		AddDamage(offset);
 	}
 }
 
@@ -286,6 +284,14 @@ GenericEventHandlerCollection& SDLComponent::GetDrawFinishHandlers()
 	return drawFinishHandlers;
 }
 
+void SDLComponent::AddDamage(const SDL_Rect& area, int numberOfBlits)
+{
+	SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+	sdlInstance.GetDamageList().Add(area);
+	sdlInstance.CountBlits(numberOfBlits);
+}
+
 SDL_Surface* SDLComponent::GetScreen() const
 {
 	if(parent == NULL)
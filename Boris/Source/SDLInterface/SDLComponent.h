@@ -110,6 +110,23 @@ namespace SDLInterfaceLibrary
 				an error if it isn't.
 			*/
 			void ConfirmPositionInParent();
+			/*
+				Function: AddDamage
+
+				Informs the SDLInstance that [area] of the screen has been drawn on, so that
+				it is presented at the end of the frame. Must be called after every blit
+				to the screen.
+
+				Parameters:
+					area - The area of the screen which was drawn on.
+
+					numberOfBlits - The number of blits it took to draw [area]. See
+									<SDLInstance::GetBlitsLastFrame>.
+
+				See Also:
+					<SDLInstance::Run>
+			*/
+			void AddDamage(const SDL_Rect& area, int numberOfBlits = 1);
 
 		public:
 
@@ -0,0 +1,150 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLDamageList.h>
+
+using namespace SDLInterfaceLibrary;
+
+bool SDLDamageList::Adjoin(const SDL_Rect& first, const SDL_Rect& second)
+{
+	return first.x <= second.x + second.w && second.x <= first.x + first.w &&
+		first.y <= second.y + second.h && second.y <= first.y + first.h;
+}
+
+SDL_Rect SDLDamageList::Union(const SDL_Rect& first, const SDL_Rect& second)
+{
+	int left = (first.x < second.x)? first.x: second.x;
+	int top = (first.y < second.y)? first.y: second.y;
+
+	int right = (first.x + first.w > second.x + second.w)? first.x + first.w: second.x + second.w;
+	int bottom = (first.y + first.h > second.y + second.h)? first.y + first.h: second.y + second.h;
+
+	SDL_Rect unionRect;
+
+	unionRect.x = left;
+	unionRect.y = top;
+	unionRect.w = right - left;
+	unionRect.h = bottom - top;
+
+	return unionRect;
+}
+
+void SDLDamageList::Add(const SDL_Rect& area)
+{
+	if(area.w > 0 && area.h > 0)
+	{
+		areas.push_back(area);
+	}
+}
+
+void SDLDamageList::Merge(const Bounds2D<int>& screenSize)
+{
+	vector<SDL_Rect> clippedAreas;
+
+	for(unsigned int i = 0; i < areas.size(); i++)
+	{
+		int left = (areas[i].x > 0)? areas[i].x: 0;
+		int top = (areas[i].y > 0)? areas[i].y: 0;
+
+		int right = (areas[i].x + areas[i].w < screenSize.width)? areas[i].x + areas[i].w: screenSize.width;
+		int bottom = (areas[i].y + areas[i].h < screenSize.height)? areas[i].y + areas[i].h: screenSize.height;
+
+		if(right > left && bottom > top)
+		{
+			SDL_Rect clippedArea;
+
+			clippedArea.x = left;
+			clippedArea.y = top;
+			clippedArea.w = right - left;
+			clippedArea.h = bottom - top;
+
+			clippedAreas.push_back(clippedArea);
+		}
+	}
+
+	//Merging two areas can make their union adjoin an area which was already checked,
+	//so keep going until a full pass merges nothing.
+	bool merged = true;
+
+	while(merged)
+	{
+		merged = false;
+
+		for(unsigned int i = 0; i < clippedAreas.size(); i++)
+		{
+			for(unsigned int j = i + 1; j < clippedAreas.size();)
+			{
+				if(Adjoin(clippedAreas[i], clippedAreas[j]))
+				{
+					clippedAreas[i] = Union(clippedAreas[i], clippedAreas[j]);
+					clippedAreas.erase(clippedAreas.begin() + j);
+
+					merged = true;
+				}
+				else
+				{
+					j++;
+				}
+			}
+		}
+	}
+
+	areas.swap(clippedAreas);
+}
+
+const vector<SDL_Rect>& SDLDamageList::GetAreas() const
+{
+	return areas;
+}
+
+bool SDLDamageList::Intersects(const SDL_Rect& area) const
+{
+	for(unsigned int i = 0; i < areas.size(); i++)
+	{
+		if(area.x < areas[i].x + areas[i].w && areas[i].x < area.x + area.w &&
+			area.y < areas[i].y + areas[i].h && areas[i].y < area.y + area.h)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int SDLDamageList::GetNumberOfPixels() const
+{
+	int numberOfPixels = 0;
+
+	for(unsigned int i = 0; i < areas.size(); i++)
+	{
+		numberOfPixels += areas[i].w * areas[i].h;
+	}
+
+	return numberOfPixels;
+}
+
+void SDLDamageList::Clear()
+{
+	areas.clear();
+}
@@ -0,0 +1,107 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_DAMAGE_LIST_H
+#define SDL_DAMAGE_LIST_H
+
+#include <vector>
+
+#include <SDL/SDL.h>
+
+#include <Helpers/GeometricStructures2D.h>
+
+using std::vector;
+using namespace Helpers;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLDamageList
+
+		Collects the areas of the screen which were drawn on during a frame, so that only
+		those areas need to be presented.
+
+		See Also:
+			<SDLInstance::Run>
+	*/
+	class SDLDamageList
+	{
+		private:
+			vector<SDL_Rect> areas;
+
+			//Returns true if the two rectangles overlap or touch.
+			static bool Adjoin(const SDL_Rect& first, const SDL_Rect& second);
+			//Returns the smallest rectangle which contains both rectangles.
+			static SDL_Rect Union(const SDL_Rect& first, const SDL_Rect& second);
+		public:
+			/*
+				Function: Add
+
+				Parameters:
+					area - An area of the screen which has been drawn on. It may lie partly
+						   outside the screen.
+			*/
+			void Add(const SDL_Rect& area);
+			/*
+				Function: Merge
+
+				Clips every area to the screen, and merges those which overlap or touch
+				into their bounding rectangle, until no two areas adjoin.
+
+				Parameters:
+					screenSize - The size of the screen.
+			*/
+			void Merge(const Bounds2D<int>& screenSize);
+			/*
+				Function: GetAreas
+
+				Returns:
+					The areas collected so far. Call <SDLDamageList::Merge> first in order
+					to get them clipped and merged.
+			*/
+			const vector<SDL_Rect>& GetAreas() const;
+			/*
+				Function: Intersects
+
+				Returns:
+					True if [area] overlaps any of the areas collected so far.
+			*/
+			bool Intersects(const SDL_Rect& area) const;
+			/*
+				Function: GetNumberOfPixels
+
+				Returns:
+					The sum of the sizes, in pixels, of the areas in the list.
+			*/
+			int GetNumberOfPixels() const;
+			/*
+				Function: Clear
+
+				Empties the list.
+			*/
+			void Clear();
+	};
+}
+
+#endif
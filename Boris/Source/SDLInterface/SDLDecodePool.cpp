@@ -0,0 +1,192 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLDecodePool.h>
+
+#include <exception>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace SDLInterfaceLibrary;
+
+int SDLDecodePool::GetNumberOfProcessors()
+{
+#ifdef _WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	int numberOfProcessors = (int)systemInfo.dwNumberOfProcessors;
+#else
+	int numberOfProcessors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	return numberOfProcessors > 0 ? numberOfProcessors : 1;
+}
+
+SDLDecodePool::SDLDecodePool(const ISDLResourceTrunk& trunk, const vector< pair<ResourceType, string> >& resourceList):
+	trunk(trunk),
+	resourceList(resourceList),
+	decodedResources(resourceList.size()),
+	resourcesDecoded(resourceList.size(), false)
+{
+	nextResource = 0;
+	cancelled = false;
+}
+
+int SDLDecodePool::RunThread(void* decodePool)
+{
+	((SDLDecodePool*)decodePool)->DecodeResources();
+
+	return 0;
+}
+
+void SDLDecodePool::DecodeResources()
+{
+	while(true)
+	{
+		size_t currentResource = 0;
+
+		{
+			SDLMutexLock poolHeld(poolLock);
+
+			if(cancelled || !error.empty() || nextResource == resourceList.size())
+			{
+				return;
+			}
+
+			currentResource = nextResource++;
+		}
+
+		DecodedResource resource;
+
+		try
+		{
+			trunk.Decode(resourceList[currentResource].first, resourceList[currentResource].second, resource);
+		}
+		catch(exception& decodeException)
+		{
+			SDLMutexLock poolHeld(poolLock);
+
+			if(error.empty())
+			{
+				error = decodeException.what();
+			}
+
+			return;
+		}
+
+		SDLMutexLock poolHeld(poolLock);
+
+		decodedResources[currentResource] = resource;
+		resourcesDecoded[currentResource] = true;
+	}
+}
+
+void SDLDecodePool::Run(int numberOfThreads)
+{
+	if(numberOfThreads <= 0)
+	{
+		numberOfThreads = GetNumberOfProcessors();
+	}
+
+	if((size_t)numberOfThreads > resourceList.size())
+	{
+		numberOfThreads = (int)resourceList.size();
+	}
+
+	vector<SDL_Thread*> threads;
+
+	for(int i = 1; i < numberOfThreads; i++)
+	{
+		SDL_Thread* thread = SDL_CreateThread(RunThread, this);
+
+		//If no more threads can be created, the resources are decoded by those there are.
+		if(thread == NULL)
+		{
+			break;
+		}
+
+		threads.push_back(thread);
+	}
+
+	DecodeResources();
+
+	for(vector<SDL_Thread*>::iterator thread = threads.begin();
+		thread != threads.end();
+		thread++)
+	{
+		SDL_WaitThread(*thread, NULL);
+	}
+
+	//The threads are done, so the error can be read without the lock.
+	if(!error.empty())
+	{
+		FreeResources();
+
+		throw ResourceException(error.c_str());
+	}
+}
+
+void SDLDecodePool::Cancel()
+{
+	SDLMutexLock poolHeld(poolLock);
+
+	cancelled = true;
+}
+
+void SDLDecodePool::TakeDecodedResources(vector<DecodedResource>& resources)
+{
+	SDLMutexLock poolHeld(poolLock);
+
+	for(size_t i = 0; i < decodedResources.size(); i++)
+	{
+		if(resourcesDecoded[i])
+		{
+			resources.push_back(decodedResources[i]);
+			resourcesDecoded[i] = false;
+		}
+	}
+}
+
+void SDLDecodePool::FreeResources()
+{
+	for(size_t i = 0; i < decodedResources.size(); i++)
+	{
+		if(resourcesDecoded[i])
+		{
+			FreeDecodedResource(decodedResources[i]);
+			resourcesDecoded[i] = false;
+		}
+	}
+}
+
+SDLDecodePool::~SDLDecodePool()
+{
+	FreeResources();
+}
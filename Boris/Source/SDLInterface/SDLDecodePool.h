@@ -0,0 +1,145 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_DECODE_POOL_H
+#define SDL_DECODE_POOL_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_thread.h>
+
+#include <SDLInterface/ResourceException.h>
+#include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/SDLMutex.h>
+#include <Helpers/IUncopyable.h>
+
+using namespace std;
+
+/*
+	File: SDLDecodePool.h
+	Contains the declaration of SDLDecodePool.
+*/
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLDecodePool
+
+		Decodes a list of resources from a trunk on several threads at once. Each thread takes
+		the next resource which nobody has started on, so that a few large resources do not
+		hold the others up. The decoded resources are kept in the order they were listed in,
+		whichever thread decoded them, so that they can be added to the trunk in the same order
+		every time.
+
+		The resources are only decoded; images are converted to the format of the screen by the
+		main thread when they are first requested, as usual.
+
+		See Also:
+			<ISDLResourceTrunk::Decode>
+	*/
+	class SDLDecodePool: public IUncopyable
+	{
+		private:
+			const ISDLResourceTrunk& trunk;
+			vector< pair<ResourceType, string> > resourceList;
+
+			//Held while the members below are used, since they are shared by the threads.
+			SDLMutex poolLock;
+			//The resources, in the order of resourceList, of which only those marked in
+			//resourcesDecoded are set.
+			vector<DecodedResource> decodedResources;
+			vector<bool> resourcesDecoded;
+			//The position in resourceList of the next resource which nobody has started on.
+			size_t nextResource;
+			//True if the threads should stop taking resources.
+			bool cancelled;
+			//The first error which a thread came across, if any did.
+			string error;
+
+			//The function which each thread runs, [decodePool] being the SDLDecodePool.
+			static int RunThread(void* decodePool);
+			//Decodes resources until there are none left, on the calling thread.
+			void DecodeResources();
+			//Frees every resource which has been decoded.
+			void FreeResources();
+
+		public:
+			/*
+				Function: GetNumberOfProcessors
+
+				Returns:
+					The number of processors which the machine has, or 1 if it cannot be found.
+			*/
+			static int GetNumberOfProcessors();
+			/*
+				Constructor: SDLDecodePool
+
+				Parameters:
+					trunk - The trunk which the resources will be decoded from. Its resources must
+							have been loaded.
+					resourceList - The type and name of every resource which will be decoded.
+			*/
+			SDLDecodePool(const ISDLResourceTrunk& trunk, const vector< pair<ResourceType, string> >& resourceList);
+			/*
+				Function: Run
+
+				Decodes the resources, and returns once they have all been decoded or the pool has
+				been cancelled. The calling thread decodes resources too, so no more than
+				[numberOfThreads] - 1 threads are created.
+
+				Parameters:
+					numberOfThreads - How many threads decode at once. If it is 0 or less, there
+									  is one thread for every processor.
+
+				Throws:
+					ResourceException - If a resource could not be decoded. Those which were
+										decoded are freed.
+			*/
+			void Run(int numberOfThreads);
+			/*
+				Function: Cancel
+
+				Makes the threads stop once they have decoded the resources they are on. It can
+				be called from any thread.
+			*/
+			void Cancel();
+			/*
+				Function: TakeDecodedResources
+
+				Appends the resources which were decoded to [resources], in the order they were
+				listed in. They then belong to the caller, and the pool no longer frees them.
+			*/
+			void TakeDecodedResources(vector<DecodedResource>& resources);
+			/*
+				Destructor: ~SDLDecodePool
+
+				Frees the resources which were decoded but not taken.
+			*/
+			~SDLDecodePool();
+	};
+}
+
+#endif
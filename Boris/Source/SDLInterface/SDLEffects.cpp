@@ -22,8 +22,11 @@
 	   source distribution.
 */
 
+#include <cmath>
+
 #include <SDLInterface/SDLEffects.h>
 #include <SDLInterface/SDLComponent.h>
+#include <SDLInterface/SDLException.h>
 
 using namespace SDLInterfaceLibrary;
 
@@ -37,6 +40,32 @@ LoomEffect::LoomEffect(double rateOfIncrease, double maxSize)
 {
 	this->rateOfIncrease = rateOfIncrease;
 	this->maxSize = maxSize;
+
+	//A step no larger than the rate of increase keeps every scale drawn within half a
+	//step of the one it would have been drawn at.
+	if(maxSize == 1)
+	{
+		numberOfSteps = 0;
+	}
+	else if(rateOfIncrease <= 0 || fabs(maxSize - 1) / rateOfIncrease >= MAXIMUM_NUMBER_OF_STEPS)
+	{
+		numberOfSteps = MAXIMUM_NUMBER_OF_STEPS;
+	}
+	else
+	{
+		numberOfSteps = (int)ceil(fabs(maxSize - 1) / rateOfIncrease);
+	}
+
+	numberOfCachedImages = 0;
+	cacheSize = 0;
+}
+
+LoomEffect::~LoomEffect()
+{
+	while(!scaledImages.empty())
+	{
+		ReleaseEntry(scaledImages.begin());
+	}
 }
 
 ISDLEffectInfo* LoomEffect::GetEffectInfo() const
@@ -74,7 +103,7 @@ SDL_Surface* LoomEffect::GetEffectImage(SDLComponent* target, int& effectOffsetX
 		}
 	}
 
-	SDL_Surface* newImage = zoomSurface(targetImage, info->currentSize, info->currentSize, 1);
+	SDL_Surface* newImage = GetScaledImage(targetImage, GetStep(info->currentSize));
 
 	effectOffsetX = -(newImage->w - targetImage->w)/2;
 	effectOffsetY = -(newImage->h - targetImage->h)/2;
@@ -83,3 +112,109 @@ SDL_Surface* LoomEffect::GetEffectImage(SDLComponent* target, int& effectOffsetX
 
 	return newImage;
 }
+
+int LoomEffect::GetStep(double scale) const
+{
+	if(numberOfSteps == 0)
+	{
+		return 0;
+	}
+
+	int step = (int)floor((scale - 1) / (maxSize - 1) * numberOfSteps + 0.5);
+
+	if(step < 0)
+	{
+		return 0;
+	}
+	else if(step > numberOfSteps)
+	{
+		return numberOfSteps;
+	}
+
+	return step;
+}
+
+SDL_Surface* LoomEffect::GetScaledImage(SDL_Surface* sourceImage, int step) const
+{
+	map< SDL_Surface*, vector<SDL_Surface*> >::iterator entry = scaledImages.find(sourceImage);
+
+	if(entry != scaledImages.end() && entry->second[step] != NULL)
+	{
+		return entry->second[step];
+	}
+
+	double scale = 1;
+
+	if(numberOfSteps != 0)
+	{
+		scale = 1 + (maxSize - 1) * step / numberOfSteps;
+	}
+
+	SDL_Surface* scaledImage = zoomSurface(sourceImage, scale, scale, 1);
+
+	if(scaledImage == NULL)
+	{
+		throw SDLException();
+	}
+
+	if(entry == scaledImages.end())
+	{
+		entry = scaledImages.insert(make_pair(sourceImage, vector<SDL_Surface*>(numberOfSteps + 1, (SDL_Surface*)NULL))).first;
+		sourceImage->refcount++;
+	}
+
+	entry->second[step] = scaledImage;
+
+	numberOfCachedImages++;
+	cacheSize += scaledImage->pitch * scaledImage->h;
+
+	TrimCache(sourceImage);
+
+	return scaledImage;
+}
+
+void LoomEffect::ReleaseEntry(map< SDL_Surface*, vector<SDL_Surface*> >::iterator entry) const
+{
+	for(vector<SDL_Surface*>::iterator currentImage = entry->second.begin();
+		currentImage != entry->second.end(); currentImage++)
+	{
+		if(*currentImage != NULL)
+		{
+			numberOfCachedImages--;
+			cacheSize -= (*currentImage)->pitch * (*currentImage)->h;
+
+			SDL_FreeSurface(*currentImage);
+		}
+	}
+
+	//Only decrements the reference count, unless the source's owner has already freed it.
+	SDL_FreeSurface(entry->first);
+
+	scaledImages.erase(entry);
+}
+
+void LoomEffect::TrimCache(SDL_Surface* sourceImageInUse) const
+{
+	map< SDL_Surface*, vector<SDL_Surface*> >::iterator entry = scaledImages.begin();
+
+	while(entry != scaledImages.end())
+	{
+		map< SDL_Surface*, vector<SDL_Surface*> >::iterator currentEntry = entry++;
+
+		if(currentEntry->first != sourceImageInUse &&
+			(currentEntry->first->refcount == 1 || cacheSize > MAXIMUM_CACHE_SIZE))
+		{
+			ReleaseEntry(currentEntry);
+		}
+	}
+}
+
+int LoomEffect::GetNumberOfCachedImages() const
+{
+	return numberOfCachedImages;
+}
+
+int LoomEffect::GetCacheSize() const
+{
+	return cacheSize;
+}
@@ -25,10 +25,17 @@
 #ifndef SDL_EFFECTS_H
 #define SDL_EFFECTS_H
 
+#include <map>
+#include <vector>
+
 #include <SDL/SDL.h>
 #include <SDL/SDL_rotozoom.h>
 
 #include <Helpers/GeometricStructures2D.h>
+#include <Helpers/IUncopyable.h>
+
+using std::map;
+using std::vector;
 
 using namespace Helpers;
 
@@ -123,6 +130,9 @@ namespace SDLInterfaceLibrary
 						should be blitted. Ergo, the blit function must be informed
 						of this offset.
 
+				Returns:
+					The image which is blitted in place of the target's own. It belongs to
+					the effect, and must not be freed by the caller.
 
 				See Also:
 
@@ -173,12 +183,44 @@ namespace SDLInterfaceLibrary
 			<ISDLEffect>
 
 	*/
-	class LoomEffect: public ISDLEffect
+	class LoomEffect: public ISDLEffect, public IUncopyable
 	{
 		private:
 			double rateOfIncrease;
 			double maxSize;
 
+			//The number of steps between the normal scale and maxSize which the images are
+			//scaled to. Scales which fall between two steps are rounded to the nearest one.
+			int numberOfSteps;
+
+			//The scaled images of each source image, indexed by step, which are filled in
+			//as they are first needed. Each source image is kept alive by incrementing it's
+			//reference count, so that it's address cannot be reused by another image while
+			//it is in the cache.
+			mutable map< SDL_Surface*, vector<SDL_Surface*> > scaledImages;
+
+			//The number of images in scaledImages, and the number of bytes taken up by their
+			//pixels.
+			mutable int numberOfCachedImages;
+			mutable int cacheSize;
+
+			//Returns the index of the step nearest to [scale].
+			int GetStep(double scale) const;
+
+			//Returns [sourceImage] scaled to the given step, scaling and caching it if it
+			//hasn't been already.
+			SDL_Surface* GetScaledImage(SDL_Surface* sourceImage, int step) const;
+
+			//Frees the scaled images of the source image which [entry] points to, and
+			//releases the source image itself.
+			void ReleaseEntry(map< SDL_Surface*, vector<SDL_Surface*> >::iterator entry) const;
+
+			//Releases the source images which nothing but the cache refers to any longer,
+			//such as the old images of a text component whose text has changed. If the
+			//cache is still larger than MAXIMUM_CACHE_SIZE, the images of every source other
+			//than [sourceImageInUse] are released as well.
+			void TrimCache(SDL_Surface* sourceImageInUse) const;
+
 		public:
 			/*
 				Constructor: LoomEffect
@@ -191,8 +233,39 @@ namespace SDLInterfaceLibrary
 			*/
 			LoomEffect(double rateOfIncrease, double maxSize);
 
+			/*
+				Constants:
+
+				MAXIMUM_NUMBER_OF_STEPS - The most steps which the scale is divided into,
+				whatever the rate of increase.
+
+				MAXIMUM_CACHE_SIZE - The number of bytes of scaled images above which the
+				images of sources which are not being drawn are discarded.
+			*/
+			static const int MAXIMUM_NUMBER_OF_STEPS = 64;
+			static const int MAXIMUM_CACHE_SIZE = 8 * 1024 * 1024;
+
 			ISDLEffectInfo* GetEffectInfo() const;
 			SDL_Surface* GetEffectImage(SDLComponent* target, int& effectOffsetX, int& effectOffsetY) const;
+
+			/*
+				Function: GetNumberOfCachedImages
+
+				Returns:
+					The number of scaled images which are currently cached, across all the
+					components which this effect is applied to.
+			*/
+			int GetNumberOfCachedImages() const;
+			/*
+				Function: GetCacheSize
+
+				Returns:
+					The number of bytes taken up by the pixels of the scaled images which are
+					currently cached.
+			*/
+			int GetCacheSize() const;
+
+			~LoomEffect();
 	};
 }
 
@@ -32,6 +32,7 @@ SDLForm::SDLForm(const string& name, const Vector2D<int>& position, SDL_Surface*
 	SDLComponent(name, position, image)
 	{
 		componentWithFocus = NULL;
+		timersSuspended = true;
 	}
 
 
@@ -62,7 +63,30 @@ void SDLForm::RemoveChild(SDLComponent* child)
 
 void SDLForm::AddTimer(SDLTimer& timer)
 {
-	timers.push_back(&timer);
+	if(timer.GetForm() != this)
+	{
+		if(timer.GetForm() != NULL)
+		{
+			timer.GetForm()->RemoveTimer(timer);
+		}
+
+		timers.push_back(&timer);
+		timer.SetForm(this);
+
+		timer.SetSuspended(timersSuspended);
+		timer.Start();
+	}
+}
+
+void SDLForm::RemoveTimer(SDLTimer& timer)
+{
+	vector<SDLTimer*>::iterator timerToRemove = find(timers.begin(), timers.end(), &timer);
+
+	if(timerToRemove != timers.end())
+	{
+		timers.erase(timerToRemove);
+		timer.SetForm(NULL);
+	}
 }
 
 void SDLForm::Draw()
@@ -77,12 +101,14 @@ void SDLForm::Draw()
 	}
 }
 
-void SDLForm::UpdateTimers(int frameRate)
+void SDLForm::SetTimersSuspended(bool suspended)
 {
+	timersSuspended = suspended;
+
 	for(vector<SDLTimer*>::iterator currentTimer = timers.begin();
 		currentTimer != timers.end(); currentTimer++)
 	{
-		(*currentTimer)->Tick(frameRate);
+		(*currentTimer)->SetSuspended(suspended);
 	}
 }
 
@@ -152,4 +178,10 @@ SDLForm::~SDLForm()
 	{
 		(*currentChild)->SetParent(NULL);
 	}
+
+	for(vector<SDLTimer*>::iterator currentTimer = timers.begin();
+		currentTimer != timers.end(); currentTimer++)
+	{
+		(*currentTimer)->SetForm(NULL);
+	}
 }
@@ -63,6 +63,8 @@ namespace SDLInterfaceLibrary
 			vector<SDLComponent*> children;
 			//The timers currently active on this form.
 			vector<SDLTimer*> timers;
+			//True while this form does not have the focus.
+			bool timersSuspended;
 
 			//The keyevent component to which key events will be delegated to.
 			KeyEventComponent* componentWithFocus;
@@ -103,13 +105,23 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: AddTimer
 
-				Adds an SDLTimer to the timer list.
+				Adds an SDLTimer to the timer list, and starts it. The timer only runs
+				while this form has the focus.
 
 				Parameters:
 					timer - The timer to add.
 
 			*/
 			void AddTimer(SDLTimer& timer);
+			/*
+				Function: RemoveTimer
+
+				Removes an SDLTimer from the timer list. The timer is left as it is.
+
+				Parameters:
+					timer - The timer to remove.
+			*/
+			void RemoveTimer(SDLTimer& timer);
 			/*
 				Function: KeyUp
 
@@ -152,15 +164,18 @@ namespace SDLInterfaceLibrary
 			*/
 			void Draw();
 			/*
-				Function: UpdateTimers
+				Function: SetTimersSuspended
 
-				Updates the timers attached to this form.
+				Suspends, or resumes, the timers attached to this form.
 
 				Parameters:
-					frameRate - The application's current frame rate.
+					suspended - True if the form has lost the focus, false if it has
+								gained it.
 
+				See Also:
+					<SDLInstance::SetFocus>
 			*/
-			void UpdateTimers(int frameRate);
+			void SetTimersSuspended(bool suspended);
 			/*
 				Function: SetFocus
 
@@ -0,0 +1,204 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLFrameStats.h>
+
+using namespace SDLInterfaceLibrary;
+
+static const char* const PHASE_NAMES[SDL_FP_NUMBER_OF_PHASES] =
+{
+	"delay",
+	"events",
+	"timers",
+	"draw",
+	"present",
+	"frame",
+	"input_latency"
+};
+
+SDLFrameStats::SDLFrameStats()
+{
+	Clear();
+}
+
+void SDLFrameStats::Clear()
+{
+	currentFrame = 0;
+	numberOfFrames = 0;
+}
+
+void SDLFrameStats::BeginFrame()
+{
+	phaseStart = std::chrono::steady_clock::now();
+	phaseLengths[currentFrame][SDL_FP_FRAME] = 0;
+	phaseLengths[currentFrame][SDL_FP_INPUT_LATENCY] = -1;
+}
+
+void SDLFrameStats::EndPhase(SDLFramePhase phase)
+{
+	std::chrono::steady_clock::time_point phaseEnd = std::chrono::steady_clock::now();
+	int phaseLength = (int)std::chrono::duration_cast<std::chrono::microseconds>(phaseEnd - phaseStart).count();
+
+	phaseLengths[currentFrame][phase] = phaseLength;
+	phaseLengths[currentFrame][SDL_FP_FRAME] += phaseLength;
+
+	phaseStart = phaseEnd;
+}
+
+void SDLFrameStats::RecordInputLatency(const std::chrono::steady_clock::time_point& inputTime)
+{
+	phaseLengths[currentFrame][SDL_FP_INPUT_LATENCY] = (int)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - inputTime).count();
+}
+
+void SDLFrameStats::EndFrame()
+{
+	currentFrame = (currentFrame + 1) % MAXIMUM_NUMBER_OF_FRAMES;
+
+	if(numberOfFrames < MAXIMUM_NUMBER_OF_FRAMES)
+	{
+		numberOfFrames++;
+	}
+}
+
+int SDLFrameStats::GetNumberOfFrames() const
+{
+	return numberOfFrames;
+}
+
+int SDLFrameStats::GetLatest(SDLFramePhase phase) const
+{
+	if(numberOfFrames == 0)
+	{
+		return 0;
+	}
+
+	int length = phaseLengths[(currentFrame + MAXIMUM_NUMBER_OF_FRAMES - 1) % MAXIMUM_NUMBER_OF_FRAMES][phase];
+
+	return (length >= 0)? length: 0;
+}
+
+void SDLFrameStats::GetPhaseLengths(SDLFramePhase phase, vector<int>& lengths) const
+{
+	//The oldest frame is the one which will be overwritten next, once the record is full.
+	int firstFrame = (numberOfFrames < MAXIMUM_NUMBER_OF_FRAMES)? 0: currentFrame;
+
+	lengths.clear();
+	lengths.reserve(numberOfFrames);
+
+	for(int i = 0; i < numberOfFrames; i++)
+	{
+		int length = phaseLengths[(firstFrame + i) % MAXIMUM_NUMBER_OF_FRAMES][phase];
+
+		if(length >= 0)
+		{
+			lengths.push_back(length);
+		}
+	}
+}
+
+int SDLFrameStats::GetPercentile(SDLFramePhase phase, double percentile) const
+{
+	vector<int> lengths;
+	GetPhaseLengths(phase, lengths);
+
+	if(lengths.empty())
+	{
+		return 0;
+	}
+
+	int numberOfLengths = (int)lengths.size();
+
+	//Nearest rank: the smallest length which at least [percentile] percent of the frames
+	//do not exceed.
+	int rank = (int)(percentile / 100.0 * numberOfLengths + 0.999999);
+	rank = std::min(std::max(rank, 1), numberOfLengths);
+
+	std::nth_element(lengths.begin(), lengths.begin() + (rank - 1), lengths.end());
+
+	return lengths[rank - 1];
+}
+
+int SDLFrameStats::GetMaximum(SDLFramePhase phase) const
+{
+	vector<int> lengths;
+	GetPhaseLengths(phase, lengths);
+
+	if(lengths.empty())
+	{
+		return 0;
+	}
+
+	return *std::max_element(lengths.begin(), lengths.end());
+}
+
+const char* SDLFrameStats::GetPhaseName(SDLFramePhase phase)
+{
+	return PHASE_NAMES[phase];
+}
+
+bool SDLFrameStats::WriteCSV(const string& fileName) const
+{
+	std::fstream statsFile;
+	statsFile.open(fileName.c_str(), std::fstream::out | std::fstream::trunc);
+
+	if(!statsFile.is_open())
+	{
+		return false;
+	}
+
+	int firstFrame = (numberOfFrames < MAXIMUM_NUMBER_OF_FRAMES)? 0: currentFrame;
+
+	statsFile << "index";
+
+	for(int phase = 0; phase < SDL_FP_NUMBER_OF_PHASES; phase++)
+	{
+		statsFile << "," << PHASE_NAMES[phase];
+	}
+
+	statsFile << "\n";
+
+	for(int i = 0; i < numberOfFrames; i++)
+	{
+		const int* lengths = phaseLengths[(firstFrame + i) % MAXIMUM_NUMBER_OF_FRAMES];
+
+		statsFile << i;
+
+		for(int phase = 0; phase < SDL_FP_NUMBER_OF_PHASES; phase++)
+		{
+			statsFile << ",";
+
+			if(lengths[phase] >= 0)
+			{
+				statsFile << lengths[phase];
+			}
+		}
+
+		statsFile << "\n";
+	}
+
+	statsFile.close();
+
+	return !statsFile.fail();
+}
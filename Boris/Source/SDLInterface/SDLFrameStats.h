@@ -0,0 +1,198 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_FRAME_STATS_H
+#define SDL_FRAME_STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Enum: SDLFramePhase
+
+		The phases which each iteration of <SDLInstance::Run> is split into.
+
+		SDL_FP_DELAY - Waiting for the frame rate manager.
+		SDL_FP_EVENTS - Polling the SDL events, repeating the keys which are held down, and
+						dispatching them to the focused form.
+		SDL_FP_TIMERS - Advancing the timer wheel, and running the handlers of the timers
+						which fired.
+		SDL_FP_DRAW - Drawing the focused form and it's children.
+		SDL_FP_PRESENT - Presenting the damaged areas, or flipping the screen.
+		SDL_FP_FRAME - The entire frame, that is the sum of all the phases above.
+		SDL_FP_INPUT_LATENCY - Not a phase, but the time from the moment the first key
+							   event of the frame was polled to the end of SDL_FP_PRESENT.
+							   It is only recorded for frames which polled key events.
+	*/
+	enum SDLFramePhase
+	{
+		SDL_FP_DELAY,
+		SDL_FP_EVENTS,
+		SDL_FP_TIMERS,
+		SDL_FP_DRAW,
+		SDL_FP_PRESENT,
+		SDL_FP_FRAME,
+		SDL_FP_INPUT_LATENCY,
+		SDL_FP_NUMBER_OF_PHASES
+	};
+	/*
+		Class: SDLFrameStats
+
+		Records how long each phase of the last <SDLFrameStats::MAXIMUM_NUMBER_OF_FRAMES>
+		frames took, in a ring buffer which is allocated once, so that recording a frame
+		costs no more than a clock read per phase.
+
+		See Also:
+			<SDLInstance::SetFrameStatsEnabled>
+	*/
+	class SDLFrameStats
+	{
+		public:
+			/*
+				Constant: MAXIMUM_NUMBER_OF_FRAMES
+
+				The number of frames kept. Older frames are overwritten.
+			*/
+			static const int MAXIMUM_NUMBER_OF_FRAMES = 1024;
+		private:
+			//The length, in microseconds, of every phase of the recorded frames. Phases which
+			//were not recorded in a frame are -1.
+			int phaseLengths[MAXIMUM_NUMBER_OF_FRAMES][SDL_FP_NUMBER_OF_PHASES];
+
+			//The index of the frame currently being recorded.
+			int currentFrame;
+			//The number of complete frames held in phaseLengths.
+			int numberOfFrames;
+
+			//The time at which the current phase started.
+			std::chrono::steady_clock::time_point phaseStart;
+
+			//Fills [lengths] with the lengths of phase [phase] of every recorded frame, leaving
+			//out the frames which did not record it.
+			void GetPhaseLengths(SDLFramePhase phase, vector<int>& lengths) const;
+		public:
+			/*
+				Constructor: SDLFrameStats
+
+				Creates an empty record.
+			*/
+			SDLFrameStats();
+			/*
+				Function: Clear
+
+				Discards every recorded frame.
+			*/
+			void Clear();
+			/*
+				Function: BeginFrame
+
+				Starts recording a new frame, and it's first phase.
+			*/
+			void BeginFrame();
+			/*
+				Function: EndPhase
+
+				Records the time elapsed since the previous phase ended, or since the frame
+				began, as the length of [phase], and starts the next phase.
+			*/
+			void EndPhase(SDLFramePhase phase);
+			/*
+				Function: RecordInputLatency
+
+				Records the time elapsed since [inputTime] as the <SDL_FP_INPUT_LATENCY> of the
+				current frame.
+			*/
+			void RecordInputLatency(const std::chrono::steady_clock::time_point& inputTime);
+			/*
+				Function: EndFrame
+
+				Completes the current frame, overwriting the oldest one if the record is full.
+			*/
+			void EndFrame();
+			/*
+				Function: GetNumberOfFrames
+
+				Returns:
+					The number of complete frames recorded.
+			*/
+			int GetNumberOfFrames() const;
+			/*
+				Function: GetLatest
+
+				Returns:
+					The time, in microseconds, which the most recently completed frame spent
+					in [phase], or 0 if no frames were recorded or it did not record [phase].
+			*/
+			int GetLatest(SDLFramePhase phase) const;
+			/*
+				Function: GetPercentile
+
+				Parameters:
+					phase - The phase of interest.
+					percentile - A value between 0 and 100.
+
+				Returns:
+					The length, in microseconds, which [percentile] percent of the recorded
+					frames spent in [phase] at most, or 0 if no frames recorded [phase].
+			*/
+			int GetPercentile(SDLFramePhase phase, double percentile) const;
+			/*
+				Function: GetMaximum
+
+				Returns:
+					The longest time, in microseconds, which any recorded frame spent in
+					[phase], or 0 if no frames recorded [phase].
+			*/
+			int GetMaximum(SDLFramePhase phase) const;
+			/*
+				Function: GetPhaseName
+
+				Returns:
+					The name of [phase], as used by <SDLFrameStats::WriteCSV> and the lua
+					interface.
+			*/
+			static const char* GetPhaseName(SDLFramePhase phase);
+			/*
+				Function: WriteCSV
+
+				Writes every recorded frame, oldest first, to the file [fileName], one line
+				per frame and one column per phase. Phases which a frame did not record are
+				left empty.
+
+				Returns:
+					False if the file could not be written.
+			*/
+			bool WriteCSV(const string& fileName) const;
+	};
+}
+
+#endif
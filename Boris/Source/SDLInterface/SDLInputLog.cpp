@@ -0,0 +1,218 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <algorithm>
+#include <iterator>
+
+#include <SDLInterface/SDLInputLog.h>
+
+using namespace SDLInterfaceLibrary;
+
+static const char INPUT_LOG_MAGIC[4] = {'B', 'R', 'I', 'L'};
+static const Uint8 INPUT_LOG_VERSION = 1;
+static const int INPUT_LOG_HEADER_LENGTH = 9;
+
+SDLInputLog::SDLInputLog()
+{
+	recording = false;
+	replaying = false;
+	replayPosition = 0;
+	seed = 0;
+}
+
+void SDLInputLog::WriteVarint(Uint32 value)
+{
+	while(value >= 0x80)
+	{
+		recordFile.put((char)((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	recordFile.put((char)value);
+}
+
+bool SDLInputLog::ReadVarint(Uint32& value)
+{
+	value = 0;
+
+	for(int shift = 0; shift < 32 && replayPosition < replayData.size(); shift += 7)
+	{
+		Uint8 currentByte = replayData[replayPosition++];
+		value |= (Uint32)(currentByte & 0x7F) << shift;
+
+		if((currentByte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void SDLInputLog::StartRecording(const string& fileName, Uint32 seed)
+{
+	Stop();
+
+	recordFile.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if(!recordFile.is_open())
+	{
+		throw SDLInterfaceLibraryException(string("Could not create the input log " + fileName).c_str());
+	}
+
+	this->seed = seed;
+
+	recordFile.write(INPUT_LOG_MAGIC, sizeof(INPUT_LOG_MAGIC));
+	recordFile.put((char)INPUT_LOG_VERSION);
+
+	for(int i = 0; i < 4; i++)
+	{
+		recordFile.put((char)((seed >> (i * 8)) & 0xFF));
+	}
+
+	recording = true;
+}
+
+void SDLInputLog::StartReplay(const string& fileName)
+{
+	Stop();
+
+	std::ifstream replayFile(fileName.c_str(), std::ios::in | std::ios::binary);
+
+	if(!replayFile.is_open())
+	{
+		throw SDLInterfaceLibraryException(string("Could not open the input log " + fileName).c_str());
+	}
+
+	replayData.assign(std::istreambuf_iterator<char>(replayFile), std::istreambuf_iterator<char>());
+
+	if(replayData.size() < INPUT_LOG_HEADER_LENGTH ||
+		!std::equal(INPUT_LOG_MAGIC, INPUT_LOG_MAGIC + sizeof(INPUT_LOG_MAGIC), replayData.begin()) ||
+		replayData[4] != INPUT_LOG_VERSION)
+	{
+		replayData.clear();
+		throw SDLInterfaceLibraryException(string(fileName + " is not an input log").c_str());
+	}
+
+	seed = 0;
+
+	for(int i = 0; i < 4; i++)
+	{
+		seed |= (Uint32)replayData[5 + i] << (i * 8);
+	}
+
+	replayPosition = INPUT_LOG_HEADER_LENGTH;
+	replaying = true;
+}
+
+void SDLInputLog::Stop()
+{
+	if(recording)
+	{
+		recordFile.close();
+		recording = false;
+	}
+
+	replayData.clear();
+	replayPosition = 0;
+	replaying = false;
+}
+
+bool SDLInputLog::IsRecording() const
+{
+	return recording;
+}
+
+bool SDLInputLog::IsReplaying() const
+{
+	return replaying;
+}
+
+Uint32 SDLInputLog::GetSeed() const
+{
+	return seed;
+}
+
+void SDLInputLog::RecordFrame(int elapsedSteps, const vector<SDLInputEvent>& events)
+{
+	WriteVarint(((Uint32)elapsedSteps << 1) | (events.empty()? 0: 1));
+
+	if(!events.empty())
+	{
+		WriteVarint((Uint32)events.size());
+
+		for(vector<SDLInputEvent>::const_iterator currentEvent = events.begin();
+			currentEvent != events.end(); currentEvent++)
+		{
+			WriteVarint(((Uint32)currentEvent->value << 2) | (Uint32)currentEvent->type);
+		}
+	}
+}
+
+bool SDLInputLog::ReadFrame(int& elapsedSteps, vector<SDLInputEvent>& events)
+{
+	Uint32 frameHeader;
+	events.clear();
+
+	if(!ReadVarint(frameHeader))
+	{
+		return false;
+	}
+
+	elapsedSteps = (int)(frameHeader >> 1);
+
+	if(frameHeader & 1)
+	{
+		Uint32 numberOfEvents;
+
+		if(!ReadVarint(numberOfEvents))
+		{
+			return false;
+		}
+
+		for(Uint32 i = 0; i < numberOfEvents; i++)
+		{
+			Uint32 packedEvent;
+
+			if(!ReadVarint(packedEvent))
+			{
+				return false;
+			}
+
+			SDLInputEvent currentEvent;
+
+			currentEvent.type = (SDLInputEventType)(packedEvent & 3);
+			currentEvent.value = (int)(packedEvent >> 2);
+
+			events.push_back(currentEvent);
+		}
+	}
+
+	return true;
+}
+
+SDLInputLog::~SDLInputLog()
+{
+	Stop();
+}
@@ -0,0 +1,214 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_INPUT_LOG_H
+#define SDL_INPUT_LOG_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <SDL/SDL.h>
+
+#include <SDLInterface/SDLInterfaceLibraryException.h>
+#include <Helpers/IUncopyable.h>
+
+using std::string;
+using std::vector;
+using namespace Helpers;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Enum: SDLInputEventType
+
+		The kinds of input which an <SDLInputLog> holds.
+
+		SDL_IE_KEY_DOWN - A key was pressed, or repeated.
+		SDL_IE_KEY_UP - A key was released.
+		SDL_IE_MODIFIERS - The state of the modifier keys, such as caps lock, changed.
+	*/
+	enum SDLInputEventType
+	{
+		SDL_IE_KEY_DOWN,
+		SDL_IE_KEY_UP,
+		SDL_IE_MODIFIERS
+	};
+
+	/*
+		Struct: SDLInputEvent
+
+		A single piece of input dispatched by <SDLInstance::Run>.
+
+		type - The kind of input.
+		value - The key symbol, or the new state of the modifier keys.
+	*/
+	struct SDLInputEvent
+	{
+		SDLInputEventType type;
+		int value;
+	};
+
+	/*
+		Class: ISDLInputSource
+
+		An interface for anything which can take the place of the keyboard and the clock,
+		such as an input log being replayed, or the synthetic player of a benchmark.
+
+		See Also:
+			<SDLInstance::SetInputSource>
+	*/
+	class ISDLInputSource
+	{
+		public:
+			/*
+				Function: ReadFrame
+
+				Supplies the next frame: the number of simulation steps it advances by, and
+				the input dispatched during it, which replaces the contents of [events].
+
+				Returns:
+					False once there are no more frames, which ends the run.
+			*/
+			virtual bool ReadFrame(int& elapsedSteps, vector<SDLInputEvent>& events) = 0;
+
+			virtual ~ISDLInputSource()
+			{
+			}
+	};
+
+	/*
+		Class: SDLInputLog
+
+		Records the input of a run to a file, or plays it back from one.
+
+		The log holds the seed handed out by <SDLInstance::GetRandomSeed>, followed by every
+		frame of the run: the number of simulation steps it advanced by, and the input
+		dispatched during it. Since the game only changes through input and simulation
+		steps, replaying the log repeats the run exactly, no matter how long each frame
+		takes to draw.
+
+		File Format:
+
+		All numbers after the header are unsigned LEB128 varints, so that a frame without
+		input usually takes a single byte.
+
+		bytes 0 - 3: "BRIL"
+		byte 4: Version, currently 1.
+		bytes 5 - 8: The random seed, little endian.
+
+		For each frame:
+
+		varint: (Elapsed steps << 1) | 1 if the frame has input.
+		If the frame has input: varint number of events, then a varint
+		(value << 2) | type for each event.
+	*/
+	class SDLInputLog: public ISDLInputSource, public IUncopyable
+	{
+		private:
+			std::ofstream recordFile;
+			bool recording;
+
+			//The whole log being replayed, and the position of the next frame within it.
+			vector<Uint8> replayData;
+			size_t replayPosition;
+			bool replaying;
+
+			Uint32 seed;
+
+			void WriteVarint(Uint32 value);
+			//Returns false if the log ends before the whole varint.
+			bool ReadVarint(Uint32& value);
+		public:
+			/*
+				Constructor: SDLInputLog
+
+				Creates a log which neither records nor replays.
+			*/
+			SDLInputLog();
+			/*
+				Function: StartRecording
+
+				Creates, or overwrites, [fileName] and starts recording to it, headed by
+				[seed]. Throws an <SDLInterfaceLibraryException> if the file cannot be written.
+			*/
+			void StartRecording(const string& fileName, Uint32 seed);
+			/*
+				Function: StartReplay
+
+				Reads the whole of [fileName], and starts playing it back. Throws an
+				<SDLInterfaceLibraryException> if the file cannot be read, or is not an input
+				log.
+			*/
+			void StartReplay(const string& fileName);
+			/*
+				Function: Stop
+
+				Stops recording or replaying, flushing anything recorded to the file.
+			*/
+			void Stop();
+			/*
+				Function: IsRecording
+
+				Returns:
+					True if frames are being recorded to a file.
+			*/
+			bool IsRecording() const;
+			/*
+				Function: IsReplaying
+
+				Returns:
+					True if a log is being played back, even once all it's frames are read.
+			*/
+			bool IsReplaying() const;
+			/*
+				Function: GetSeed
+
+				Returns:
+					The seed which the log was recorded with, or started recording with.
+			*/
+			Uint32 GetSeed() const;
+			/*
+				Function: RecordFrame
+
+				Appends a frame which advanced by [elapsedSteps] and dispatched [events].
+			*/
+			void RecordFrame(int elapsedSteps, const vector<SDLInputEvent>& events);
+			/*
+				Function: ReadFrame
+
+				Reads the next frame of the log being replayed, replacing the contents of
+				[events] with it's input.
+
+				Returns:
+					False once every frame has been read, or if the rest of the log is
+					damaged.
+			*/
+			bool ReadFrame(int& elapsedSteps, vector<SDLInputEvent>& events);
+
+			~SDLInputLog();
+	};
+}
+
+#endif
@@ -26,9 +26,28 @@
 #include <SDLInterface/SDLInstance.h>
 #include <SDLInterface/SDLForm.h>
 
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+
 using namespace SDLInterfaceLibrary;
 using namespace EventHandling;
 
+using std::cerr;
+using std::endl;
+
+//The fraction of the screen which, once damaged, is presented by flipping the entire
+//screen rather than updating each area.
+static const double FULL_PRESENT_THRESHOLD = 0.5;
+
+//The length, in microseconds, of the steps which timers are advanced by. Each step is
+//one tick of the timer wheel, on which timers are scheduled in milliseconds.
+static const int SIMULATION_STEP_LENGTH = 1000;
+//The most time, in microseconds, which a single frame may advance timers by.
+static const int MAXIMUM_FRAME_LENGTH = 250000;
+
 void SDLInstance::AssertVideo()
 {
 	if(screen == NULL)
@@ -99,17 +118,63 @@ void SDLInstance::FlipScreen()
 	}
 }
 
+void SDLInstance::PresentScreen()
+{
+	int screenArea = screen->w * screen->h;
+
+	damageList.Merge(Bounds2D<int>(screen->w, screen->h));
+
+	const vector<SDL_Rect>& damagedAreas = damageList.GetAreas();
+	int damagedPixels = damageList.GetNumberOfPixels();
+
+	//A double buffered screen can only be presented by flipping it.
+	if((screen->flags & SDL_DOUBLEBUF) || damagedPixels > screenArea * FULL_PRESENT_THRESHOLD)
+	{
+		FlipScreen();
+		pixelsPresentedLastFrame = screenArea;
+	}
+	else
+	{
+		if(!damagedAreas.empty())
+		{
+			SDL_UpdateRects(screen, damagedAreas.size(), const_cast<SDL_Rect*>(&damagedAreas[0]));
+		}
+
+		pixelsPresentedLastFrame = damagedPixels;
+	}
+
+	damageList.Clear();
+}
+
 void SDLInstance::MusicEndCallback()
 {
 	SDLInstance::GetInstance().GetMusicEndHandlers().RaiseEvents();
 }
 
-SDLInstance::SDLInstance()
+SDLInstance::SDLInstance():
+	simulationClock(SIMULATION_STEP_LENGTH, MAXIMUM_FRAME_LENGTH),
+	keyRepeater(SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL)
 {
 	runStartHandlers = new GenericEventHandlerCollection();
 	musicEndHandlers = new GenericEventHandlerCollection();
+	frameHandlers = new GenericEventHandlerCollection();
 
 	screen = NULL;
+	exceptionsThrownLastFrame = 0;
+	pixelsPresentedLastFrame = 0;
+	blitsThisFrame = 0;
+	blitsLastFrame = 0;
+	screenEffect = NULL;
+	inputSource = NULL;
+	running = false;
+	frameStatsEnabled = false;
+	frameStatsWrittenOnExit = false;
+
+	memset(keyStates, 0, sizeof(keyStates));
+	keyModifiers = KMOD_NONE;
+
+	randomSeed = (Uint32)time(NULL);
+	numberOfRandomSeedsTaken = 0;
 }
 
 void SDLInstance::InitializeVideo(bool fullScreen, const Bounds2D<int>& windowSize,
@@ -127,12 +192,18 @@ void SDLInstance::InitializeVideo(bool fullScreen, const Bounds2D<int>& windowSi
 	frameRateManager = new FPSmanager();
 	SDL_initFramerate(frameRateManager);
 
-	SDL_setFramerate(frameRateManager, frameRate);
+	frameRateCapped = frameRate > 0;
+
+	if(frameRateCapped)
+	{
+		SDL_setFramerate(frameRateManager, frameRate);
+	}
 
 	childWithFocus = NULL;
 	running = false;
 
-	SDL_EnableKeyRepeat(SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL);
+	//Keys are repeated by keyRepeater instead.
+	SDL_EnableKeyRepeat(0, 0);
 	Mix_HookMusicFinished(SDLInstance::MusicEndCallback);
 }
 
@@ -187,6 +258,11 @@ GenericEventHandlerCollection& SDLInstance::GetRunStartHandlers()
 	return *runStartHandlers;
 }
 
+GenericEventHandlerCollection& SDLInstance::GetFrameHandlers()
+{
+	return *frameHandlers;
+}
+
 GenericEventHandlerCollection& SDLInstance::GetMusicEndHandlers()
 {
 	return *musicEndHandlers;
@@ -216,6 +292,7 @@ void SDLInstance::SetFocus(SDLForm* childForm)
 	if(childWithFocus != NULL)
 	{
 		childWithFocus->SetParent(NULL);
+		childWithFocus->SetTimersSuspended(true);
 	}
 
 	childWithFocus = childForm;
@@ -223,6 +300,7 @@ void SDLInstance::SetFocus(SDLForm* childForm)
 	if(childWithFocus != NULL)
 	{
 		childWithFocus->screen = this->screen;
+		childWithFocus->SetTimersSuspended(false);
 	}
 }
 
@@ -231,16 +309,110 @@ FPSmanager* SDLInstance::GetFrameRateManager() const
 	return frameRateManager;
 }
 
-void SDLInstance::PerformScreenEffect(ISDLScreenEffect& screenEffect)
+unsigned int SDLInstance::GetExceptionsThrownLastFrame() const
+{
+	return exceptionsThrownLastFrame;
+}
+
+SDLDamageList& SDLInstance::GetDamageList()
+{
+	return damageList;
+}
+
+SDLTimerWheel& SDLInstance::GetTimerWheel()
+{
+	return timerWheel;
+}
+
+int SDLInstance::GetPixelsPresentedLastFrame() const
+{
+	return pixelsPresentedLastFrame;
+}
+
+int SDLInstance::GetDrawTimeLastFrame() const
+{
+	return frameStatsEnabled? frameStats.GetLatest(SDL_FP_DRAW): 0;
+}
+
+void SDLInstance::CountBlits(int numberOfBlits)
+{
+	blitsThisFrame += numberOfBlits;
+}
+
+int SDLInstance::GetBlitsLastFrame() const
+{
+	return blitsLastFrame;
+}
+
+void SDLInstance::SetFrameStatsEnabled(bool enabled, bool writtenOnExit)
+{
+	if(enabled && !frameStatsEnabled)
+	{
+		frameStats.Clear();
+	}
+
+	frameStatsEnabled = enabled;
+	frameStatsWrittenOnExit = writtenOnExit;
+}
+
+bool SDLInstance::FrameStatsAreWrittenOnExit() const
 {
+	return frameStatsWrittenOnExit;
+}
+
+const SDLFrameStats& SDLInstance::GetFrameStats() const
+{
+	return frameStats;
+}
+
+void SDLInstance::PerformScreenEffect(ISDLScreenEffect* screenEffect)
+{
+	std::unique_ptr<ISDLScreenEffect> newEffect(screenEffect);
+
 	AssertVideo();
 
-	if(screenEffect.RequiresDraw())
+	//The complete handlers of the previous effect may well start yet another one.
+	while(this->screenEffect != NULL)
+	{
+		FinishScreenEffect();
+	}
+
+	if(newEffect->RequiresDraw())
 	{
 		Draw();
 	}
 
-	screenEffect.Draw(this);
+	newEffect->Start(this);
+
+	this->screenEffect = newEffect.release();
+}
+
+bool SDLInstance::IsPerformingScreenEffect() const
+{
+	return screenEffect != NULL;
+}
+
+void SDLInstance::AdvanceScreenEffect(int elapsedTime)
+{
+	screenEffect->Advance(elapsedTime);
+
+	if(screenEffect->IsComplete())
+	{
+		FinishScreenEffect();
+	}
+}
+
+void SDLInstance::FinishScreenEffect()
+{
+	std::unique_ptr<ISDLScreenEffect> finishedEffect(screenEffect);
+	screenEffect = NULL;
+
+	if(finishedEffect->RestoresScreen() && childWithFocus != NULL)
+	{
+		childWithFocus->Update();
+	}
+
+	finishedEffect->GetCompleteHandlers().RaiseEvents();
 }
 
 void SDLInstance::PlayMusic(Mix_Music* music, int numberOfLoops, int fadeInLength)
@@ -286,62 +458,357 @@ void SDLInstance::PlaySound(Mix_Chunk* sound)
 	Mix_PlayChannel(-1, sound, 0);
 }
 
-void SDLInstance::Run()
+void SDLInstance::DispatchInputEvent(SDLInputEventType type, int value)
 {
-	AssertVideo();
+	SDLInputEvent inputEvent;
 
-	running = true;
+	inputEvent.type = type;
+	inputEvent.value = value;
+
+	frameEvents.push_back(inputEvent);
+
+	switch(type)
+	{
+		case SDL_IE_KEY_DOWN:
+		{
+			if(value >= 0 && value < SDLK_LAST)
+			{
+				keyStates[value] = 1;
+			}
+
+			childWithFocus->KeyDown(value);
+			break;
+		}
+
+		case SDL_IE_KEY_UP:
+		{
+			if(value >= 0 && value < SDLK_LAST)
+			{
+				keyStates[value] = 0;
+			}
+
+			childWithFocus->KeyUp(value);
+			break;
+		}
+
+		case SDL_IE_MODIFIERS:
+		{
+			keyModifiers = value;
+			break;
+		}
+	}
+}
+
+void SDLInstance::DispatchKeyEvent(const SDL_KeyboardEvent& keyEvent)
+{
+	int keySymbol = keyEvent.keysym.sym;
+
+	if(keyEvent.keysym.mod != keyModifiers)
+	{
+		DispatchInputEvent(SDL_IE_MODIFIERS, keyEvent.keysym.mod);
+	}
+
+	if(keyEvent.type == SDL_KEYUP)
+	{
+		keyRepeater.Release(keySymbol);
+		DispatchInputEvent(SDL_IE_KEY_UP, keySymbol);
+	}
+	else if(keySymbol == SDLK_F4 && keyStates[SDLK_LALT])
+	{
+		Quit();
+	}
+	else
+	{
+		keyRepeater.Press(keySymbol);
+		DispatchInputEvent(SDL_IE_KEY_DOWN, keySymbol);
+	}
+}
+
+bool SDLInstance::DispatchEvents(int& elapsedSteps)
+{
 	SDL_Event currentEvent;
+	bool keyEventsPolled = false;
 
-	runStartHandlers->RaiseEvents();
+	frameEvents.clear();
 
-	while(running && childWithFocus != NULL)
+	if(inputSource != NULL)
 	{
-		SDL_framerateDelay(frameRateManager);
-		childWithFocus->UpdateTimers(SDL_getFramerate(frameRateManager));
+		//The source takes the place of both the clock and the keyboard.
+		if(inputSource->ReadFrame(elapsedSteps, replayedEvents))
+		{
+			for(vector<SDLInputEvent>::iterator replayedEvent = replayedEvents.begin();
+				replayedEvent != replayedEvents.end(); replayedEvent++)
+			{
+				DispatchInputEvent(replayedEvent->type, replayedEvent->value);
+			}
 
-		Draw();
-		FlipScreen();
+			keyEventsPolled = !replayedEvents.empty();
+		}
+		else
+		{
+			elapsedSteps = 0;
+			Quit();
+		}
+	}
+	else
+	{
+		//Keys held down since earlier frames repeat first, since their repeats fell due
+		//before any of the events which are pending now.
+		repeatedKeys.clear();
+		keyRepeater.Advance(elapsedSteps, repeatedKeys);
 
-		while(SDL_PollEvent(&currentEvent))
+		for(vector<int>::iterator repeatedKey = repeatedKeys.begin(); repeatedKey != repeatedKeys.end(); repeatedKey++)
 		{
-			switch(currentEvent.type)
+			DispatchInputEvent(SDL_IE_KEY_DOWN, *repeatedKey);
+		}
+	}
+
+	while(SDL_PollEvent(&currentEvent))
+	{
+		switch(currentEvent.type)
+		{
+			case SDL_QUIT:
 			{
-				case SDL_QUIT:
-				{
-					Quit();
-					break;
-				}
+				Quit();
+				break;
+			}
 
-				case SDL_KEYDOWN:
+			case SDL_ACTIVEEVENT:
+			{
+				//No key up will arrive for keys released while another window has the keyboard.
+				if(currentEvent.active.gain == 0 && (currentEvent.active.state & SDL_APPINPUTFOCUS))
 				{
-					int keySymbol = currentEvent.key.keysym.sym;
-
-					if(keySymbol == SDLK_F4 && SDL_GetKeyState(NULL)[SDLK_LALT])
-					{
-						Quit();
-					}
-					else
-					{
-						childWithFocus->KeyDown(currentEvent.key.keysym.sym);
-					}
-
-					break;
+					keyRepeater.ReleaseAll();
 				}
 
-				case SDL_KEYUP:
+				break;
+			}
+
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+			{
+				//The keyboard is ignored while input comes from elsewhere.
+				if(inputSource == NULL)
 				{
-					childWithFocus->KeyUp(currentEvent.key.keysym.sym);
-					break;
+					keyEventsPolled = true;
+					DispatchKeyEvent(currentEvent.key);
 				}
+
+				break;
 			}
 		}
 	}
+
+	if(inputLog.IsRecording())
+	{
+		inputLog.RecordFrame(elapsedSteps, frameEvents);
+	}
+
+	return keyEventsPolled;
+}
+
+template<bool recordFrameStats> void SDLInstance::RunFrame()
+{
+	unsigned int exceptionsCreatedBeforeFrame = ApplicationException::GetNumberCreated();
+
+	if(recordFrameStats)
+	{
+		frameStats.BeginFrame();
+	}
+
+	if(frameRateCapped)
+	{
+		SDL_framerateDelay(frameRateManager);
+	}
+
+	if(recordFrameStats)
+	{
+		frameStats.EndPhase(SDL_FP_DELAY);
+	}
+
+	//Timers are advanced by the real time which has passed, in fixed steps, however
+	//often frames are drawn.
+	int elapsedSteps = simulationClock.Advance();
+
+	//Input is handled before anything else, so that it is acted on, and shown, within the
+	//frame it was polled in.
+	std::chrono::steady_clock::time_point inputTime;
+
+	if(recordFrameStats)
+	{
+		inputTime = std::chrono::steady_clock::now();
+	}
+
+	bool keyEventsPolled = DispatchEvents(elapsedSteps);
+
+	if(recordFrameStats)
+	{
+		frameStats.EndPhase(SDL_FP_EVENTS);
+	}
+
+	frameHandlers->RaiseEvents();
+
+	timerWheel.Advance(elapsedSteps);
+
+	if(recordFrameStats)
+	{
+		frameStats.EndPhase(SDL_FP_TIMERS);
+	}
+
+	if(screenEffect != NULL)
+	{
+		//A step is one milli-second long, which is what screen effects are timed in.
+		AdvanceScreenEffect(elapsedSteps);
+	}
+
+	//Screen effects blend their frames over the screen in place, so the form is drawn in
+	//full beneath them, rather than only where it has changed.
+	if(screenEffect != NULL && childWithFocus != NULL)
+	{
+		childWithFocus->Update();
+	}
+
+	Draw();
+
+	if(screenEffect != NULL)
+	{
+		screenEffect->DrawFrame(this);
+	}
+
+	if(recordFrameStats)
+	{
+		frameStats.EndPhase(SDL_FP_DRAW);
+	}
+
+	PresentScreen();
+
+	if(recordFrameStats)
+	{
+		frameStats.EndPhase(SDL_FP_PRESENT);
+
+		if(keyEventsPolled)
+		{
+			frameStats.RecordInputLatency(inputTime);
+		}
+
+		frameStats.EndFrame();
+	}
+
+	blitsLastFrame = blitsThisFrame;
+	blitsThisFrame = 0;
+
+	exceptionsThrownLastFrame = ApplicationException::GetNumberCreated() - exceptionsCreatedBeforeFrame;
+
+#ifdef DEBUG
+	if(exceptionsThrownLastFrame != 0)
+	{
+		cerr << "Warning: " << exceptionsThrownLastFrame << " exception(s) thrown during the last frame" << endl;
+	}
+#endif
+}
+
+void SDLInstance::Run()
+{
+	AssertVideo();
+
+	running = true;
+
+	runStartHandlers->RaiseEvents();
+	simulationClock.Reset();
+
+	while(running && childWithFocus != NULL)
+	{
+		//This is the only cost of frame timing while it is disabled.
+		if(frameStatsEnabled)
+		{
+			RunFrame<true>();
+		}
+		else
+		{
+			RunFrame<false>();
+		}
+	}
 }
 
 bool SDLInstance::KeyIsPressed(int keySymbol)
 {
-	return SDL_GetKeyState(NULL)[keySymbol] > 0;
+	if(keySymbol < 0 || keySymbol >= SDLK_LAST)
+	{
+		return false;
+	}
+
+	return keyStates[keySymbol] > 0;
+}
+
+int SDLInstance::GetKeyModifiers() const
+{
+	return keyModifiers;
+}
+
+Uint32 SDLInstance::GetRandomSeed()
+{
+	return randomSeed + numberOfRandomSeedsTaken++;
+}
+
+void SDLInstance::SetRandomSeed(Uint32 seed)
+{
+	randomSeed = seed;
+	numberOfRandomSeedsTaken = 0;
+}
+
+void SDLInstance::StartRecordingInput(const string& fileName)
+{
+	if(running)
+	{
+		throw SDLInterfaceLibraryException("Input can only be recorded from the start of a run");
+	}
+
+	inputLog.StartRecording(fileName, randomSeed);
+	numberOfRandomSeedsTaken = 0;
+}
+
+void SDLInstance::StartReplayingInput(const string& fileName)
+{
+	if(running)
+	{
+		throw SDLInterfaceLibraryException("Input can only be replayed from the start of a run");
+	}
+
+	inputLog.StartReplay(fileName);
+	inputSource = &inputLog;
+
+	randomSeed = inputLog.GetSeed();
+	numberOfRandomSeedsTaken = 0;
+}
+
+void SDLInstance::SetInputSource(ISDLInputSource* source)
+{
+	inputSource = source;
+}
+
+bool SDLInstance::IsReplayingInput() const
+{
+	return inputSource != NULL;
+}
+
+bool SDLInstance::IsRecordingInput() const
+{
+	return inputLog.IsRecording();
+}
+
+SDLForm* SDLInstance::GetFocus() const
+{
+	return childWithFocus;
+}
+
+void SDLInstance::SetKeyRepeat(int keySymbol, int delay, int interval)
+{
+	keyRepeater.SetRepeat(keySymbol, delay, interval);
+}
+
+void SDLInstance::SetDefaultKeyRepeat(int delay, int interval)
+{
+	keyRepeater.SetDefaultRepeat(delay, interval);
 }
 
 void SDLInstance::Quit()
@@ -376,5 +843,16 @@ void SDLInstance::CleanUpSDL()
 
 void SDLInstance::CleanUp()
 {
+	//The effect's complete handlers may refer to lua, so it must go before lua is closed.
+	delete screenEffect;
+	screenEffect = NULL;
+
 	delete frameRateManager;
+	frameRateManager = NULL;
+
+	//Timers scheduled through SDLTimer.After and SDLTimer.Every hold references into lua.
+	timerWheel.CancelAll();
+
+	inputLog.Stop();
+	inputSource = NULL;
 }
@@ -36,8 +36,14 @@
 #include <SDL/SDL_mixer.h>
 
 #include <Helpers/GeometricStructures2D.h>
+#include <SDLInterface/SDLDamageList.h>
 #include <SDLInterface/SDLException.h>
 #include <SDLInterface/SDLForm.h>
+#include <SDLInterface/SDLFrameStats.h>
+#include <SDLInterface/SDLInputLog.h>
+#include <SDLInterface/SDLKeyRepeater.h>
+#include <SDLInterface/SDLSimulationClock.h>
+#include <SDLInterface/SDLTimerWheel.h>
 #include <SDLInterface/TTFException.h>
 #include <SDLInterface/SDLInterfaceLibraryException.h>
 #include <SDLInterface/MixException.h>
@@ -74,10 +80,75 @@ namespace SDLInterfaceLibrary
 			SDLForm* childWithFocus;
 			//The framerate manager for this application.
 			FPSmanager* frameRateManager;
+			//False if frames are drawn as fast as possible.
+			bool frameRateCapped;
+
+			//Splits the real time which passes between frames into the fixed steps which
+			//timers are advanced by.
+			SDLSimulationClock simulationClock;
+			//The timers of the application, advanced by one tick per simulation step.
+			SDLTimerWheel timerWheel;
+			//Repeats the keys which are held down, advanced by a milli-second per simulation
+			//step. repeatedKeys holds the keys which repeated during the current frame.
+			SDLKeyRepeater keyRepeater;
+			vector<int> repeatedKeys;
+
+			//Records the input of the run, or plays it back in place of SDL's. inputSource
+			//supplies the input in place of SDL, if it isn't NULL. It is either inputLog, or
+			//set through SetInputSource. frameEvents holds the input dispatched during the
+			//current frame, and replayedEvents the input read from inputSource for it.
+			SDLInputLog inputLog;
+			ISDLInputSource* inputSource;
+			vector<SDLInputEvent> frameEvents;
+			vector<SDLInputEvent> replayedEvents;
+
+			//The state of each key, and of the modifier keys, as of the input dispatched so
+			//far. This is used in place of SDL's own, so that it is replayed as well.
+			Uint8 keyStates[SDLK_LAST];
+			int keyModifiers;
+
+			//The seed from which every seed handed out by GetRandomSeed is derived, and the
+			//number handed out so far.
+			Uint32 randomSeed;
+			int numberOfRandomSeedsTaken;
 
 			//Is true if the main loop is active.
 			bool running;
 
+			//The screen effect being played, NULL if there is none. It is owned by the instance.
+			ISDLScreenEffect* screenEffect;
+
+			//The number of application exceptions constructed during the last frame.
+			unsigned int exceptionsThrownLastFrame;
+
+			//The areas of the screen drawn on during the current frame.
+			SDLDamageList damageList;
+			//The number of pixels sent to the display at the end of the last frame.
+			int pixelsPresentedLastFrame;
+			//The number of blits to the screen made by components during the current, and
+			//the last, frame.
+			int blitsThisFrame;
+			int blitsLastFrame;
+
+			//The length of each phase of the most recent frames, recorded only while
+			//frameStatsEnabled is true.
+			SDLFrameStats frameStats;
+			bool frameStatsEnabled;
+			//True if frameStats should be written to a file when the application exits.
+			bool frameStatsWrittenOnExit;
+
+			//Polls every pending SDL event and dispatches it to the focused form, after the
+			//key repeats which fell due over the last [elapsedSteps] simulation steps. While
+			//there is an input source, the input, and [elapsedSteps], are read from it
+			//instead. Returns
+			//true if any key input was polled or replayed.
+			bool DispatchEvents(int& elapsedSteps);
+			//Handles a single key event polled from SDL.
+			void DispatchKeyEvent(const SDL_KeyboardEvent& keyEvent);
+			//Applies a piece of input, passes it on to the focused form, and adds it to
+			//frameEvents.
+			void DispatchInputEvent(SDLInputEventType type, int value);
+
 			//Collection of generic event handlers which will be called when
 			//application starts.
 			GenericEventHandlerCollection* runStartHandlers;
@@ -86,6 +157,10 @@ namespace SDLInterfaceLibrary
 			//a music file stops playing.
 			GenericEventHandlerCollection* musicEndHandlers;
 
+			//Collection of generic event handlers which will be called once
+			//every frame, before the timers are advanced.
+			GenericEventHandlerCollection* frameHandlers;
+
 
 			//The following private methods can be called to
 			//assert that video and audio libraries have been loaded.
@@ -99,9 +174,23 @@ namespace SDLInterfaceLibrary
 			//Draws the focused form and it's children.
 			void Draw();
 
+			//Advances screenEffect by [elapsedTime] milli-seconds, and finishes it if it is complete.
+			void AdvanceScreenEffect(int elapsedTime);
+			//Ends screenEffect, redrawing the focused form if the effect asks for it, and raises
+			//the effect's complete handlers.
+			void FinishScreenEffect();
+
+			//Runs a single iteration of the main loop. The phases of the frame are only timed
+			//if [recordFrameStats] is true, so the untimed version carries no instrumentation.
+			template<bool recordFrameStats> void RunFrame();
+
 			//Flips the main screen.
 			void FlipScreen();
 
+			//Presents the areas in damageList, or the entire screen if they cover more than
+			//FULL_PRESENT_THRESHOLD of it, then empties damageList.
+			void PresentScreen();
+
 			//Fires all the event handlers registered with musicEndHandlers.
 			static void MusicEndCallback();
 
@@ -130,6 +219,12 @@ namespace SDLInterfaceLibrary
 				    colorDepth - The application's bit depth.
 
 					frameRate - The number of frames per second which this application generates.
+								If this is 0 frames are drawn as fast as possible, or, for double
+								buffered screens, as fast as the display's refresh allows.
+
+				Note:
+					The frame rate does not affect the speed of timers, which are advanced
+					against a real time clock. See <SDLInstance::Run>.
 			*/
 			void InitializeVideo(bool fullScreen, const Bounds2D<int>& windowSize,
 							int colorDepth, int frameRate);
@@ -175,6 +270,15 @@ namespace SDLInterfaceLibrary
 					will be called when the main loop starts.
 			*/
 			GenericEventHandlerCollection& GetRunStartHandlers();
+			/*
+				Function: GetFrameHandlers
+
+				Returns:
+					A read/write reference to the frame event handler collection, which
+					will be called once every frame, after input has been handled and before
+					the timers are advanced.
+			*/
+			GenericEventHandlerCollection& GetFrameHandlers();
 			/*
 				Function: GetFrameRateManager
 
@@ -183,6 +287,103 @@ namespace SDLInterfaceLibrary
 			*/
 
 			FPSmanager* GetFrameRateManager()  const;
+			/*
+				Function: GetExceptionsThrownLastFrame
+
+				Exceptions are meant for genuine errors, and are expensive to throw. This
+				counter exists so that any which creep into the per-frame code paths are
+				noticed. In debug builds a warning is also written to the standard error
+				stream whenever it is not 0.
+
+				Returns:
+					The number of application exceptions which were constructed during
+					the last iteration of the main loop. This includes those constructed
+					meanwhile by the threads which load trunks in the background.
+			*/
+			unsigned int GetExceptionsThrownLastFrame() const;
+			/*
+				Function: GetDamageList
+
+				Returns:
+					A read/write reference to the list of areas which have been drawn on during
+					the current frame. Components add to it whenever they draw on the screen.
+			*/
+			SDLDamageList& GetDamageList();
+			/*
+				Function: GetTimerWheel
+
+				Returns:
+					A read/write reference to the wheel on which all timers are scheduled. It
+					is advanced by one tick for every millisecond of real time which passes
+					while <SDLInstance::Run> is running.
+			*/
+			SDLTimerWheel& GetTimerWheel();
+			/*
+				Function: GetPixelsPresentedLastFrame
+
+				Returns:
+					The number of pixels which were sent to the display at the end of the
+					last frame. This is 0 if nothing was drawn, and the size of the screen
+					if it was flipped in it's entirety.
+			*/
+			int GetPixelsPresentedLastFrame() const;
+			/*
+				Function: GetDrawTimeLastFrame
+
+				Returns:
+					The time, in microseconds, which was spent blitting the focused form and it's
+					children during the last frame. Presenting the screen is not included.
+					This is the <SDL_FP_DRAW> phase of the frame statistics, so it is only
+					measured while they are enabled, and is 0 otherwise.
+
+				See Also:
+					<SDLInstance::SetFrameStatsEnabled>
+			*/
+			int GetDrawTimeLastFrame() const;
+			/*
+				Function: CountBlits
+
+				Adds [numberOfBlits] to the number of blits made during the current frame.
+				Components call this through <SDLComponent::AddDamage>.
+			*/
+			void CountBlits(int numberOfBlits);
+			/*
+				Function: GetBlitsLastFrame
+
+				Returns:
+					The number of blits which components made to the screen during the last
+					frame. A surface grid component counts one blit per cell it draws or
+					restores, so this shows how much of a moving piece was actually redrawn.
+			*/
+			int GetBlitsLastFrame() const;
+			/*
+				Function: SetFrameStatsEnabled
+
+				Starts, or stops, timing each phase of the frames drawn by <SDLInstance::Run>.
+				The previous record is discarded whenever timing is started.
+
+				Parameters:
+					enabled - True if frames should be timed.
+					writtenOnExit - True if the record should be written to a CSV file when
+									the application exits. See <FrameStatsAreWrittenOnExit>.
+			*/
+			void SetFrameStatsEnabled(bool enabled, bool writtenOnExit);
+			/*
+				Function: FrameStatsAreWrittenOnExit
+
+				Returns:
+					True if the frame statistics were requested to be written to a file when
+					the application exits.
+			*/
+			bool FrameStatsAreWrittenOnExit() const;
+			/*
+				Function: GetFrameStats
+
+				Returns:
+					The length of each phase of the most recent frames, which is empty unless
+					timing was enabled with <SDLInstance::SetFrameStatsEnabled>.
+			*/
+			const SDLFrameStats& GetFrameStats() const;
 			/*
 				Function: GetRunStartHandlers
 
@@ -208,6 +409,9 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: SetFocus
 
+				The timers of the form which previously had the focus are suspended, and
+				those of [childForm] are resumed.
+
 				Parameters:
 					childForm - The form on which this application will focus.
 
@@ -215,16 +419,37 @@ namespace SDLInterfaceLibrary
 					<SDLForm>
 			*/
 			void SetFocus(SDLForm* childForm);
+			/*
+				Function: GetFocus
+
+				Returns:
+					The form which has the focus, or NULL if there is none.
+			*/
+			SDLForm* GetFocus() const;
 			/*
 				Function: PerformScreenEffect
 
+				Starts a screen effect, which is then advanced once per frame by
+				<SDLInstance::Run> until it completes. This returns immediately. If another
+				effect is still being played it is finished first, and it's complete handlers
+				are raised.
+
 				Parameters:
 					screenEffect - The screen effect which will be performed on this application.
+								   The instance takes ownership of it, and deletes it once it
+								   completes.
 
 				See Also:
 					<ISDLScreenEffect>
 			*/
-			void PerformScreenEffect(ISDLScreenEffect& screenEffect);
+			void PerformScreenEffect(ISDLScreenEffect* screenEffect);
+			/*
+				Function: IsPerformingScreenEffect
+
+				Returns:
+					True if a screen effect is being played.
+			*/
+			bool IsPerformingScreenEffect() const;
 			/*
 				Function: PlaySound
 
@@ -290,6 +515,100 @@ namespace SDLInterfaceLibrary
 					otherwhise.
 			*/
 			bool KeyIsPressed(int keySymbol);
+			/*
+				Function: GetKeyModifiers
+
+				Returns:
+					The state of the modifier keys, as an SDLMod, as of the last key event.
+			*/
+			int GetKeyModifiers() const;
+			/*
+				Function: GetRandomSeed
+
+				Returns:
+					A seed for a random number generator. Each call returns a different seed,
+					derived from the time the application started, or from the input log
+					being replayed, so that a replay draws the same random numbers.
+			*/
+			Uint32 GetRandomSeed();
+			/*
+				Function: SetRandomSeed
+
+				Makes <SDLInstance::GetRandomSeed> start over from [seed], so that a run can be
+				repeated without an input log. To be recorded, it must be called before
+				<SDLInstance::StartRecordingInput>.
+			*/
+			void SetRandomSeed(Uint32 seed);
+			/*
+				Function: StartRecordingInput
+
+				Records the random seed, and every frame's input and simulation steps, to
+				[fileName]. This must be called before <SDLInstance::Run>.
+
+				See Also:
+					<SDLInputLog>
+			*/
+			void StartRecordingInput(const string& fileName);
+			/*
+				Function: StartReplayingInput
+
+				Plays back the input log [fileName], in place of the keyboard and the clock.
+				The application quits once the whole log has been played. This must be called
+				before <SDLInstance::Run>.
+
+				See Also:
+					<SDLInputLog>
+			*/
+			void StartReplayingInput(const string& fileName);
+			/*
+				Function: SetInputSource
+
+				Takes input, and simulation steps, from [source] in place of the keyboard and
+				the clock, or goes back to them if [source] is NULL. The source is not owned
+				by the instance. Input from the source is recorded like any other.
+			*/
+			void SetInputSource(ISDLInputSource* source);
+			/*
+				Function: IsReplayingInput
+
+				Returns:
+					True if input comes from an input log being played back, or from another
+					input source.
+			*/
+			bool IsReplayingInput() const;
+			/*
+				Function: IsRecordingInput
+
+				Returns:
+					True if input is being recorded to an input log.
+			*/
+			bool IsRecordingInput() const;
+			/*
+				Function: SetKeyRepeat
+
+				Sets how [keySymbol] repeats while it is held down, in place of the default.
+
+				Parameters:
+					keySymbol - The symbol of the key.
+					delay - The time, in milli-seconds, which the key must be held down before
+							it starts repeating.
+					interval - The time, in milli-seconds, between repeats.
+
+				A delay or interval below 1 stops the key from repeating. Repeats are timed
+				by the simulation clock, so they do not depend on the frame rate.
+
+				See Also:
+					<SDLKeyRepeater>
+			*/
+			void SetKeyRepeat(int keySymbol, int delay, int interval);
+			/*
+				Function: SetDefaultKeyRepeat
+
+				Sets how the keys which have not been given their own repeat with
+				<SDLInstance::SetKeyRepeat> repeat while they are held down. They start as
+				SDL_DEFAULT_REPEAT_DELAY and SDL_DEFAULT_REPEAT_INTERVAL.
+			*/
+			void SetDefaultKeyRepeat(int delay, int interval);
 			/*
 				Function: Run
 
@@ -298,6 +617,9 @@ namespace SDLInterfaceLibrary
 				with it through event handlers. It is highly reccomendable that you
 				finish setting up the application before running this function.
 
+				Each iteration advances the timer wheel by the real time which has passed,
+				in fixed steps of 1 millisecond, and then draws and presents a frame. Any
+				screen effect being played is drawn over the frame.
 			*/
 			void Run();
 			/*
@@ -309,7 +631,8 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: CleanUp
 
-				Cleans up the event handlers and other objects unrelated to sql.
+				Cleans up the event handlers and other objects unrelated to sql, and cancels
+				every timer. Must be called before the lua state is closed.
 
 			*/
 			void CleanUp();
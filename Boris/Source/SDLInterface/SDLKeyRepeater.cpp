@@ -0,0 +1,117 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLKeyRepeater.h>
+
+using namespace SDLInterfaceLibrary;
+
+SDLKeyRepeater::SDLKeyRepeater(int defaultDelay, int defaultInterval)
+{
+	SetDefaultRepeat(defaultDelay, defaultInterval);
+}
+
+const SDLKeyRepeater::KeyRepeat& SDLKeyRepeater::GetRepeat(int keySymbol) const
+{
+	map<int, KeyRepeat>::const_iterator boundKey = boundKeys.find(keySymbol);
+
+	if(boundKey != boundKeys.end())
+	{
+		return boundKey->second;
+	}
+
+	return defaultRepeat;
+}
+
+void SDLKeyRepeater::SetDefaultRepeat(int delay, int interval)
+{
+	defaultRepeat.delay = delay;
+	defaultRepeat.interval = interval;
+}
+
+void SDLKeyRepeater::SetRepeat(int keySymbol, int delay, int interval)
+{
+	KeyRepeat repeat;
+
+	repeat.delay = delay;
+	repeat.interval = interval;
+
+	boundKeys[keySymbol] = repeat;
+}
+
+void SDLKeyRepeater::ClearRepeat(int keySymbol)
+{
+	boundKeys.erase(keySymbol);
+}
+
+void SDLKeyRepeater::Press(int keySymbol)
+{
+	const KeyRepeat& repeat = GetRepeat(keySymbol);
+
+	//A key which is pressed again without being released starts over.
+	Release(keySymbol);
+
+	if(repeat.delay < 1 || repeat.interval < 1)
+	{
+		return;
+	}
+
+	HeldKey heldKey;
+
+	heldKey.keySymbol = keySymbol;
+	heldKey.timeUntilRepeat = repeat.delay;
+	heldKey.interval = repeat.interval;
+
+	heldKeys.push_back(heldKey);
+}
+
+void SDLKeyRepeater::Release(int keySymbol)
+{
+	for(vector<HeldKey>::iterator heldKey = heldKeys.begin(); heldKey != heldKeys.end(); heldKey++)
+	{
+		if(heldKey->keySymbol == keySymbol)
+		{
+			heldKeys.erase(heldKey);
+			return;
+		}
+	}
+}
+
+void SDLKeyRepeater::ReleaseAll()
+{
+	heldKeys.clear();
+}
+
+void SDLKeyRepeater::Advance(int elapsedTime, vector<int>& repeatedKeys)
+{
+	for(vector<HeldKey>::iterator heldKey = heldKeys.begin(); heldKey != heldKeys.end(); heldKey++)
+	{
+		heldKey->timeUntilRepeat -= elapsedTime;
+
+		while(heldKey->timeUntilRepeat <= 0)
+		{
+			repeatedKeys.push_back(heldKey->keySymbol);
+			heldKey->timeUntilRepeat += heldKey->interval;
+		}
+	}
+}
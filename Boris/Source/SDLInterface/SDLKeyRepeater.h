@@ -0,0 +1,135 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_KEY_REPEATER_H
+#define SDL_KEY_REPEATER_H
+
+#include <map>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLKeyRepeater
+
+		Generates the repeated key presses of keys which are held down, in place of SDL's
+		own key repeat. Each key can be given it's own delay before it starts repeating
+		(The delayed auto shift) and interval between repeats (The auto repeat rate), while
+		every other key uses a default pair.
+
+		The repeater is advanced by the time which passes, rather than by frames, so a key
+		repeats at the same rate however fast frames are drawn. If more than one interval
+		passes in a single call to <SDLKeyRepeater::Advance>, the key repeats once for each.
+
+		See Also:
+			<SDLInstance::SetKeyRepeat>
+	*/
+	class SDLKeyRepeater
+	{
+		private:
+			//The delay and interval, in milli-seconds, of a key.
+			struct KeyRepeat
+			{
+				int delay;
+				int interval;
+			};
+
+			//A key which is held down, and the time left until it next repeats.
+			struct HeldKey
+			{
+				int keySymbol;
+				int timeUntilRepeat;
+				int interval;
+			};
+
+			KeyRepeat defaultRepeat;
+			map<int, KeyRepeat> boundKeys;
+
+			//The keys which are held down and repeat, in the order they were pressed.
+			vector<HeldKey> heldKeys;
+
+			const KeyRepeat& GetRepeat(int keySymbol) const;
+		public:
+			/*
+				Constructor: SDLKeyRepeater
+
+				Parameters:
+					defaultDelay - The time, in milli-seconds, which a key must be held down
+								   before it starts repeating.
+					defaultInterval - The time, in milli-seconds, between repeats.
+			*/
+			SDLKeyRepeater(int defaultDelay, int defaultInterval);
+			/*
+				Function: SetDefaultRepeat
+
+				Sets the delay and interval of every key which has not been given it's own.
+				A delay or interval below 1 stops those keys from repeating. Keys which are
+				already held down are not affected until they are pressed again.
+			*/
+			void SetDefaultRepeat(int delay, int interval);
+			/*
+				Function: SetRepeat
+
+				Gives [keySymbol] it's own delay and interval, in milli-seconds. A delay or
+				interval below 1 stops the key from repeating.
+			*/
+			void SetRepeat(int keySymbol, int delay, int interval);
+			/*
+				Function: ClearRepeat
+
+				Makes [keySymbol] use the default delay and interval again.
+			*/
+			void ClearRepeat(int keySymbol);
+			/*
+				Function: Press
+
+				Starts timing the repeats of [keySymbol], from the current time.
+			*/
+			void Press(int keySymbol);
+			/*
+				Function: Release
+
+				Stops [keySymbol] from repeating.
+			*/
+			void Release(int keySymbol);
+			/*
+				Function: ReleaseAll
+
+				Stops every key from repeating, such as when the window loses the keyboard.
+			*/
+			void ReleaseAll();
+			/*
+				Function: Advance
+
+				Advances the time by [elapsedTime] milli-seconds, and appends the symbol of
+				each key which repeated during it to [repeatedKeys].
+			*/
+			void Advance(int elapsedTime, vector<int>& repeatedKeys);
+	};
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_MUTEX_H
+#define SDL_MUTEX_H
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_mutex.h>
+
+#include <SDLInterface/SDLException.h>
+#include <Helpers/IUncopyable.h>
+
+/*
+	File: SDLMutex.h
+	Contains the declarations of SDLMutex and SDLMutexLock.
+*/
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLMutex
+
+		Wraps an SDL mutex, which is used to share data between the main thread and the
+		threads which load resources.
+	*/
+	class SDLMutex: public IUncopyable
+	{
+		private:
+			SDL_mutex* mutex;
+
+		public:
+			/*
+				Constructor: SDLMutex
+
+				Creates an unlocked mutex.
+
+				Throws:
+					SDLException - If SDL could not create the mutex.
+			*/
+			SDLMutex();
+			/*
+				Function: Lock
+
+				Waits until no other thread holds the mutex, and takes it.
+			*/
+			void Lock();
+			/*
+				Function: Unlock
+
+				Releases the mutex, which must be held by the calling thread.
+			*/
+			void Unlock();
+			~SDLMutex();
+	};
+
+	/*
+		Class: SDLMutexLock
+
+		Holds an <SDLMutex> for as long as it is in scope, so that the mutex is released
+		even when an exception is thrown.
+	*/
+	class SDLMutexLock: public IUncopyable
+	{
+		private:
+			SDLMutex& mutex;
+
+		public:
+			/*
+				Constructor: SDLMutexLock
+
+				Parameters:
+					mutex - The mutex which will be held.
+			*/
+			SDLMutexLock(SDLMutex& mutex);
+			~SDLMutexLock();
+	};
+}
+
+#endif
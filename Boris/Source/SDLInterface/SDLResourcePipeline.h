@@ -1,4 +1,4 @@
-/*
+/*
 	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
 
 	This software is provided 'as-is', without any express or
@@ -19,7 +19,7 @@
 	   and must not be misrepresented as being the original software.
 
 	3. This notice may not be removed or altered from any
-	   source distribution.
+	   source distribution.
 */
 
 #ifndef SDL_RESOURCE_PIPELINE_H
@@ -27,6 +27,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <sstream>
 #include <iterator>
 
@@ -35,10 +36,14 @@
 
 
 #include <SDLInterface/ResourceException.h>
+#include <SDLInterface/SDLInstance.h>
 #include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/SDLTrunkLoader.h>
+#include <EventHandling/GenericEventHandler.h>
 #include <Helpers/IUncopyable.h>
 
 using namespace std;
+using namespace EventHandling;
 
 namespace SDLInterfaceLibrary
 {
@@ -61,12 +66,72 @@ namespace SDLInterfaceLibrary
 	{
 
 		private:
-			//The trunks currently loaded into memory.
+			//The trunks currently loaded into memory, including those which are still being
+			//loaded in the background.
 			map<string, ResourceTrunkType*> trunks;
 
-			//Checks if a trunk has been loaded into memory.
+			//The loaders of the trunks which are still being loaded in the background.
+			map<string, SDLTrunkLoader*> trunkLoaders;
+
+			//The handlers which will be raised once each trunk has been loaded.
+			map<string, GenericEventHandlerCollection*> trunkLoadedHandlers;
+
+			//Waits for trunk [trunkName] to finish loading in the background. If it could not
+			//be loaded, it is unloaded and the error is passed on.
+			void finishLoading(const string& trunkName)
+			{
+				SDLTrunkLoader* trunkLoader = trunkLoaders[trunkName];
+				trunkLoaders.erase(trunkName);
+
+				try
+				{
+					trunkLoader->Wait();
+				}
+				catch(ResourceException&)
+				{
+					delete trunkLoader;
+					deleteTrunk(trunkName);
+
+					throw;
+				}
+
+				delete trunkLoader;
+			}
+
+			//Unloads trunk [trunkName], stopping it from loading if it still is, and forgets its
+			//loaded handlers without raising them.
+			void deleteTrunk(const string& trunkName)
+			{
+				typename map<string, SDLTrunkLoader*>::iterator trunkLoader = trunkLoaders.find(trunkName);
+
+				if(trunkLoader != trunkLoaders.end())
+				{
+					delete trunkLoader->second;
+					trunkLoaders.erase(trunkLoader);
+				}
+
+				typename map<string, GenericEventHandlerCollection*>::iterator loadedHandlers =
+					trunkLoadedHandlers.find(trunkName);
+
+				if(loadedHandlers != trunkLoadedHandlers.end())
+				{
+					delete loadedHandlers->second;
+					trunkLoadedHandlers.erase(loadedHandlers);
+				}
+
+				delete trunks[trunkName];
+				trunks.erase(trunkName);
+			}
+
+			//Checks if a trunk has been loaded into memory, and waits for it if it is still
+			//being loaded in the background.
 			void checkTrunk(string& trunkName)
 			{
+				if(trunkLoaders.find(trunkName) != trunkLoaders.end())
+				{
+					finishLoading(trunkName);
+				}
+
 				if(trunks[trunkName] == NULL)
 				{
 					string error = "Error in Resource Pipeline: Trunk ";
@@ -126,7 +191,10 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: LoadResourceTrunk
 
-				Loads trunk [trunkName] into memory.
+				Loads trunk [trunkName]. Its resources are decoded into memory when they are first
+				retrieved, or when they are prefetched. If the trunk is already being loaded in
+				the background, this waits for it instead, and if it has already been loaded
+				nothing is done.
 
 				Parameters:
 					trunkName - The name of the trunk which will be loaded into memory.
@@ -134,8 +202,172 @@ namespace SDLInterfaceLibrary
 			*/
 			void LoadResourceTrunk(const string& trunkName)
 			{
-				trunks[trunkName] = new ResourceTrunkType(trunkName);
-				trunks[trunkName]->LoadResources();
+				if(trunkLoaders.find(trunkName) != trunkLoaders.end())
+				{
+					finishLoading(trunkName);
+					return;
+				}
+
+				if(trunks[trunkName] != NULL)
+				{
+					return;
+				}
+
+				ResourceTrunkType* trunk = new ResourceTrunkType(trunkName);
+
+				try
+				{
+					trunk->LoadResources();
+				}
+				catch(ApplicationException&)
+				{
+					delete trunk;
+					trunks.erase(trunkName);
+
+					throw;
+				}
+
+				trunks[trunkName] = trunk;
+			}
+			/*
+				Function: LoadResourceTrunkAsync
+
+				Starts loading trunk [trunkName], and decoding all of its resources, on a thread
+				of its own, so that the main loop keeps running in the meantime. The resources are
+				handed to the trunk by <SDLResourcePipeline::DispatchLoadedTrunks>, which raises
+				the returned handlers once the trunk has been loaded completely. If the trunk has
+				already been loaded, or is being loaded, it is not loaded again, but the handlers
+				are still raised.
+
+				The trunk can be used before then, in which case the main thread waits for it to
+				finish loading.
+
+				While input is recorded or replayed, the trunk is waited for before this returns,
+				since the frame on which it would finish loading in the background depends on
+				the disk and on the scheduler. Its handlers are then raised on the same frame of
+				a replay as of the run it was recorded from.
+
+				Parameters:
+					trunkName - The name of the trunk which will be loaded into memory.
+
+				Returns:
+					A read/write reference to the handlers which are raised once the trunk has
+					been loaded.
+
+				Throws:
+					ResourceException - If the trunk was waited for, and could not be loaded. The
+										trunk is unloaded.
+			*/
+			GenericEventHandlerCollection& LoadResourceTrunkAsync(const string& trunkName)
+			{
+				if(trunks[trunkName] == NULL)
+				{
+					ResourceTrunkType* trunk = new ResourceTrunkType(trunkName);
+
+					try
+					{
+						trunkLoaders[trunkName] = new SDLTrunkLoader(trunk, trunkName);
+					}
+					catch(ApplicationException&)
+					{
+						delete trunk;
+						trunks.erase(trunkName);
+						trunkLoaders.erase(trunkName);
+
+						throw;
+					}
+
+					trunks[trunkName] = trunk;
+				}
+
+				SDLInstance& sdlInstance = SDLInstance::GetInstance();
+
+				if(trunkLoaders.find(trunkName) != trunkLoaders.end() &&
+					(sdlInstance.IsRecordingInput() || sdlInstance.IsReplayingInput()))
+				{
+					finishLoading(trunkName);
+				}
+
+				if(trunkLoadedHandlers[trunkName] == NULL)
+				{
+					trunkLoadedHandlers[trunkName] = new GenericEventHandlerCollection();
+				}
+
+				return *trunkLoadedHandlers[trunkName];
+			}
+			/*
+				Function: DispatchLoadedTrunks
+
+				Hands the resources which have been decoded in the background to their trunks, and
+				raises the loaded handlers of every trunk which has finished loading. It should be
+				called by the main thread, once a frame.
+
+				Throws:
+					ResourceException - If a trunk could not be loaded. The trunk is unloaded.
+			*/
+			void DispatchLoadedTrunks()
+			{
+				vector<string> loadedTrunks;
+
+				for(typename map<string, SDLTrunkLoader*>::iterator trunkLoader = trunkLoaders.begin();
+					trunkLoader != trunkLoaders.end();
+					trunkLoader++)
+				{
+					bool trunkLoaded = false;
+
+					try
+					{
+						trunkLoaded = trunkLoader->second->AddDecodedResources();
+					}
+					catch(ResourceException&)
+					{
+						//The name is copied, since deleting the trunk erases the loader's entry.
+						string failedTrunk = trunkLoader->first;
+						deleteTrunk(failedTrunk);
+
+						throw;
+					}
+
+					if(trunkLoaded)
+					{
+						loadedTrunks.push_back(trunkLoader->first);
+					}
+				}
+
+				for(vector<string>::iterator loadedTrunk = loadedTrunks.begin();
+					loadedTrunk != loadedTrunks.end();
+					loadedTrunk++)
+				{
+					delete trunkLoaders[*loadedTrunk];
+					trunkLoaders.erase(*loadedTrunk);
+				}
+
+				//The handlers are taken out before they are raised, since they may load or unload
+				//trunks themselves.
+				vector<GenericEventHandlerCollection*> handlersToRaise;
+
+				for(typename map<string, GenericEventHandlerCollection*>::iterator loadedHandlers =
+						trunkLoadedHandlers.begin();
+					loadedHandlers != trunkLoadedHandlers.end();)
+				{
+					if(trunkLoaders.find(loadedHandlers->first) == trunkLoaders.end())
+					{
+						handlersToRaise.push_back(loadedHandlers->second);
+						trunkLoadedHandlers.erase(loadedHandlers++);
+					}
+					else
+					{
+						loadedHandlers++;
+					}
+				}
+
+				for(vector<GenericEventHandlerCollection*>::iterator loadedHandlers = handlersToRaise.begin();
+					loadedHandlers != handlersToRaise.end();
+					loadedHandlers++)
+				{
+					(*loadedHandlers)->RaiseEvents();
+					delete *loadedHandlers;
+				}
 			}
 			/*
 				Function: UnloadResourceTrunk
@@ -148,18 +380,39 @@ namespace SDLInterfaceLibrary
 			*/
 			void UnloadResourceTrunk(string& trunkName)
 			{
-				checkTrunk(trunkName);
-				delete trunks[trunkName];
+				if(trunkLoaders.find(trunkName) == trunkLoaders.end())
+				{
+					checkTrunk(trunkName);
+				}
 
-				trunks.erase(trunkName);
+				deleteTrunk(trunkName);
 			}
 			/*
 				Function: UnloadAllTrunks
 
-				Unloads all trunks from memory.
+				Unloads all trunks from memory, including those which are still being loaded. Since
+				the loaded handlers of those are deleted, it must be called before the Lua
+				state they refer to is closed.
 			*/
 			void UnloadAllTrunks()
 			{
+				for(typename map<string, SDLTrunkLoader*>::iterator trunkLoader = trunkLoaders.begin();
+					trunkLoader != trunkLoaders.end();
+					trunkLoader++)
+				{
+					delete trunkLoader->second;
+				}
+				trunkLoaders.clear();
+
+				for(typename map<string, GenericEventHandlerCollection*>::iterator loadedHandlers =
+						trunkLoadedHandlers.begin();
+					loadedHandlers != trunkLoadedHandlers.end();
+					loadedHandlers++)
+				{
+					delete loadedHandlers->second;
+				}
+				trunkLoadedHandlers.clear();
+
 				for(typename map<string, ResourceTrunkType*>::iterator currentTrunk = trunks.begin();
 					currentTrunk != trunks.end();
 					currentTrunk++)
@@ -168,6 +421,33 @@ namespace SDLInterfaceLibrary
 				}
 				trunks.clear();
 			}
+			/*
+				Function: PrefetchResources
+
+				Decodes every resource named in [resourceNames] in trunk [trunkName], so that they
+				are ready when they are first retrieved. They are decoded on several threads at once.
+
+				Parameters:
+					trunkName - The name of the trunk which contains the resources.
+					resourceNames - The names of the resources which will be decoded.
+			*/
+			void PrefetchResources(string& trunkName, const vector<string>& resourceNames)
+			{
+				checkTrunk(trunkName);
+				trunks[trunkName]->PrefetchResources(resourceNames);
+			}
+			/*
+				Function: GetDecodeTimes
+
+				Returns:
+					How long each resource of trunk [trunkName] which has been decoded took to
+					decode, in micro-seconds, by type and name.
+			*/
+			const map< pair<ResourceType, string>, int >& GetDecodeTimes(string& trunkName)
+			{
+				checkTrunk(trunkName);
+				return trunks[trunkName]->GetDecodeTimes();
+			}
 			/*
 				Function: GetImage
 
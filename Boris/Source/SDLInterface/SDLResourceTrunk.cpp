@@ -1,4 +1,4 @@
-/*
+/*
 	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
 
 	This software is provided 'as-is', without any express or
@@ -19,21 +19,292 @@
 	   and must not be misrepresented as being the original software.
 
 	3. This notice may not be removed or altered from any
-	   source distribution.
+	   source distribution.
 */
 
 #include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/SDLDecodePool.h>
+
+#include <set>
+#include <chrono>
 
 using namespace std;
 
+ImageFormatKey::ImageFormatKey(const SDL_Surface* screen)
+{
+	bitsPerPixel = screen->format->BitsPerPixel;
+
+	redMask = screen->format->Rmask;
+	greenMask = screen->format->Gmask;
+	blueMask = screen->format->Bmask;
+
+	hardware = (screen->flags & SDL_HWSURFACE) != 0;
+}
+
+bool ImageFormatKey::operator<(const ImageFormatKey& other) const
+{
+	if(bitsPerPixel != other.bitsPerPixel)
+	{
+		return bitsPerPixel < other.bitsPerPixel;
+	}
+
+	if(redMask != other.redMask)
+	{
+		return redMask < other.redMask;
+	}
+
+	if(greenMask != other.greenMask)
+	{
+		return greenMask < other.greenMask;
+	}
+
+	if(blueMask != other.blueMask)
+	{
+		return blueMask < other.blueMask;
+	}
+
+	return hardware < other.hardware;
+}
+
+void SDLInterfaceLibrary::FreeDecodedResource(const DecodedResource& resource)
+{
+	switch(resource.type)
+	{
+		case RESOURCE_TYPE_IMAGE:
+			SDL_FreeSurface(resource.image);
+			break;
+
+		case RESOURCE_TYPE_MUSIC:
+			Mix_FreeMusic(resource.music);
+			break;
+
+		case RESOURCE_TYPE_SOUND:
+			Mix_FreeChunk(resource.sound);
+			break;
+	}
+}
+
 ISDLResourceTrunk::ISDLResourceTrunk(const string& name)
 {
 	this->name = name;
 }
 
+SDL_Surface* ISDLResourceTrunk::ConvertImage(SDL_Surface* image)
+{
+	SDL_Surface* convertedImage = NULL;
+
+	if(image->format->Amask != 0)
+	{
+		convertedImage = SDL_DisplayFormatAlpha(image);
+	}
+	else
+	{
+		convertedImage = SDL_DisplayFormat(image);
+	}
+
+	if(convertedImage == NULL)
+	{
+		throw SDLException();
+	}
+
+	//Colour keyed images are run length encoded, so that their transparent pixels are
+	//skipped rather than tested one by one.
+	if(image->flags & SDL_SRCCOLORKEY)
+	{
+		if(SDL_SetColorKey(convertedImage, SDL_SRCCOLORKEY | SDL_RLEACCEL, convertedImage->format->colorkey) == -1)
+		{
+			SDL_FreeSurface(convertedImage);
+			throw SDLException();
+		}
+	}
+
+	return convertedImage;
+}
+
+bool ISDLResourceTrunk::Decode(ResourceType type, const string& resourceName, DecodedResource& resource) const
+{
+	chrono::steady_clock::time_point decodeStart = chrono::steady_clock::now();
+
+	resource.type = type;
+	resource.name = resourceName;
+	resource.image = NULL;
+	resource.music = NULL;
+	resource.sound = NULL;
+
+	if(!DecodeResource(type, resourceName, resource))
+	{
+		return false;
+	}
+
+	resource.decodeTime = (int)chrono::duration_cast<chrono::microseconds>(
+		chrono::steady_clock::now() - decodeStart).count();
+
+	return true;
+}
+
+void ISDLResourceTrunk::StoreResource(const DecodedResource& resource) const
+{
+	bool stored = false;
+
+	switch(resource.type)
+	{
+		case RESOURCE_TYPE_IMAGE:
+			stored = images.insert(make_pair(resource.name, resource.image)).second;
+			break;
+
+		case RESOURCE_TYPE_MUSIC:
+			stored = music.insert(make_pair(resource.name, resource.music)).second;
+			break;
+
+		case RESOURCE_TYPE_SOUND:
+			stored = sound.insert(make_pair(resource.name, resource.sound)).second;
+			break;
+	}
+
+	if(stored)
+	{
+		decodeTimes[make_pair(resource.type, resource.name)] = resource.decodeTime;
+	}
+	else
+	{
+		FreeDecodedResource(resource);
+	}
+}
+
+bool ISDLResourceTrunk::DecodeOnRequest(ResourceType type, const string& resourceName) const
+{
+	DecodedResource resource;
+
+	if(!Decode(type, resourceName, resource))
+	{
+		return false;
+	}
+
+	StoreResource(resource);
+
+	return true;
+}
+
+void ISDLResourceTrunk::AddResource(const DecodedResource& resource)
+{
+	StoreResource(resource);
+}
+
+bool ISDLResourceTrunk::IsDecoded(ResourceType type, const string& resourceName) const
+{
+	switch(type)
+	{
+		case RESOURCE_TYPE_IMAGE:
+			return images.find(resourceName) != images.end();
+
+		case RESOURCE_TYPE_MUSIC:
+			return music.find(resourceName) != music.end();
+
+		case RESOURCE_TYPE_SOUND:
+			return sound.find(resourceName) != sound.end();
+	}
+
+	return false;
+}
+
+void ISDLResourceTrunk::DecodeInParallel(const vector< pair<ResourceType, string> >& resourceList,
+	int numberOfThreads)
+{
+	vector< pair<ResourceType, string> > resourcesToDecode;
+
+	for(vector< pair<ResourceType, string> >::const_iterator currentResource = resourceList.begin();
+		currentResource != resourceList.end();
+		currentResource++)
+	{
+		if(!IsDecoded(currentResource->first, currentResource->second))
+		{
+			resourcesToDecode.push_back(*currentResource);
+		}
+	}
+
+	if(resourcesToDecode.empty())
+	{
+		return;
+	}
+
+	SDLDecodePool decodePool(*this, resourcesToDecode);
+	decodePool.Run(numberOfThreads);
+
+	//The resources are stored once they have all been decoded, in the order they were listed
+	//in, however the threads happened to finish.
+	vector<DecodedResource> decodedResources;
+	decodePool.TakeDecodedResources(decodedResources);
+
+	for(vector<DecodedResource>::iterator currentResource = decodedResources.begin();
+		currentResource != decodedResources.end();
+		currentResource++)
+	{
+		StoreResource(*currentResource);
+	}
+}
+
+void ISDLResourceTrunk::PrefetchResources(const vector<string>& resourceNames, int numberOfThreads)
+{
+	set<string> namesToFind(resourceNames.begin(), resourceNames.end());
+	set<string> namesFound;
+
+	vector< pair<ResourceType, string> > resourceList = GetResourceList();
+	vector< pair<ResourceType, string> > resourcesToPrefetch;
+
+	for(vector< pair<ResourceType, string> >::iterator currentResource = resourceList.begin();
+		currentResource != resourceList.end();
+		currentResource++)
+	{
+		if(namesToFind.find(currentResource->second) != namesToFind.end())
+		{
+			resourcesToPrefetch.push_back(*currentResource);
+			namesFound.insert(currentResource->second);
+		}
+	}
+
+	for(vector<string>::const_iterator resourceName = resourceNames.begin();
+		resourceName != resourceNames.end();
+		resourceName++)
+	{
+		if(namesFound.find(*resourceName) == namesFound.end())
+		{
+			stringstream error;
+
+			error << "Error in trunk " << name << ": ";
+			error << "Resource '" << *resourceName << "' ";
+			error << "does not exist";
+
+			throw ResourceException(error.str().c_str());
+		}
+	}
+
+	DecodeInParallel(resourcesToPrefetch, numberOfThreads);
+
+	//Converts the images too, which has to be done on the main thread.
+	for(vector< pair<ResourceType, string> >::iterator currentResource = resourcesToPrefetch.begin();
+		currentResource != resourcesToPrefetch.end();
+		currentResource++)
+	{
+		if(currentResource->first == RESOURCE_TYPE_IMAGE)
+		{
+			GetImage(currentResource->second);
+		}
+	}
+}
+
+void ISDLResourceTrunk::DecodeAllResources(int numberOfThreads)
+{
+	DecodeInParallel(GetResourceList(), numberOfThreads);
+}
+
+const map< pair<ResourceType, string>, int >& ISDLResourceTrunk::GetDecodeTimes() const
+{
+	return decodeTimes;
+}
+
 SDL_Surface* ISDLResourceTrunk::GetImage(string& imageName) const
 {
-	if(images.find(imageName) == images.end())
+	if(images.find(imageName) == images.end() && !DecodeOnRequest(RESOURCE_TYPE_IMAGE, imageName))
 	{
 		stringstream error;
 
@@ -43,15 +314,29 @@ SDL_Surface* ISDLResourceTrunk::GetImage(string& imageName) const
 
 		throw ResourceException(error.str().c_str());
 	}
-	else
+
+	SDL_Surface* screen = SDL_GetVideoSurface();
+
+	if(screen == NULL)
 	{
 		return images.at(imageName);
 	}
+
+	map<string, SDL_Surface*>& screenImages = convertedImages[ImageFormatKey(screen)];
+	map<string, SDL_Surface*>::iterator convertedImage = screenImages.find(imageName);
+
+	if(convertedImage == screenImages.end())
+	{
+		//The image has not been requested since it was decoded, or since the video mode changed.
+		convertedImage = screenImages.insert(make_pair(imageName, ConvertImage(images.at(imageName)))).first;
+	}
+
+	return convertedImage->second;
 }
 
 Mix_Music* ISDLResourceTrunk::GetMusic(string& musicName) const
 {
-	if(music.find(musicName) == music.end())
+	if(music.find(musicName) == music.end() && !DecodeOnRequest(RESOURCE_TYPE_MUSIC, musicName))
 	{
 		stringstream error;
 
@@ -69,7 +354,7 @@ Mix_Music* ISDLResourceTrunk::GetMusic(string& musicName) const
 
 Mix_Chunk* ISDLResourceTrunk::GetSound(string& soundName) const
 {
-	if(sound.find(soundName) == sound.end())
+	if(sound.find(soundName) == sound.end() && !DecodeOnRequest(RESOURCE_TYPE_SOUND, soundName))
 	{
 		stringstream error;
 
@@ -94,6 +379,18 @@ ISDLResourceTrunk::~ISDLResourceTrunk()
 		SDL_FreeSurface(currentImage->second);
 	}
 
+	for(map< ImageFormatKey, map<string, SDL_Surface*> >::iterator currentFormat = convertedImages.begin();
+		currentFormat != convertedImages.end();
+		currentFormat++)
+	{
+		for(map<string, SDL_Surface*>::iterator currentImage = currentFormat->second.begin();
+			currentImage != currentFormat->second.end();
+			currentImage++)
+		{
+			SDL_FreeSurface(currentImage->second);
+		}
+	}
+
 
 	for(map<string, Mix_Music*>::iterator currentMusic = music.begin();
 		currentMusic != music.end();
@@ -127,17 +424,17 @@ void FolderResourceTrunk::LoadResources()
 	{
 		if(currentFile->GetType().compare("bmp") == 0)
 		{
-			images[currentFile->GetName()] = LoadImage(currentFile);
+			resourcePaths[make_pair(RESOURCE_TYPE_IMAGE, currentFile->GetName())] = currentFile->GetPath();
 		}
 
 		if(currentFile->GetType().compare("ogg") == 0)
 		{
-			music[currentFile->GetName()] = LoadMusic(currentFile);
+			resourcePaths[make_pair(RESOURCE_TYPE_MUSIC, currentFile->GetName())] = currentFile->GetPath();
 		}
 
 		if(currentFile->GetType().compare("wav") == 0)
 		{
-			sound[currentFile->GetName()] = LoadSound(currentFile);
+			resourcePaths[make_pair(RESOURCE_TYPE_SOUND, currentFile->GetName())] = currentFile->GetPath();
 		}
 
 		delete currentFile;
@@ -145,31 +442,67 @@ void FolderResourceTrunk::LoadResources()
 	}
 }
 
+vector< pair<ResourceType, string> > FolderResourceTrunk::GetResourceList() const
+{
+	vector< pair<ResourceType, string> > resourceList;
 
-SDL_Surface* FolderResourceTrunk::LoadImage(const FileInfo* file)
+	for(map< pair<ResourceType, string>, string >::const_iterator resourcePath = resourcePaths.begin();
+		resourcePath != resourcePaths.end();
+		resourcePath++)
+	{
+		resourceList.push_back(resourcePath->first);
+	}
+
+	return resourceList;
+}
+
+bool FolderResourceTrunk::DecodeResource(ResourceType type, const string& resourceName, DecodedResource& resource) const
 {
-	//Load the image from the hard disk.
-	SDL_Surface* loadedImage = SDL_LoadBMP(file->GetPath().c_str());
-	SDL_Surface* optimizedImage = NULL;
+	map< pair<ResourceType, string>, string >::const_iterator resourcePath =
+		resourcePaths.find(make_pair(type, resourceName));
 
-	if(loadedImage != NULL)
+	if(resourcePath == resourcePaths.end())
 	{
-		//Return screen optimized version of the image.
-		optimizedImage = SDL_DisplayFormat(loadedImage);
-		SDL_FreeSurface(loadedImage);
+		return false;
 	}
-	else
+
+	switch(type)
+	{
+		case RESOURCE_TYPE_IMAGE:
+			resource.image = LoadImage(resourcePath->second);
+			break;
+
+		case RESOURCE_TYPE_MUSIC:
+			resource.music = LoadMusic(resourcePath->second);
+			break;
+
+		case RESOURCE_TYPE_SOUND:
+			resource.sound = LoadSound(resourcePath->second);
+			break;
+	}
+
+	return true;
+}
+
+
+SDL_Surface* FolderResourceTrunk::LoadImage(const string& path) const
+{
+	//Load the image from the hard disk.
+	SDL_Surface* loadedImage = SDL_LoadBMP(path.c_str());
+
+	//The image is converted to the screen's format by GetImage.
+	if(loadedImage == NULL)
 	{
 		throw SDLException();
 	}
 
-	return optimizedImage;
+	return loadedImage;
 }
 
-Mix_Music* FolderResourceTrunk::LoadMusic(const FileInfo* file)
+Mix_Music* FolderResourceTrunk::LoadMusic(const string& path) const
 {
 	//Load the music from the hard disk.
-	Mix_Music* loadedMusic = Mix_LoadMUS(file->GetPath().c_str());
+	Mix_Music* loadedMusic = Mix_LoadMUS(path.c_str());
 
 	if(loadedMusic == NULL)
 	{
@@ -179,10 +512,10 @@ Mix_Music* FolderResourceTrunk::LoadMusic(const FileInfo* file)
 	return loadedMusic;
 }
 
-Mix_Chunk* FolderResourceTrunk::LoadSound(const FileInfo* file)
+Mix_Chunk* FolderResourceTrunk::LoadSound(const string& path) const
 {
 	//Load the music from the hard disk.
-	Mix_Chunk* loadedSound = Mix_LoadWAV(file->GetPath().c_str());
+	Mix_Chunk* loadedSound = Mix_LoadWAV(path.c_str());
 
 	if(loadedSound == NULL)
 	{
@@ -194,26 +527,20 @@ Mix_Chunk* FolderResourceTrunk::LoadSound(const FileInfo* file)
 
 
 
-SDL_Surface* FileResourceTrunk::LoadImage(SDL_RWops* resourceMemory)
+SDL_Surface* FileResourceTrunk::LoadImage(SDL_RWops* resourceMemory) const
 {
 	SDL_Surface* loadedImage = SDL_LoadBMP_RW(resourceMemory, 0);
-	SDL_Surface* optimizedImage = NULL;
 
-	if(loadedImage != NULL)
-	{
-		//Return screen optimized version of the image.
-		optimizedImage = SDL_DisplayFormat(loadedImage);
-		SDL_FreeSurface(loadedImage);
-	}
-	else
+	//The image is converted to the screen's format by GetImage.
+	if(loadedImage == NULL)
 	{
 		throw SDLException();
 	}
 
-	return optimizedImage;
+	return loadedImage;
 }
 
-Mix_Music* FileResourceTrunk::LoadMusic(SDL_RWops* resourceMemory)
+Mix_Music* FileResourceTrunk::LoadMusic(SDL_RWops* resourceMemory) const
 {
 	Mix_Music* loadedMusic = Mix_LoadMUS_RW(resourceMemory);
 
@@ -225,7 +552,7 @@ Mix_Music* FileResourceTrunk::LoadMusic(SDL_RWops* resourceMemory)
 	return loadedMusic;
 }
 
-Mix_Chunk* FileResourceTrunk::LoadSound(SDL_RWops* resourceMemory)
+Mix_Chunk* FileResourceTrunk::LoadSound(SDL_RWops* resourceMemory) const
 {
 	Mix_Chunk* loadedSound = Mix_LoadWAV_RW(resourceMemory, 0);
 
@@ -242,62 +569,191 @@ FileResourceTrunk::FileResourceTrunk(const string& name): ISDLResourceTrunk(name
 {
 };
 
+void FileResourceTrunk::CheckEntry(const ResourcePackEntry& entry, const char* file) const
+{
+	if(entry.hash != 0 && HashResourceData(file, (size_t)entry.size) != entry.hash)
+	{
+		stringstream error;
+
+		error << "Error in trunk " << name << ": ";
+		error << "Resource '" << entry.name << "' is corrupt";
+
+		throw ResourceException(error.str().c_str());
+	}
+}
+
+char* FileResourceTrunk::ReadEntry(const ResourcePackEntry& entry) const
+{
+	char* file = new char[(size_t)entry.size];
+	Uint64 bytesRead = 0;
+
+	{
+		SDLMutexLock trunkFileHeld(trunkFileLock);
+
+		trunkFile.clear();
+		trunkFile.seekg((streamoff)entry.offset, ios_base::beg);
+		trunkFile.read(file, (streamsize)entry.size);
+
+		bytesRead = (Uint64)trunkFile.gcount();
+	}
+
+	if(bytesRead != entry.size)
+	{
+		delete [] file;
+
+		stringstream error;
+
+		error << "Error in trunk " << name << ": ";
+		error << "Resource '" << entry.name << "' could not be read";
+
+		throw ResourceException(error.str().c_str());
+	}
+
+	try
+	{
+		CheckEntry(entry, file);
+	}
+	catch(ResourceException&)
+	{
+		delete [] file;
+		throw;
+	}
+
+	return file;
+}
+
+void FileResourceTrunk::DecodeEntry(const ResourcePackEntry& entry, SDL_RWops* resourceMemory,
+	DecodedResource& resource) const
+{
+	switch(entry.type)
+	{
+		case RESOURCE_TYPE_IMAGE:
+			resource.image = LoadImage(resourceMemory);
+			break;
+
+		case RESOURCE_TYPE_MUSIC:
+			resource.music = LoadMusic(resourceMemory);
+			break;
+
+		case RESOURCE_TYPE_SOUND:
+			resource.sound = LoadSound(resourceMemory);
+			break;
+	}
+}
+
 void FileResourceTrunk::LoadResources()
 {
-	fstream trunkFile(name.c_str(), fstream::in | fstream::binary);
+	trunkFile.open(name.c_str(), fstream::in | fstream::binary);
+
+	index.Read(trunkFile, name);
+}
 
-	char numberOfFiles = trunkFile.get();
+vector< pair<ResourceType, string> > FileResourceTrunk::GetResourceList() const
+{
+	vector< pair<ResourceType, string> > resourceList;
 
-	for(int i = 0; i < (int)numberOfFiles; i++)
+	//The resources are listed in the order they are stored in, so that reading them all
+	//goes through the file once.
+	for(vector<ResourcePackEntry>::const_iterator currentEntry = index.GetEntries().begin();
+		currentEntry != index.GetEntries().end();
+		currentEntry++)
 	{
-		//Get type
-		char resourceType = trunkFile.get();
+		resourceList.push_back(make_pair(currentEntry->type, currentEntry->name));
+	}
 
-		//Get name length
-		char nameLength = trunkFile.get();
+	return resourceList;
+}
 
-		//Get name
-		char* name = new char[nameLength];
-		trunkFile.read(name, (int)nameLength);
+bool FileResourceTrunk::DecodeResource(ResourceType type, const string& resourceName, DecodedResource& resource) const
+{
+	const ResourcePackEntry* entry = index.Find(type, resourceName);
 
-		//Get file
-		int fileLength;
-		trunkFile >> fileLength;
+	if(entry == NULL)
+	{
+		return false;
+	}
 
-		char* file = new char[fileLength];
-		trunkFile.read(file, fileLength);
+	//The entry is read from where the table of contents places it.
+	char* file = ReadEntry(*entry);
 
-		SDL_RWops* rwopsPointer = SDL_RWFromMem((void*)file, fileLength);
+	SDL_RWops* rwopsPointer = SDL_RWFromMem((void*)file, (int)entry->size);
 
-		if(rwopsPointer == NULL)
-		{
-			throw SDLException();
-		}
+	if(rwopsPointer == NULL)
+	{
+		delete [] file;
+		throw SDLException();
+	}
 
-		switch((ResourceType)resourceType)
-		{
-			case RESOURCE_TYPE_IMAGE:
-				images[string(name, nameLength)] = LoadImage(rwopsPointer);
-				break;
+	DecodeEntry(*entry, rwopsPointer, resource);
 
-			case RESOURCE_TYPE_MUSIC:
-				music[string(name, nameLength)] = LoadMusic(rwopsPointer);
-				break;
+	//Free buffers, music data should not be freed because mixer
+	//actually accesses the same data.
+	if(type != RESOURCE_TYPE_MUSIC)
+	{
+		SDL_FreeRW(rwopsPointer);
+		delete [] file;
+	}
 
-			case RESOURCE_TYPE_SOUND:
-				sound[string(name, nameLength)] = LoadSound(rwopsPointer);
-				break;
-		}
+	return true;
+}
 
-		//Free buffers, music data should not be freed because mixer
-		//actually accesses the same data.
-		if(resourceType != RESOURCE_TYPE_MUSIC)
-		{
-			delete [] file;
-		}
 
-		delete [] name;
+MappedFileResourceTrunk::MappedFileResourceTrunk(const string& name): FileResourceTrunk(name)
+{
+	mappedFile = NULL;
+}
+
+void MappedFileResourceTrunk::LoadResources()
+{
+	mappedFile = new MappedFile(name);
+
+	index.Read(mappedFile->GetData(), mappedFile->GetSize(), name);
+}
+
+bool MappedFileResourceTrunk::DecodeResource(ResourceType type, const string& resourceName,
+	DecodedResource& resource) const
+{
+	const ResourcePackEntry* entry = index.Find(type, resourceName);
+
+	if(entry == NULL)
+	{
+		return false;
+	}
+
+	const char* file = mappedFile->GetData() + entry->offset;
+
+	CheckEntry(*entry, file);
+
+	//The resource is decoded in place, without being copied out of the mapping.
+	SDL_RWops* rwopsPointer = SDL_RWFromConstMem(file, (int)entry->size);
+
+	if(rwopsPointer == NULL)
+	{
+		throw SDLException();
+	}
+
+	DecodeEntry(*entry, rwopsPointer, resource);
+
+	//Music keeps reading from the mapping, and the mixer frees its RWops with it.
+	if(type != RESOURCE_TYPE_MUSIC)
+	{
+		SDL_FreeRW(rwopsPointer);
+	}
+
+	return true;
+}
+
+MappedFileResourceTrunk::~MappedFileResourceTrunk()
+{
+	//The music has to be freed before the memory it streams from is unmapped.
+	for(map<string, Mix_Music*>::iterator currentMusic = music.begin();
+		currentMusic != music.end();
+		currentMusic++)
+	{
+		Mix_FreeMusic(currentMusic->second);
 	}
 
-	trunkFile.close();
+	music.clear();
+
+	delete mappedFile;
 }
@@ -1,4 +1,4 @@
-/*
+/*
 	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
 
 	This software is provided 'as-is', without any express or
@@ -19,13 +19,14 @@
 	   and must not be misrepresented as being the original software.
 
 	3. This notice may not be removed or altered from any
-	   source distribution.
+	   source distribution.
 */
 
 #ifndef SDL_RESOURCE_TRUNK_H
 #define SDL_RESOURCE_TRUNK_H
 
 #include <map>
+#include <vector>
 #include <sstream>
 #include <fstream>
 
@@ -33,9 +34,12 @@
 #include <SDL/SDL_mixer.h>
 
 #include <SDLInterface/ResourceException.h>
+#include <SDLInterface/ResourcePack.h>
 #include <SDLInterface/SDLException.h>
 #include <SDLInterface/MixException.h>
+#include <SDLInterface/SDLMutex.h>
 #include <Helpers/DirectoryTraverser.h>
+#include <Helpers/MappedFile.h>
 #include <Helpers/IUncopyable.h>
 
 using namespace std;
@@ -46,22 +50,67 @@ using namespace SDLInterfaceLibrary;
 	Contains the declarations of ISDLResourceTrunk, and it's children.
 */
 namespace SDLInterfaceLibrary
-{	/*
-		Enum: ResourceType
+{
+	/*
+		Struct: ImageFormatKey
+
+		Identifies the pixel format of a screen, so that images can be converted once for
+		every format they are drawn in.
+	*/
+	struct ImageFormatKey
+	{
+		Uint8 bitsPerPixel;
+
+		Uint32 redMask;
+		Uint32 greenMask;
+		Uint32 blueMask;
+
+		//Hardware surfaces are converted separately, since SDL_DisplayFormat places the
+		//converted image in video memory for them.
+		bool hardware;
+
+		/*
+			Constructor: ImageFormatKey
+
+			Parameters:
+				screen - The screen whose format will be identified.
+		*/
+		ImageFormatKey(const SDL_Surface* screen);
+
+		bool operator<(const ImageFormatKey& other) const;
+	};
+
+	/*
+		Struct: DecodedResource
 
-		Used to identify the type of a resource.
+		A resource which has been decoded, but which has not been added to a trunk yet. Only
+		the member which matches its type is set.
 
-		RESOURCE_TYPE_IMAGE - Image resource
-		RESOURCE_TYPE_MUSIC - Music resource
-		RESOURCE_TYPE_SOUND - Sound resource
+		type - The type of the resource.
+		name - The name of the resource.
+		image - The image, in the format it was stored in.
+		music - The musical piece.
+		sound - The sound chunk.
+		decodeTime - How long the resource took to decode, in micro-seconds.
 	*/
-	enum ResourceType
+	struct DecodedResource
 	{
-		RESOURCE_TYPE_IMAGE,
-		RESOURCE_TYPE_MUSIC,
-		RESOURCE_TYPE_SOUND
+		ResourceType type;
+		string name;
+
+		SDL_Surface* image;
+		Mix_Music* music;
+		Mix_Chunk* sound;
+
+		int decodeTime;
 	};
 
+	/*
+		Function: FreeDecodedResource
+
+		Frees the image, musical piece or sound chunk of [resource].
+	*/
+	void FreeDecodedResource(const DecodedResource& resource);
 
 	/*
 		Class: ISDLResourceTrunk
@@ -75,14 +124,52 @@ namespace SDLInterfaceLibrary
 	*/
 	class ISDLResourceTrunk: public IUncopyable
 	{
+		private:
+			//The images converted to the format of each screen they were requested for. Filled
+			//lazily by GetImage, which is why it is mutable.
+			mutable map< ImageFormatKey, map<string, SDL_Surface*> > convertedImages;
+
+			//How long each resource took to decode, in micro-seconds, by type and name.
+			mutable map< pair<ResourceType, string>, int > decodeTimes;
+
+			//Returns a copy of [image] in the format of the current screen.
+			static SDL_Surface* ConvertImage(SDL_Surface* image);
+
+			//Adds [resource] to images, music or sound, and records how long it took to decode.
+			//If the trunk already holds that resource, [resource] is freed instead.
+			void StoreResource(const DecodedResource& resource) const;
+
+			//Decodes the resource [resourceName] of type [type], and stores it. Returns false if
+			//the trunk does not contain it.
+			bool DecodeOnRequest(ResourceType type, const string& resourceName) const;
+
+			//Returns true if the resource [resourceName] of type [type] has been decoded.
+			bool IsDecoded(ResourceType type, const string& resourceName) const;
+
+			//Decodes those resources in [resourceList] which have not been decoded yet, on
+			//[numberOfThreads] threads, and stores them in the order they are listed in.
+			void DecodeInParallel(const vector< pair<ResourceType, string> >& resourceList, int numberOfThreads);
 		protected:
 			string name;
-			//The images this trunk contains.
-			map<string, SDL_Surface*> images;
+			//The resources which have been decoded so far. Resources are decoded the first time
+			//they are requested, which is why these are mutable.
+			mutable map<string, SDL_Surface*> images;
+			mutable map<string, Mix_Music*> music;
+			mutable map<string, Mix_Chunk*> sound;
 
-			//The music this trunk contains.
-			map<string, Mix_Music*> music;
-			map<string, Mix_Chunk*> sound;
+			/*
+				Function: DecodeResource
+
+				Decodes the resource [resourceName] of type [type] into the matching member of
+				[resource], without adding it to the trunk. It is called by the threads which load
+				trunks as well as by the main thread, possibly several at a time, so it must not
+				change the trunk.
+
+				Returns:
+					False if the trunk does not contain the resource.
+			*/
+			virtual bool DecodeResource(ResourceType type, const string& resourceName,
+				DecodedResource& resource) const = 0;
 		public:
 			/*
 				Constructor: ISDLResourceTrunk
@@ -99,14 +186,94 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: LoadResources
 
-				Loads all the resources associated with this trunk into memory.
+				Finds all the resources associated with this trunk. Each is decoded into memory
+				the first time it is requested, or when it is prefetched.
+
+				See Also:
+					<ISDLResourceTrunk::PrefetchResources>
 			*/
 			virtual void LoadResources() = 0;
+			/*
+				Function: GetResourceList
+
+				Returns:
+					The type and name of every resource in the trunk, which are known once
+					<ISDLResourceTrunk::LoadResources> has been called.
+			*/
+			virtual vector< pair<ResourceType, string> > GetResourceList() const = 0;
+			/*
+				Function: Decode
+
+				Decodes the resource [resourceName] of type [type] into [resource], and times it.
+				Unlike the other functions of the trunk it can be called from any thread, once
+				the resources have been loaded. The resource belongs to the caller until it is
+				passed to <ISDLResourceTrunk::AddResource>.
+
+				Returns:
+					False if the trunk does not contain the resource.
+			*/
+			bool Decode(ResourceType type, const string& resourceName, DecodedResource& resource) const;
+			/*
+				Function: AddResource
+
+				Adds [resource], which was decoded by <ISDLResourceTrunk::Decode>, to the trunk,
+				which frees it when it is unloaded. If the resource has been decoded since,
+				[resource] is freed instead. Images are converted to the format of the screen
+				when they are first requested, as usual.
+			*/
+			void AddResource(const DecodedResource& resource);
+			/*
+				Function: PrefetchResources
+
+				Decodes every resource named in [resourceNames], of any type, so that requesting
+				them later does not stall. The resources are decoded on several threads at once,
+				and images are then converted to the format of the current screen.
+
+				Parameters:
+					resourceNames - The names of the resources which will be decoded.
+					numberOfThreads - How many threads decode at once. If it is 0 or less, there
+									  is one thread for every processor.
+
+				Throws:
+					ResourceException - If the trunk contains no resource by one of the names, or
+										if one could not be decoded.
+			*/
+			void PrefetchResources(const vector<string>& resourceNames, int numberOfThreads = 0);
+			/*
+				Function: DecodeAllResources
+
+				Decodes every resource of the trunk which has not been decoded yet, on several
+				threads at once. The resources are added to the trunk in the order of
+				<ISDLResourceTrunk::GetResourceList> once they have all been decoded.
+
+				Parameters:
+					numberOfThreads - How many threads decode at once. If it is 0 or less, there
+									  is one thread for every processor.
+
+				Throws:
+					ResourceException - If a resource could not be decoded.
+			*/
+			void DecodeAllResources(int numberOfThreads = 0);
+			/*
+				Function: GetDecodeTimes
+
+				Returns:
+					How long each resource which has been decoded so far took to decode, in
+					micro-seconds, by type and name.
+			*/
+			const map< pair<ResourceType, string>, int >& GetDecodeTimes() const;
 			/*
 				Function: GetImage
 
+				Images are decoded, and converted to the pixel format of the screen, the first time
+				they are requested, so that blitting them does not go through SDL's converting
+				blitters. The converted copies are kept per screen format; if the video mode has
+				changed since, the image is converted to the new format on request. Surfaces returned for an earlier format
+				stay valid until the trunk is unloaded.
+
 				Returns:
-					The image [imageName].
+					The image [imageName], in the format of the current screen. If no video mode
+					has been set the image is returned as it was decoded.
 
 				Note:
 					The name of the image should define it's location in the trunk.
@@ -160,9 +327,15 @@ namespace SDLInterfaceLibrary
 	class FolderResourceTrunk: public ISDLResourceTrunk
 	{
 		private:
-			SDL_Surface* LoadImage(const FileInfo* file);
-			Mix_Music* LoadMusic(const FileInfo* file);
-			Mix_Chunk* LoadSound(const FileInfo* file);
+			SDL_Surface* LoadImage(const string& path) const;
+			Mix_Music* LoadMusic(const string& path) const;
+			Mix_Chunk* LoadSound(const string& path) const;
+
+			//The location of each resource in the folder, by type and name.
+			map< pair<ResourceType, string>, string > resourcePaths;
+
+		protected:
+			bool DecodeResource(ResourceType type, const string& resourceName, DecodedResource& resource) const;
 
 		public:
 			/*
@@ -176,16 +349,18 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: LoadResources
 
-				Loads the content, from the folder specified in the constructor, into memory.
+				Finds the content in the folder specified in the constructor.
 			*/
 			void LoadResources();
+			vector< pair<ResourceType, string> > GetResourceList() const;
 	};
 	/*
 		Class: FileResourceTrunk
 
 		Defines a ResourceTrunk which loads it's resources from a binary file. 
 
-		The file should be in the following format:
+		The file should be a version 2 pack, as described in <Resource Pack Format>. Packs of
+		the earlier format, which had no table of contents, are still read. It was:
 
 			byte 0: Number of files contained within this package.
 
@@ -197,6 +372,8 @@ namespace SDLInterfaceLibrary
 			byte nameLength + 2 - nameLength + 5: Number of bytes in file. :- fileLength
 			byte nameLength + 6 - nameLength + 5 + fileLength. :- file.
 
+		Where the number of bytes in the file is written as decimal text.
+
 		It is recommended that you use the resource packer utility to pack folders.
 
 		See Also:
@@ -205,9 +382,28 @@ namespace SDLInterfaceLibrary
 	class FileResourceTrunk: public ISDLResourceTrunk
 	{
 		private:
-			SDL_Surface* LoadImage(SDL_RWops* resourceMemory);
-			Mix_Music* LoadMusic(SDL_RWops* resourceMemory);
-			Mix_Chunk* LoadSound(SDL_RWops* resourceMemory);
+			//The file, which is kept open so that resources can be read from it when requested.
+			mutable fstream trunkFile;
+			//Held while trunkFile is read, since resources can be decoded by several threads.
+			mutable SDLMutex trunkFileLock;
+
+			//Reads the data of [entry] from trunkFile.
+			char* ReadEntry(const ResourcePackEntry& entry) const;
+
+		protected:
+			SDL_Surface* LoadImage(SDL_RWops* resourceMemory) const;
+			Mix_Music* LoadMusic(SDL_RWops* resourceMemory) const;
+			Mix_Chunk* LoadSound(SDL_RWops* resourceMemory) const;
+
+			//The table of contents of the file.
+			ResourcePackIndex index;
+
+			//Throws a ResourceException if the [size] bytes at [file] do not match the hash of [entry].
+			void CheckEntry(const ResourcePackEntry& entry, const char* file) const;
+			//Decodes the resource [entry] from [resourceMemory] into [resource].
+			void DecodeEntry(const ResourcePackEntry& entry, SDL_RWops* resourceMemory, DecodedResource& resource) const;
+
+			bool DecodeResource(ResourceType type, const string& resourceName, DecodedResource& resource) const;
 
 		public:
 			/*
@@ -221,9 +417,52 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: LoadResources
 
-				Loads the content, from the file specified in the constructor, into memory.
+				Opens the file specified in the constructor, and reads its table of contents.
+			*/
+			void LoadResources();
+			vector< pair<ResourceType, string> > GetResourceList() const;
+	};
+	/*
+		Class: MappedFileResourceTrunk
+
+		Defines a ResourceTrunk which loads it's resources from a binary file, in the same
+		format as <FileResourceTrunk>, by mapping the file into memory. Resources are decoded
+		straight from the mapping rather than copied into buffers first, and music is streamed
+		from it while it plays. The file stays mapped until the trunk is unloaded.
+
+		See Also:
+			<ISDLResourceTrunk>
+	*/
+	class MappedFileResourceTrunk: public FileResourceTrunk
+	{
+		private:
+			//The mapped file, or NULL before the resources are loaded.
+			MappedFile* mappedFile;
+
+		protected:
+			bool DecodeResource(ResourceType type, const string& resourceName, DecodedResource& resource) const;
+
+		public:
+			/*
+				Constructor: MappedFileResourceTrunk
+
+				Parameters:
+					name - The location of the file from which the resources will be loaded. This
+						   can be a static location, or one relative to the exe.
+			*/
+			MappedFileResourceTrunk(const string& name);
+			/*
+				Function: LoadResources
+
+				Maps the file specified in the constructor, and reads its table of contents.
 			*/
 			void LoadResources();
+			/*
+				Destructor: ~MappedFileResourceTrunk
+
+				Frees the music, which still reads from the file, and unmaps the file.
+			*/
+			~MappedFileResourceTrunk();
 	};
 }
 
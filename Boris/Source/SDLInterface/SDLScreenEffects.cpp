@@ -29,88 +29,112 @@ using std::vector;
 using namespace SDLInterfaceLibrary;
 using namespace Helpers;
 
-SDL_Surface* ISDLScreenEffect::CreateScreenCopy(SDL_Surface* screen,
-		const Vector2D<int>& copyPosition, const Bounds2D<int>& copyWidth)
+void ISDLScreenEffect::DrawFrame(SDLInstance* instance)
 {
-	SDL_Surface* originalImage = CreateSurface(copyWidth, screen->format->BitsPerPixel);
+	Uint8 red, green, blue, alpha;
+	GetFrameOverlay(currentPosition % numberOfFrames, red, green, blue, alpha);
 
+	SDL_Surface* screen = instance->GetScreen();
+	Uint32 color = SDL_MapRGB(screen->format, red, green, blue);
+
+	bool overlayPrepared = false;
+
+	//Only the portions themselves are blended, whatever lies between them is left alone.
 	for(vector< Dimensions2D<int> >::iterator currentPortion = portions.begin();
 		currentPortion != portions.end(); currentPortion++)
 	{
-		SDL_Rect copyPositionRect;
+		SDL_Rect position;
 
-		copyPositionRect.x = currentPortion->position.x - copyPosition.x;
-		copyPositionRect.y = currentPortion->position.y - copyPosition.y;
+		position.x = currentPortion->position.x;
+		position.y = currentPortion->position.y;
 
+		position.w = currentPortion->size.width;
+		position.h = currentPortion->size.height;
 
-		SDL_Rect portionToCopy;
+		instance->GetDamageList().Add(position);
 
-		portionToCopy.x = currentPortion->position.x;
-		portionToCopy.y = currentPortion->position.y;
+		if(alpha == SDL_ALPHA_TRANSPARENT)
+		{
+			continue;
+		}
 
-		portionToCopy.w = currentPortion->size.width;
-		portionToCopy.h = currentPortion->size.height;
+		//An opaque overlay hides the portion entirely, so it is simply filled.
+		if(alpha == SDL_ALPHA_OPAQUE)
+		{
+			if(SDL_FillRect(screen, &position, color) == -1)
+			{
+				throw SDLException();
+			}
 
+			continue;
+		}
 
-		if(SDL_BlitSurface(screen, &portionToCopy, originalImage, &copyPositionRect) != 0)
+		//32 bit screens are blended in a single pass, over themselves.
+		if(BlendColor(screen, position, screen, position, color, alpha))
 		{
-			throw SDLException();
+			continue;
 		}
-	}
 
-	return originalImage;
-}
+		if(!overlayPrepared)
+		{
+			PrepareOverlay(instance, red, green, blue, alpha);
+			overlayPrepared = true;
+		}
 
+		SDL_Rect portionOfOverlay;
 
-void ISDLScreenEffect::DrawFrames(SDL_Surface* screen, const Vector2D<int>& copyPosition,
-		const vector<SDL_Surface*>& frames, FPSmanager* frameRateManager)
-{
-	SDL_EventState(SDL_KEYDOWN, SDL_IGNORE);
+		portionOfOverlay.x = currentPortion->position.x - boundingRectangle.position.x;
+		portionOfOverlay.y = currentPortion->position.y - boundingRectangle.position.y;
 
-	for(int currentIteration = 0; currentIteration < numberOfIterations; currentIteration++)
-	{
-		for(vector<SDL_Surface*>::const_iterator currentFrame = frames.begin();
-				currentFrame != frames.end(); currentFrame++)
-		{
-			if(delayBetweenFrames < 1) 
-			{
-				SDL_framerateDelay(frameRateManager);
-			}
-			else 
-			{
-				SDL_Delay(delayBetweenFrames);
-			}
+		portionOfOverlay.w = currentPortion->size.width;
+		portionOfOverlay.h = currentPortion->size.height;
 
-			DrawFrame(screen, copyPosition, *currentFrame);
+		if(SDL_BlitSurface(overlay, &portionOfOverlay, screen, &position) == -1)
+		{
+			throw SDLException();
 		}
 	}
 
-	SDL_EventState(SDL_KEYDOWN, SDL_ENABLE);
+	instance->CountBlits(portions.size());
 }
 
-void ISDLScreenEffect::DrawFrame(SDL_Surface* screen, const Vector2D<int>& copyPosition, SDL_Surface* frame)
+void ISDLScreenEffect::PrepareOverlay(SDLInstance* instance, Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha)
 {
-	SDL_Rect position;
+	if(overlay == NULL)
+	{
+		overlay = CreateSurface(boundingRectangle.size, instance->GetScreen()->format);
 
-	position.x = copyPosition.x;
-	position.y = copyPosition.y;
+		if(overlay == NULL)
+		{
+			throw SDLException();
+		}
+	}
+
+	Uint32 color = SDL_MapRGB(overlay->format, red, green, blue);
 
-	if(SDL_BlitSurface(frame, NULL, screen, &position) == -1)
+	//Fades and flashes keep the same colour throughout, so the overlay is only filled once.
+	if(!overlayFilled || color != overlayColor)
 	{
-		throw SDLException();
+		if(SDL_FillRect(overlay, NULL, color) == -1)
+		{
+			throw SDLException();
+		}
+
+		overlayColor = color;
+		overlayFilled = true;
 	}
 
-	if(SDL_Flip(screen) == -1)
+	if(SDL_SetAlpha(overlay, SDL_SRCALPHA, alpha) == -1)
 	{
 		throw SDLException();
 	}
-
 }
 
-ISDLScreenEffect::ISDLScreenEffect(const vector<Dimensions2D<int> >& portions, int numberOfIterations, 
-								int delayBetweenFrames, bool requiresDraw)
+ISDLScreenEffect::ISDLScreenEffect(const vector<Dimensions2D<int> >& portions, int numberOfIterations,
+								int delayBetweenFrames, bool requiresDraw, bool restoresScreen)
 {
 	this->requiresDraw = requiresDraw;
+	this->restoresScreen = restoresScreen;
 	this->portions = portions;
 
 	if(numberOfIterations < 1)
@@ -120,6 +144,14 @@ ISDLScreenEffect::ISDLScreenEffect(const vector<Dimensions2D<int> >& portions, i
 
 	this->numberOfIterations = numberOfIterations;
 	this->delayBetweenFrames = delayBetweenFrames;
+
+	overlay = NULL;
+	overlayColor = 0;
+	overlayFilled = false;
+
+	numberOfFrames = 0;
+	currentPosition = 0;
+	elapsedTime = 0;
 }
 
 bool ISDLScreenEffect::RequiresDraw()
@@ -127,37 +159,52 @@ bool ISDLScreenEffect::RequiresDraw()
 	return requiresDraw;
 }
 
-void ISDLScreenEffect::Draw(SDLInstance* instance)
+bool ISDLScreenEffect::RestoresScreen()
 {
-	SDL_Surface* screen = instance->GetScreen();
-	FPSmanager* frameRateManager = instance->GetFrameRateManager();
-
-	Dimensions2D<int> boundingRectangle = GetBoundingRectangle(portions);
-
-	Vector2D<int> copyPosition = boundingRectangle.position;
-	Bounds2D<int> copyWidth = boundingRectangle.size;
-
-	SDL_Surface* originalImage = CreateScreenCopy(screen, copyPosition, copyWidth);
+	return restoresScreen;
+}
 
-	vector<SDL_Surface*> frames = GenerateFrames(originalImage);
+void ISDLScreenEffect::Start(SDLInstance* instance)
+{
+	boundingRectangle = GetBoundingRectangle(portions);
 
-	DrawFrames(screen, copyPosition, frames, frameRateManager);
+	numberOfFrames = GetNumberOfFrames();
+	currentPosition = 0;
+	elapsedTime = 0;
 
-	SDL_FreeSurface(originalImage);
+	DrawFrame(instance);
+}
 
-	for(vector<SDL_Surface*>::iterator currentFrame = frames.begin();
-		currentFrame != frames.end();
-		currentFrame++)
+void ISDLScreenEffect::Advance(int elapsedTime)
+{
+	if(delayBetweenFrames < 1)
+	{
+		currentPosition++;
+	}
+	else
 	{
-		SDL_FreeSurface(*currentFrame);
+		this->elapsedTime += elapsedTime;
+		currentPosition = this->elapsedTime / delayBetweenFrames;
 	}
 }
 
-ISDLScreenEffect::~ISDLScreenEffect() {
+bool ISDLScreenEffect::IsComplete() const
+{
+	return currentPosition >= numberOfFrames * numberOfIterations;
+}
+
+GenericEventHandlerCollection& ISDLScreenEffect::GetCompleteHandlers()
+{
+	return completeHandlers;
+}
+
+ISDLScreenEffect::~ISDLScreenEffect()
+{
+	SDL_FreeSurface(overlay);
 }
 
 FlashScreenEffect::FlashScreenEffect(const vector< Dimensions2D<int> >& portions, int numberOfFrames,
-	int numberOfIterations): ISDLScreenEffect(portions, numberOfIterations, -1, false)
+	int numberOfIterations): ISDLScreenEffect(portions, numberOfIterations, -1, false, true)
 {
 	if(numberOfFrames < 1)
 	{
@@ -167,24 +214,20 @@ FlashScreenEffect::FlashScreenEffect(const vector< Dimensions2D<int> >& portions
 	this->numberOfFrames = numberOfFrames;
 }
 
-vector<SDL_Surface*> FlashScreenEffect::GenerateFrames(SDL_Surface* originalImage)
+int FlashScreenEffect::GetNumberOfFrames()
 {
-	vector<SDL_Surface*> frames;
-
-	for(int i = 0; i < numberOfFrames; i++)
-	{
-		int alpha = 255/numberOfFrames * i;
-		frames.push_back(CreateOverlaidCopy(originalImage, 255, 255, 255, alpha));
-	}
-
-	frames.push_back(CreateOverlaidCopy(originalImage, 255, 255, 255, 255));
+	return numberOfFrames + 1;
+}
 
-	return frames;
+void FlashScreenEffect::GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha)
+{
+	red = green = blue = 255;
+	alpha = (frameIndex < numberOfFrames)? 255/numberOfFrames * frameIndex: 255;
 }
 
 OverlayScreenEffect::OverlayScreenEffect(const vector< Dimensions2D<int> >& portions,
 				int red, int green, int blue, int alpha):
-	ISDLScreenEffect(portions, 1, -1, false)
+	ISDLScreenEffect(portions, 1, -1, false, false)
 {
 	this->red = red;
 	this->green = green;
@@ -192,20 +235,25 @@ OverlayScreenEffect::OverlayScreenEffect(const vector< Dimensions2D<int> >& port
 	this->alpha = alpha;
 }
 
-vector<SDL_Surface*> OverlayScreenEffect::GenerateFrames(SDL_Surface* originalImage)
+int OverlayScreenEffect::GetNumberOfFrames()
 {
-	vector<SDL_Surface*> frames;
-
-	frames.push_back(CreateOverlaidCopy(originalImage, red, green, blue, alpha));
+	return 1;
+}
 
-	return frames;
+void OverlayScreenEffect::GetFrameOverlay(int, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha)
+{
+	red = this->red;
+	green = this->green;
+	blue = this->blue;
+	alpha = this->alpha;
 }
 
 
 
 FadeScreenEffect::FadeScreenEffect(const vector< Dimensions2D<int> >& portions,
 		int numberOfFrames, unsigned int animationLength, SDLFadeDirection fadeDirection):
-		ISDLScreenEffect(portions, 1, (int)(animationLength / (float)numberOfFrames), fadeDirection == SDL_FD_IN)
+		ISDLScreenEffect(portions, 1, (int)(animationLength / (float)numberOfFrames), fadeDirection == SDL_FD_IN,
+			fadeDirection == SDL_FD_IN)
 {
 	if(numberOfFrames < 1)
 	{
@@ -216,17 +264,21 @@ FadeScreenEffect::FadeScreenEffect(const vector< Dimensions2D<int> >& portions,
 	this->fadeDirection = fadeDirection;
 }
 
-vector<SDL_Surface*> FadeScreenEffect::GenerateFrames(SDL_Surface* originalImage)
+int FadeScreenEffect::GetNumberOfFrames()
+{
+	return numberOfFrames + 1;
+}
+
+void FadeScreenEffect::GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha)
 {
-	vector<SDL_Surface*> frames;
+	red = green = blue = 0;
 
-	for(int i = 0; i < numberOfFrames; i++)
+	if(frameIndex == numberOfFrames)
 	{
-		int alpha = 255/numberOfFrames * ((fadeDirection == SDL_FD_IN)? numberOfFrames - i: i);
-		frames.push_back(CreateOverlaidCopy(originalImage, 0, 0, 0, alpha));
+		alpha = (fadeDirection == SDL_FD_IN)? 0: 255;
+	}
+	else
+	{
+		alpha = 255/numberOfFrames * ((fadeDirection == SDL_FD_IN)? numberOfFrames - frameIndex: frameIndex);
 	}
-
-	frames.push_back(CreateOverlaidCopy(originalImage, 0, 0, 0, (fadeDirection == SDL_FD_IN)? 0: 255));
-
-	return frames;
 }
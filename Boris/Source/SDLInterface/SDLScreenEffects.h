@@ -28,15 +28,16 @@
 #include <vector>
 
 #include <SDL/SDL.h>
-#include <SDL/SDL_framerate.h>
 
 #include <SDLInterface/SDLException.h>
+#include <EventHandling/GenericEventHandler.h>
 #include <Helpers/GeometricHelperFunctions.h>
 #include <Helpers/GeometricStructures2D.h>
 #include <Helpers/IUncopyable.h>
 #include <Helpers/SDLHelperFunctions.h>
 
 using std::vector;
+using namespace EventHandling;
 /*
 	File: SDLScreenEffects.h
 
@@ -65,70 +66,108 @@ namespace SDLInterfaceLibrary
 
 		The screen effect differs from a component effect, in that a component effect
 		creates and draws a new frame each time the component it is applied to is drawn.
-		On the other hand, a screen effects creates all it frames and draws them in sequence
-		upon being called. This requires it to steal the rendering pipeline from the application
-		temporarily, and to flush away any events in the message loop. This is the ideal base
-		class for fade in/fade out and other similar effects.
+		On the other hand, a screen effect plays an animation over portions of the screen.
+		Every frame of the animation is a single colour alpha blended over whatever the
+		focused form has drawn in those portions, so the form carries on changing beneath
+		it. This is the ideal base class for fade in/fade out and other similar effects.
+
+		Screen effects do not take over the main loop. Once started by
+		<SDLInstance::PerformScreenEffect>, the instance advances the effect once per frame,
+		and draws it's frame after the focused form is drawn in full, so timers, input and
+		music callbacks carry on as normal. Frames are blended over the screen in place, so
+		nothing is allocated while the effect plays, other than a surface holding the colour
+		on screens which cannot be blended directly.
 
 		Note:
-			All the derived classes of ISDLScreenEffect must implement the pure virtual function
-			GenerateFrames.
+			All the derived classes of ISDLScreenEffect must implement the pure virtual functions
+			GetNumberOfFrames and GetFrameOverlay.
 
 		See Also:
 			<ISDLEffect>
-			<ISDLScreenEffect::GenerateFrames>
+			<ISDLScreenEffect::GetFrameOverlay>
 	*/
-	class ISDLScreenEffect
+	class ISDLScreenEffect: public IUncopyable
 	{
 		private:
 			bool requiresDraw;
+			bool restoresScreen;
 			vector< Dimensions2D<int> > portions;
 			int numberOfIterations;
 
 			int delayBetweenFrames;
 
-			//Returns a copy of the main screen.
-			SDL_Surface* CreateScreenCopy(SDL_Surface* screen, const Vector2D<int>& copyPosition,
-							const Bounds2D<int>& copyWidth);
+			//The smallest area of the screen which holds all the portions.
+			Dimensions2D<int> boundingRectangle;
 
-			//Blits all the frames in [frames] to the screen.
-			void DrawFrames(SDL_Surface* screen, const Vector2D<int>& copyPosition,
-						const vector<SDL_Surface*>& frames, FPSmanager* frameRateManager);
+			//A surface the size of boundingRectangle filled with the colour of the current
+			//frame, which is blended over the screen using per-surface alpha on screens which
+			//BlendColor cannot handle. It is only created when first needed. overlayColor is
+			//the colour it was last filled with, mapped to it's format, and overlayFilled is
+			//false until it is first filled.
+			SDL_Surface* overlay;
+			Uint32 overlayColor;
+			bool overlayFilled;
 
-			//Blits a frame to the screen.
-			void DrawFrame(SDL_Surface* screen, const Vector2D<int>& copyPosition, SDL_Surface* frame);
+			//The number of frames in a single iteration.
+			int numberOfFrames;
+			//The position of the frame being shown within the whole animation, and the time
+			//(In milli-seconds) which has passed since the animation started.
+			int currentPosition;
+			int elapsedTime;
+
+			//Collection of generic event handlers which will be called when the
+			//animation ends.
+			GenericEventHandlerCollection completeHandlers;
+
+			//Creates the overlay if it doesn't exist yet, and fills it with the given colour
+			//at the given per-surface alpha.
+			void PrepareOverlay(SDLInstance* instance, Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha);
 
 		protected:
 			/*
-				Function: GenerateFrames
+				Function: GetNumberOfFrames
+
+				Returns:
+					The number of frames in a single iteration of the animation.
+			*/
+			virtual int GetNumberOfFrames() = 0;
+			/*
+				Function: GetFrameOverlay
 
 				Parameters:
-					originalImage - The original image of the screen from which the frames will be derived.
+					frameIndex - The index of the frame, from 0 to <GetNumberOfFrames> - 1.
 
-				Returns:
-					A vector of sdl surfaces which represent the frames which will be blitted to the screen,
-					and their order.
+					red - Set to the R value which will be alpha blended over the screen.
+					green - Set to the G value which will be alpha blended over the screen.
+					blue - Set to the B value which will be alpha blended over the screen.
+					alpha - Set to the A value which will be alpha blended over the screen.
 			*/
-			virtual vector<SDL_Surface*> GenerateFrames(SDL_Surface* originalImage) = 0;
+			virtual void GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha) = 0;
 		public:
 			/*
 				Constructor: ISDLScreenEffect
 
 				Parameters:
-					portions - The portions which will be copied from the screen.
+					portions - The portions of the screen which the animation is played over.
 
 					numberOfIterations - The number of times all the frames will be drawn to the screen.
 
 					delayBetweenFrames - The number of milli-seconds that the animation is delayed between frames.
+										 If this is less than 1, a new frame is shown every time the
+										 screen is drawn.
 
 					requiresDraw - Is true if a draw cycle should occur before this effect takes place. This
 								   is helpful for effects such as fadeouts, which immediatly follow fadeins
-								   and therefore require a copy of what should be on the screen rather than
-								   what is (Which in the case of a fadein, is a black rectangle).
+								   and therefore must be played over what should be on the screen rather
+								   than what is (Which in the case of a fadein, is a black rectangle).
+
+					restoresScreen - Is true if the focused form should be redrawn in it's entirety
+									 once the animation ends, rather than leaving the last frame on
+									 the screen.
 
 			*/
-			ISDLScreenEffect(const vector<Dimensions2D<int> >& portions, int numberOfFrames,
-						int delayBetweenFrames, bool requiresDraw);
+			ISDLScreenEffect(const vector<Dimensions2D<int> >& portions, int numberOfIterations,
+						int delayBetweenFrames, bool requiresDraw, bool restoresScreen);
 			/*
 				Function: RequiresDraw
 
@@ -137,22 +176,70 @@ namespace SDLInterfaceLibrary
 			*/
 			bool RequiresDraw();
 			/*
-				Function: Draw
+				Function: RestoresScreen
+
+				Returns true if the focused form should be redrawn once this effect ends.
+
+			*/
+			bool RestoresScreen();
+			/*
+				Function: Start
+
+				Draws the first frame of the animation.
+
+				Parameters:
+					instance - The SDLInstance object on which the effect is drawn.
+
+			*/
+			void Start(SDLInstance* instance);
+			/*
+				Function: Advance
+
+				Moves the animation on by [elapsedTime], or by a single frame if there is no
+				delay between frames. The frame which is then due is drawn by <DrawFrame>.
+
+				Parameters:
+					elapsedTime - The number of milli-seconds which have passed since the last
+								  call.
+
+			*/
+			void Advance(int elapsedTime);
+			/*
+				Function: DrawFrame
+
+				Blends the colour of the current frame over the portions, in place.
 
-				Draws the effect on the screen.
+				Note:
+					Whatever the portions hold is blended over, so they must be redrawn
+					before each call, or the frames will build up over one another.
 
 				Parameters:
-					instance - The SDLInstance object from which the frames will be derived.
+					instance - The SDLInstance object on which the effect is drawn.
 
 			*/
-			void Draw(SDLInstance* instance);
-			
+			void DrawFrame(SDLInstance* instance);
+			/*
+				Function: IsComplete
+
+				Returns true once every frame has been shown for every iteration.
+
+			*/
+			bool IsComplete() const;
+			/*
+				Function: GetCompleteHandlers
+
+				Returns:
+					A read/write reference to the collection of event handlers which will be
+					called when the animation ends.
+			*/
+			GenericEventHandlerCollection& GetCompleteHandlers();
+
 			virtual ~ISDLScreenEffect();
 	};
 	/*
 		Class: FlashScreenEffect
 
-		This effect will draw the original image [numberOfFrames] times. Each copy will be overlaid
+		This effect will draw [numberOfFrames] frames over the screen. Each will be overlaid
 		with a white layer of differing alpha values, from 0 to 255, depending on the number of frames.
 		This creates the effect of a portion of the screen flashing.
 	*/
@@ -163,23 +250,29 @@ namespace SDLInterfaceLibrary
 
 		protected:
 			/*
-				Function: GenerateFrames
+				Function: GetNumberOfFrames
+
+				Returns:
+					The number of frames in a single iteration of the animation.
+			*/
+			int GetNumberOfFrames();
+			/*
+				Function: GetFrameOverlay
 
 				Parameters:
-					originalImage - The original image of the screen from which the frames will be derived.
+					frameIndex - The index of the frame.
 
-				Returns:
-					A vector of sdl surfaces which represent the frames which will be blitted to the screen,
-					and their order.
+					red, green, blue, alpha - Set to the color which will be alpha blended over
+											  the original image.
 			*/
-			vector<SDL_Surface*> GenerateFrames(SDL_Surface* originalImage);
+			void GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha);
 
 		public:
 			/*
 				Constructor: ISDLScreenEffect
 
 				Parameters:
-					portions - The portions which will be copied from the screen.
+					portions - The portions of the screen which the animation is played over.
 
 					numberOfFrames - The number of frames in the given flash effect, the higher this number
 									 is, the more dense the flash animation will appear.
@@ -193,7 +286,8 @@ namespace SDLInterfaceLibrary
 	/*
 		Class: OverlayScreenEffect
 
-		This effect will draw a colored overlay on the screen.
+		This effect will draw a colored overlay on the screen. The overlay is drawn once, and
+		stays on the screen until whatever lies beneath it is redrawn.
 	*/
 	class OverlayScreenEffect: public ISDLScreenEffect
 	{
@@ -206,23 +300,29 @@ namespace SDLInterfaceLibrary
 
 		protected:
 			/*
-				Function: GenerateFrames
+				Function: GetNumberOfFrames
+
+				Returns:
+					The number of frames in a single iteration of the animation.
+			*/
+			int GetNumberOfFrames();
+			/*
+				Function: GetFrameOverlay
 
 				Parameters:
-					originalImage - The original image of the screen from which the frames will be derived.
+					frameIndex - The index of the frame.
 
-				Returns:
-					A vector of sdl surfaces which represent the frames which will be blitted to the screen,
-					and their order.
+					red, green, blue, alpha - Set to the color which will be alpha blended over
+											  the original image.
 			*/
-			vector<SDL_Surface*> GenerateFrames(SDL_Surface* originalImage);
+			void GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha);
 
 		public:
 			/*
 				Constructor: OverlayScreenEffect
 
 				Parameters:
-					portions - The portions which will be copied from the screen.
+					portions - The portions of the screen which the animation is played over.
 
 					red - The R value which will be alpha blended to the screen.
 					green - The G value which will be alpha blended to the screen.
@@ -236,10 +336,13 @@ namespace SDLInterfaceLibrary
 	/*
 		Class: FadeScreenEffect
 
-		This effect will draw the original image [numberOfFrames] times. Each copy will be overlaid
+		This effect will draw [numberOfFrames] frames over the screen. Each will be overlaid
 		with a black layer of differing alpha values, from 0 to 255, depending on the number of frames.
 		Also, the rate the alpha value increases/decreases depends on the fade direction specified.
 		This creates the effect of a portion of the screen fading in or out.
+
+		A fade out leaves the screen black once it ends, while a fade in hands the screen back
+		to the focused form.
 	*/
 	class FadeScreenEffect: public ISDLScreenEffect
 	{
@@ -249,23 +352,29 @@ namespace SDLInterfaceLibrary
 
 		protected:
 			/*
-				Function: GenerateFrames
+				Function: GetNumberOfFrames
+
+				Returns:
+					The number of frames in a single iteration of the animation.
+			*/
+			int GetNumberOfFrames();
+			/*
+				Function: GetFrameOverlay
 
 				Parameters:
-					originalImage - The original image of the screen from which the frames will be derived.
+					frameIndex - The index of the frame.
 
-				Returns:
-					A vector of sdl surfaces which represent the frames which will be blitted to the screen,
-					and their order.
+					red, green, blue, alpha - Set to the color which will be alpha blended over
+											  the original image.
 			*/
-			vector<SDL_Surface*> GenerateFrames(SDL_Surface* originalImage);
+			void GetFrameOverlay(int frameIndex, Uint8& red, Uint8& green, Uint8& blue, Uint8& alpha);
 
 		public:
 			/*
 				Constructor: FadeScreenEffect
 
 				Parameters:
-					portions - The portions which will be copied from the screen.
+					portions - The portions of the screen which the animation is played over.
 
 					numberOfFrames - The number of frames in the given fade effect, the higher this number
 									 is, the more dense the fade animation will appear.
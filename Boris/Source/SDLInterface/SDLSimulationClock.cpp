@@ -0,0 +1,74 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLSimulationClock.h>
+
+using namespace SDLInterfaceLibrary;
+using namespace std::chrono;
+
+SDLSimulationClock::SDLSimulationClock(int stepLength, int maximumFrameLength)
+{
+	this->stepLength = stepLength;
+	this->maximumFrameLength = maximumFrameLength;
+
+	Reset();
+}
+
+void SDLSimulationClock::Reset()
+{
+	accumulatedTime = 0;
+	previousTime = steady_clock::now();
+}
+
+int SDLSimulationClock::Advance()
+{
+	steady_clock::time_point currentTime = steady_clock::now();
+	microseconds elapsedTime = duration_cast<microseconds>(currentTime - previousTime);
+
+	//Only whole microseconds are consumed, so that the remainder is not lost.
+	previousTime += elapsedTime;
+
+	//Clamped here as well, since a long enough stall would not fit in an int.
+	return Advance((elapsedTime.count() > maximumFrameLength)? maximumFrameLength: (int)elapsedTime.count());
+}
+
+int SDLSimulationClock::Advance(int elapsedTime)
+{
+	if(elapsedTime > maximumFrameLength)
+	{
+		elapsedTime = maximumFrameLength;
+	}
+
+	accumulatedTime += elapsedTime;
+
+	int numberOfSteps = accumulatedTime / stepLength;
+	accumulatedTime -= numberOfSteps * stepLength;
+
+	return numberOfSteps;
+}
+
+int SDLSimulationClock::GetStepLength() const
+{
+	return stepLength;
+}
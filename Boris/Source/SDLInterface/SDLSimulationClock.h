@@ -0,0 +1,103 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_SIMULATION_CLOCK_H
+#define SDL_SIMULATION_CLOCK_H
+
+#include <chrono>
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLSimulationClock
+
+		Measures the time which passes between frames with a monotonic, high resolution
+		clock, and splits it into simulation steps of a fixed length. Time which is not
+		enough to make up a whole step is carried over to the next frame, so that the
+		simulation keeps pace with the real time no matter how often frames are drawn.
+
+		See Also:
+			<SDLInstance::Run>
+	*/
+	class SDLSimulationClock
+	{
+		private:
+			//The length (In microseconds) of a single simulation step.
+			int stepLength;
+			//The most time (In microseconds) that a single frame may contribute. Anything beyond
+			//this is dropped, so that a stall does not make the simulation catch up in a burst.
+			int maximumFrameLength;
+
+			//The time (In microseconds) which has elapsed but has not been stepped through yet.
+			int accumulatedTime;
+			std::chrono::steady_clock::time_point previousTime;
+		public:
+			/*
+				Constructor: SDLSimulationClock
+
+				Parameters:
+					stepLength - The length, in microseconds, of a single simulation step.
+					maximumFrameLength - The most time, in microseconds, that will be accounted
+										 for in a single frame.
+			*/
+			SDLSimulationClock(int stepLength, int maximumFrameLength);
+			/*
+				Function: Reset
+
+				Discards any time which has elapsed since the last call to
+				<SDLSimulationClock::Advance>, or since the clock was created.
+			*/
+			void Reset();
+			/*
+				Function: Advance
+
+				Reads the clock and accumulates the time elapsed since it was last read.
+
+				Returns:
+					The number of whole simulation steps which are now due.
+			*/
+			int Advance();
+			/*
+				Function: Advance
+
+				Accumulates [elapsedTime] without reading the clock.
+
+				Parameters:
+					elapsedTime - The time, in microseconds, which has elapsed.
+
+				Returns:
+					The number of whole simulation steps which are now due.
+			*/
+			int Advance(int elapsedTime);
+			/*
+				Function: GetStepLength
+
+				Returns:
+					The length, in microseconds, of a single simulation step.
+			*/
+			int GetStepLength() const;
+	};
+}
+
+#endif
@@ -63,58 +63,197 @@ void SDLSurfaceGrid::ConfirmSurfaceSize(SDL_Surface* surface)
 	}
 }
 
-SDLSurfaceGrid::SDLSurfaceGrid(const string& name, const Bounds2D<int>& surfaceGridSize,
-		const Bounds2D<int>& surfaceSize, const Vector2D<int>& anchorBlockPosition,
-		SDLSurfacePoint anchorPoint)
+void SDLSurfaceGrid::InitializeRowMasks()
 {
-	this->name = name;
+	if(GetWidth() > 64)
+	{
+		stringstream exceptionString;
 
-	this->surfaceSize = surfaceSize;
-	this->anchorPoint = anchorPoint;
+		exceptionString << "Error in surface grid " << name << ": ";
+		exceptionString << "width " << GetWidth() << " exceeds the maximum of 64 columns";
 
-	surfaceGrid = new Grid<SDL_Surface*>(surfaceGridSize.width,
-									surfaceGridSize.height);
+		throw SDLInterfaceLibraryException(exceptionString.str().c_str());
+	}
 
-	for(int x = 0; x < surfaceGrid->GetWidth(); x++)
+	fullRowMask = GetColumnRangeMask(0, GetWidth());
+}
+
+Uint64 SDLSurfaceGrid::GetColumnRangeMask(int firstColumn, int endColumn)
+{
+	if(endColumn <= firstColumn)
 	{
-		for(int y = 0; y < surfaceGrid->GetHeight(); y++)
+		return 0;
+	}
+
+	int numberOfColumns = endColumn - firstColumn;
+	Uint64 mask = (numberOfColumns >= 64)? ~(Uint64)0: ((Uint64)1 << numberOfColumns) - 1;
+
+	return mask << firstColumn;
+}
+
+void SDLSurfaceGrid::MarkDirty(int row, Uint64 columns)
+{
+	if(cached)
+	{
+		dirtyRowMasks[row] |= columns;
+	}
+}
+
+void SDLSurfaceGrid::UpdateCompositeSurface(SDL_Surface* screen)
+{
+	SDL_PixelFormat* format = screen->format;
+
+	//The composite is kept in the format of the screen, so it is made anew if that changes.
+	if(compositeSurface.surface != NULL)
+	{
+		SDL_PixelFormat* compositeFormat = compositeSurface.surface->format;
+
+		if(compositeFormat->BitsPerPixel != format->BitsPerPixel || compositeFormat->Rmask != format->Rmask ||
+			compositeFormat->Gmask != format->Gmask || compositeFormat->Bmask != format->Bmask)
 		{
-			surfaceGrid->Set(x, y, NULL);
+			compositeSurface.Free();
 		}
 	}
 
+	if(compositeSurface.surface == NULL)
+	{
+		compositeSurface.surface = SDL_CreateRGBSurface(SDL_SWSURFACE, GetWidth() * surfaceSize.width,
+			GetHeight() * surfaceSize.height, format->BitsPerPixel, format->Rmask, format->Gmask,
+			format->Bmask, 0);
+
+		if(compositeSurface.surface == NULL)
+		{
+			throw SDLException();
+		}
+
+		Uint32 colorKey = SDL_MapRGB(compositeSurface.surface->format, 255, 0, 255);
+
+		if(SDL_SetColorKey(compositeSurface.surface, SDL_SRCCOLORKEY, colorKey) == -1)
+		{
+			throw SDLException();
+		}
+
+		for(int y = 0; y < GetHeight(); y++)
+		{
+			dirtyRowMasks[y] = fullRowMask;
+		}
+	}
+
+	Uint32 colorKey = compositeSurface.surface->format->colorkey;
+	bool updated = false;
+
+	for(int y = 0; y < GetHeight(); y++)
+	{
+		if(dirtyRowMasks[y] == 0)
+		{
+			continue;
+		}
+
+		if(!updated)
+		{
+			//Drawing unto an RLE surface decodes and re-encodes it on every call, so RLE is
+			//dropped while the tiles are redrawn and restored once afterwards.
+			if(SDL_SetColorKey(compositeSurface.surface, SDL_SRCCOLORKEY, colorKey) == -1)
+			{
+				throw SDLException();
+			}
+
+			updated = true;
+		}
+
+		for(int x = 0; x < GetWidth(); x++)
+		{
+			if((dirtyRowMasks[y] & ((Uint64)1 << x)) == 0)
+			{
+				continue;
+			}
+
+			SDL_Rect cellRect;
+
+			cellRect.x = x * surfaceSize.width;
+			cellRect.y = y * surfaceSize.height;
+			cellRect.w = surfaceSize.width;
+			cellRect.h = surfaceSize.height;
+
+			if(SDL_FillRect(compositeSurface.surface, &cellRect, colorKey) == -1)
+			{
+				throw SDLException();
+			}
+
+			SDL_Surface* surfaceToDraw = surfaceGrid(x, y);
+
+			if(surfaceToDraw != NULL && SDL_BlitSurface(surfaceToDraw, NULL, compositeSurface.surface, &cellRect) == -1)
+			{
+				throw SDLException();
+			}
+		}
+
+		dirtyRowMasks[y] = 0;
+	}
+
+	//The composite is mostly empty space, which RLE lets SDL skip over when blitting.
+	if(updated && SDL_SetColorKey(compositeSurface.surface, SDL_SRCCOLORKEY | SDL_RLEACCEL, colorKey) == -1)
+	{
+		throw SDLException();
+	}
+}
+
+int SDLSurfaceGrid::CountBits(Uint64 mask)
+{
+	int count = 0;
+
+	for(; mask != 0; count++)
+	{
+		mask &= mask - 1;
+	}
+
+	return count;
+}
+
+SDLSurfaceGrid::SDLSurfaceGrid(const string& name, const Bounds2D<int>& surfaceGridSize,
+		const Bounds2D<int>& surfaceSize, const Vector2D<int>& anchorBlockPosition,
+		SDLSurfacePoint anchorPoint):
+	surfaceGrid(surfaceGridSize.width, surfaceGridSize.height, NULL),
+	rowMasks(surfaceGridSize.height, 0),
+	cached(false),
+	dirtyRowMasks(surfaceGridSize.height, 0)
+{
+	this->name = name;
+	InitializeRowMasks();
+
+	this->surfaceSize = surfaceSize;
+	this->anchorPoint = anchorPoint;
+
 	SetAnchor(anchorBlockPosition, anchorPoint);
 }
 
 SDLSurfaceGrid::SDLSurfaceGrid(const string& name, const Grid<unsigned int>& surfacePlacementMap,
 	const vector<SDL_Surface*>& surfaceList, const Vector2D<int>& anchorBlockPosition,
-	SDLSurfacePoint anchorPoint)
+	SDLSurfacePoint anchorPoint):
+	surfaceGrid(surfacePlacementMap.GetWidth(), surfacePlacementMap.GetHeight(), NULL),
+	rowMasks(surfacePlacementMap.GetHeight(), 0),
+	cached(false),
+	dirtyRowMasks(surfacePlacementMap.GetHeight(), 0)
 {
 	this->name = name;
+	InitializeRowMasks();
+
 	this->surfaceSize = Bounds2D<int>(surfaceList[0]->clip_rect.w,
 					surfaceList[0]->clip_rect.h);
 
 
 	ConfirmSurfaceList(surfaceList);
 
-	surfaceGrid = new Grid<SDL_Surface*>(surfacePlacementMap.GetWidth(),
-										surfacePlacementMap.GetHeight());
-
-	for(int columnPosition = 0; columnPosition < surfaceGrid->GetWidth(); columnPosition++)
+	for(int rowPosition = 0; rowPosition < surfaceGrid.GetHeight(); rowPosition++)
 	{
-		for(int rowPosition = 0; rowPosition < surfaceGrid->GetHeight(); rowPosition++)
+		for(int columnPosition = 0; columnPosition < surfaceGrid.GetWidth(); columnPosition++)
 		{
-			unsigned int surfaceIndex = surfacePlacementMap.Get(columnPosition, rowPosition);
+			unsigned int surfaceIndex = surfacePlacementMap(columnPosition, rowPosition);
 
-			if(surfaceIndex == 0)
-			{
-				surfaceGrid->Set(columnPosition, rowPosition, NULL);
-			}
-			else
+			if(surfaceIndex != 0)
 			{
 				Replace(surfaceList[surfaceIndex - 1], Vector2D<int>(columnPosition, rowPosition));
 			}
-
 		}
 	}
 
@@ -123,13 +262,27 @@ SDLSurfaceGrid::SDLSurfaceGrid(const string& name, const Grid<unsigned int>& sur
 
 void SDLSurfaceGrid::Blit(const Vector2D<int>& position, SDL_Surface* screen)
 {
-	if(screen != NULL)
+	if(screen != NULL && cached)
+	{
+		UpdateCompositeSurface(screen);
+
+		SDL_Rect offset;
+
+		offset.x = position.x - anchor.x;
+		offset.y = position.y - anchor.y;
+
+		if(SDL_BlitSurface(compositeSurface.surface, NULL, screen, &offset) == -1)
+		{
+			throw SDLException();
+		}
+	}
+	else if(screen != NULL)
 	{
-		for(int x = 0; x < surfaceGrid->GetWidth(); x++)
+		for(int y = 0; y < surfaceGrid.GetHeight(); y++)
 		{
-			for(int y = 0; y < surfaceGrid->GetHeight(); y++)
+			for(int x = 0; x < surfaceGrid.GetWidth(); x++)
 			{
-				SDL_Surface* surfaceToDraw = GetSurface(Vector2D<int>(x, y));
+				SDL_Surface* surfaceToDraw = surfaceGrid(x, y);
 
 				if(surfaceToDraw != NULL)
 				{
@@ -163,7 +316,20 @@ void SDLSurfaceGrid::Replace(SDL_Surface* surface,
 		ConfirmSurfaceSize(surface);
 	}
 
-	surfaceGrid->Set(blockPosition.x, blockPosition.y, surface);
+	surfaceGrid.Set(blockPosition.x, blockPosition.y, surface);
+
+	Uint64 cellMask = (Uint64)1 << blockPosition.x;
+
+	if(surface != NULL)
+	{
+		rowMasks[blockPosition.y] |= cellMask;
+	}
+	else
+	{
+		rowMasks[blockPosition.y] &= ~cellMask;
+	}
+
+	MarkDirty(blockPosition.y, cellMask);
 }
 
 void SDLSurfaceGrid::Replace(const SDLSurfaceGrid& surfaceGrid, Vector2D<int> positionToCopyTo,
@@ -186,9 +352,9 @@ void SDLSurfaceGrid::Replace(const SDLSurfaceGrid& surfaceGrid, Vector2D<int> po
 
 	positionToCopyTo -= surfaceGrid.GetAnchorBlockPosition();
 
-	for(int x = 0; x < widthToTraverse; x++)
+	for(int y = 0; y < heightToTraverse; y++)
 	{
-		for(int y = 0; y < heightToTraverse; y++)
+		for(int x = 0; x < widthToTraverse; x++)
 		{
 			Vector2D<int> blockPosition(startingX + x, startingY + y);
 			SDL_Surface* currentSurface = surfaceGrid.GetSurface(blockPosition);
@@ -222,9 +388,9 @@ SDLSurfaceGrid SDLSurfaceGrid::Copy(Dimensions2D<int>* portionToCopy) const
 	SDLSurfaceGrid surfaceGridCopy(newName, Bounds2D<int>(widthToTraverse, heightToTraverse),
 					surfaceSize, anchorBlockPosition, anchorPoint);
 
-	for(int x = 0; x < widthToTraverse; x++)
+	for(int y = 0; y < heightToTraverse; y++)
 	{
-		for(int y = 0; y < heightToTraverse; y++)
+		for(int x = 0; x < widthToTraverse; x++)
 		{
 			Vector2D<int> blockPosition(startingX + x, startingY + y);
 			SDL_Surface* currentSurface = GetSurface(blockPosition);
@@ -241,43 +407,225 @@ SDLSurfaceGrid SDLSurfaceGrid::Copy(Dimensions2D<int>* portionToCopy) const
 
 void SDLSurfaceGrid::ClearSurfaceGrid(Dimensions2D<int>* portionToClear)
 {
-	int startingX = 0;
-	int startingY = 0;
-
-	int widthToTraverse = this->GetWidth();
-	int heightToTraverse = this->GetHeight();
+	Dimensions2D<int> portion(0, 0, GetWidth(), GetHeight());
 
+	//The cells outside the grid hold nothing, so only those within it are cleared.
 	if(portionToClear != NULL)
 	{
-		startingX = portionToClear->position.x;
-		startingY = portionToClear->position.y;
+		portion = Clip(*portionToClear);
+	}
+
+	int startingX = portion.position.x;
+	int startingY = portion.position.y;
+
+	int widthToTraverse = portion.size.width;
+	int heightToTraverse = portion.size.height;
+
+	for(int y = 0; y < heightToTraverse; y++)
+	{
+		for(int x = 0; x < widthToTraverse; x++)
+		{
+			surfaceGrid.Set(startingX + x, startingY + y, NULL);
+		}
+
+		Uint64 clearedColumns = GetColumnRangeMask(startingX, startingX + widthToTraverse);
+
+		rowMasks[startingY + y] &= ~clearedColumns;
+		MarkDirty(startingY + y, clearedColumns);
+	}
+}
+
+void SDLSurfaceGrid::CollapseRows(const vector<int>& rowIndexes)
+{
+	vector<bool> rowIsRemoved(GetHeight(), false);
+
+	for(unsigned int i = 0; i < rowIndexes.size(); i++)
+	{
+		if(rowIndexes[i] < 0 || rowIndexes[i] >= GetHeight())
+		{
+			stringstream exceptionString;
+
+			exceptionString << "Error in surface grid " << name << ": ";
+			exceptionString << "cannot collapse row " << rowIndexes[i] << ", the grid has ";
+			exceptionString << GetHeight() << " rows";
+
+			throw SDLInterfaceLibraryException(exceptionString.str().c_str());
+		}
+
+		rowIsRemoved[rowIndexes[i]] = true;
+	}
+
+	//Walk up the grid, moving each row that is kept down to the next free row.
+	int rowToWriteTo = GetHeight() - 1;
+
+	for(int y = GetHeight() - 1; y >= 0; y--)
+	{
+		if(rowIsRemoved[y])
+		{
+			continue;
+		}
+
+		if(rowToWriteTo != y)
+		{
+			for(int x = 0; x < GetWidth(); x++)
+			{
+				surfaceGrid(x, rowToWriteTo) = surfaceGrid(x, y);
+			}
+
+			rowMasks[rowToWriteTo] = rowMasks[y];
+			MarkDirty(rowToWriteTo, fullRowMask);
+		}
 
-		widthToTraverse = portionToClear->size.width;
-		heightToTraverse = portionToClear->size.height;
+		rowToWriteTo--;
 	}
 
-	for(int x = 0; x < widthToTraverse; x++)
+	for(int y = rowToWriteTo; y >= 0; y--)
 	{
-		for(int y = 0; y < heightToTraverse; y++)
+		for(int x = 0; x < GetWidth(); x++)
 		{
-			surfaceGrid->Set(startingX + x, startingY + y, NULL);
+			surfaceGrid(x, y) = NULL;
 		}
+
+		rowMasks[y] = 0;
+		MarkDirty(y, fullRowMask);
 	}
 }
 
 SDL_Surface* SDLSurfaceGrid::GetSurface(const Vector2D<int>& position) const
 {
-	return surfaceGrid->Get(position.x, position.y);
+	return surfaceGrid.Get(position.x, position.y);
+}
+
+bool SDLSurfaceGrid::TryGetSurface(const Vector2D<int>& position, SDL_Surface*& surface) const
+{
+	return surfaceGrid.TryGet(position.x, position.y, surface);
+}
+
+Dimensions2D<int> SDLSurfaceGrid::Clip(const Dimensions2D<int>& range) const
+{
+	return surfaceGrid.Clip(range);
+}
+
+int SDLSurfaceGrid::CountFilledCells(const Dimensions2D<int>* portion) const
+{
+	int firstY = 0;
+	int endY = GetHeight();
+
+	Uint64 columnsMask = fullRowMask;
+
+	if(portion != NULL)
+	{
+		firstY = portion->position.y;
+		endY = firstY + portion->size.height;
+
+		columnsMask = GetColumnRangeMask(portion->position.x, portion->position.x + portion->size.width);
+	}
+
+	int count = 0;
+
+	for(int y = firstY; y < endY; y++)
+	{
+		count += CountBits(rowMasks[y] & columnsMask);
+	}
+
+	return count;
+}
+
+Uint64 SDLSurfaceGrid::GetRowMask(int row) const
+{
+	return rowMasks[row];
+}
+
+Uint64 SDLSurfaceGrid::GetFullRowMask() const
+{
+	return fullRowMask;
+}
+
+vector<int> SDLSurfaceGrid::GetFullRowIndexes() const
+{
+	vector<int> fullRowIndexes;
+
+	for(int y = 0; y < GetHeight(); y++)
+	{
+		if(rowMasks[y] == fullRowMask)
+		{
+			fullRowIndexes.push_back(y);
+		}
+	}
+
+	return fullRowIndexes;
+}
+
+bool SDLSurfaceGrid::Collides(const SDLSurfaceGrid& target, const Vector2D<int>& targetBlockPosition,
+	bool treatOutsideBoundsAsCollision) const
+{
+	//The cells of this grid which target overlaps.
+	Dimensions2D<int> overlap = Clip(Dimensions2D<int>(targetBlockPosition.x, targetBlockPosition.y,
+		target.GetWidth(), target.GetHeight()));
+
+	//The same cells, in target's coordinates.
+	Dimensions2D<int> overlapInTarget(overlap.position.x - targetBlockPosition.x,
+		overlap.position.y - targetBlockPosition.y, overlap.size.width, overlap.size.height);
+
+	if(treatOutsideBoundsAsCollision &&
+		target.CountFilledCells() != target.CountFilledCells(&overlapInTarget))
+	{
+		return true;
+	}
+
+	Uint64 overlapColumnsMask = GetColumnRangeMask(overlapInTarget.position.x,
+		overlapInTarget.position.x + overlapInTarget.size.width);
+
+	for(int y = overlap.position.y; y < overlap.position.y + overlap.size.height; y++)
+	{
+		Uint64 targetRow = target.rowMasks[y - targetBlockPosition.y] & overlapColumnsMask;
+
+		if(targetRow == 0)
+		{
+			continue;
+		}
+
+		//Move the target's row into this grid's columns. The shift is safe, as only
+		//bits which land inside this grid are left in targetRow.
+		if(targetBlockPosition.x >= 0)
+		{
+			targetRow <<= targetBlockPosition.x;
+		}
+		else
+		{
+			targetRow >>= -targetBlockPosition.x;
+		}
+
+		if((targetRow & rowMasks[y]) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void SDLSurfaceGrid::SetCached(bool cached)
+{
+	//If caching is left enabled, the composite surface is rebuilt in full on the next draw.
+	compositeSurface.Free();
+
+	this->cached = cached;
+}
+
+bool SDLSurfaceGrid::IsCached() const
+{
+	return cached;
 }
 
 int SDLSurfaceGrid::GetWidth() const
 {
-	return surfaceGrid->GetWidth();
+	return surfaceGrid.GetWidth();
 }
 
 int SDLSurfaceGrid::GetHeight() const
 {
-	return surfaceGrid->GetHeight();
+	return surfaceGrid.GetHeight();
 }
 
 const Vector2D<int>& SDLSurfaceGrid::GetAnchor() const
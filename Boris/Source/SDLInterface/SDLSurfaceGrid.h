@@ -25,6 +25,8 @@
 #ifndef SDL_SURFACE_GRID_H
 #define SDL_SURFACE_GRID_H
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -67,16 +69,65 @@ namespace SDLInterfaceLibrary
 
 		A surface grid is a rectangular array of SDL_Surface pointers. This class
 		specifies a series of methods to assert, draw, and manage this array.
+
+		Note:
+			Alongside the surfaces, the grid keeps a bitmask of the filled cells in
+			each row, which limits it to 64 columns.
 	*/
 	class SDLSurfaceGrid
 	{
 		private:
+			//Owns the pre-composited surface used in cached mode. Copies of a grid do not
+			//share it, they start without one and build their own when first drawn.
+			class CompositeSurface
+			{
+				public:
+					SDL_Surface* surface;
+
+					CompositeSurface(): surface(NULL) {}
+					CompositeSurface(const CompositeSurface&): surface(NULL) {}
+
+					CompositeSurface& operator=(const CompositeSurface&)
+					{
+						Free();
+						return *this;
+					}
+
+					void Free()
+					{
+						if(surface != NULL)
+						{
+							SDL_FreeSurface(surface);
+							surface = NULL;
+						}
+					}
+
+					~CompositeSurface()
+					{
+						Free();
+					}
+			};
+
 			string name;
 
 			//The size of the surfaces.
 			Bounds2D<int> surfaceSize;
 
-			Grid<SDL_Surface*>* surfaceGrid;
+			//The surfaces in this grid, stored by value in a single row-major buffer.
+			Grid<SDL_Surface*> surfaceGrid;
+
+			//One bitmask per row, bit x of rowMasks[y] is set when cell (x, y) holds a surface.
+			//Kept in sync by Replace and ClearSurfaceGrid.
+			vector<Uint64> rowMasks;
+			//The mask of a row in which every cell holds a surface.
+			Uint64 fullRowMask;
+
+			//True if the grid is drawn through compositeSurface, see SetCached.
+			bool cached;
+			CompositeSurface compositeSurface;
+			//Bit x of dirtyRowMasks[y] is set when cell (x, y) has changed since it was last
+			//drawn into compositeSurface. Only kept up to date in cached mode.
+			vector<Uint64> dirtyRowMasks;
 
 			//The position (In pixels) from where the surfaces are drawn.
 			Vector2D<int> anchor;
@@ -94,6 +145,20 @@ namespace SDLInterfaceLibrary
 			void ConfirmBlockPosition(const Vector2D<int>& blockPosition) const;
 			//Asserts that a given surface has a size that conforms to the one specified in surfaceSize
 			void ConfirmSurfaceSize(SDL_Surface* surface);
+			//Asserts that the grid is narrow enough for each of it's rows to fit in a row mask, and
+			//sets fullRowMask accordingly.
+			void InitializeRowMasks();
+
+			//Marks the cells [columns] of row [row] as changed, in cached mode.
+			void MarkDirty(int row, Uint64 columns);
+			//Creates compositeSurface if needed, or anew if [screen] has changed format, and
+			//redraws the changed cells into it.
+			void UpdateCompositeSurface(SDL_Surface* screen);
+
+			//Returns a mask with the bits of columns [firstColumn, endColumn) set.
+			static Uint64 GetColumnRangeMask(int firstColumn, int endColumn);
+			//Returns the number of set bits in mask.
+			static int CountBits(Uint64 mask);
 		public:
 			/*
 				Constructor: SDLSurfaceGrid
@@ -152,6 +217,37 @@ namespace SDLInterfaceLibrary
 					screen - The screen where the surfaces will be blitted.
 			*/
 			void Blit(const Vector2D<int>& position, SDL_Surface* screen);
+			/*
+				Function: SetCached
+
+				In cached mode the grid keeps a private surface, the size of the whole grid, on
+				which it's surfaces are pre-composited. <SDLSurfaceGrid::Blit> then only redraws
+				the cells which were changed since the last draw into that surface, and copies it
+				to the screen in a single blit. The surface is in the format of the screen, and is
+				made anew if that changes.
+
+				The surface is RLE accelerated, and SDL encodes all of it again after every
+				change, so a change costs several times as much as drawing the grid cell by
+				cell. This only suits grids which are drawn many times between changes.
+
+				Empty cells are made transparent through a colour key (Magenta, 255 0 255), so
+				that colour should not be used in the surfaces of a cached grid.
+
+				Parameters:
+					cached - True to enable cached mode, false to disable it and free the
+							 private surface.
+			*/
+			void SetCached(bool cached);
+			/*
+				Function: IsCached
+
+				Returns:
+					True if the grid is in cached mode.
+
+				See Also:
+					<SDLSurfaceGrid::SetCached>
+			*/
+			bool IsCached() const;
 			/*
 				Function: Replace
 
@@ -207,10 +303,23 @@ namespace SDLInterfaceLibrary
 				Sets all the surfaces in this grid to NULL.
 
 				Parameters:
-					portionToClear - If not NULL, the portion which will be copied from this surface grid.
+					portionToClear - If not NULL, the portion which will be cleared. Any part of it
+									 which lies outside the grid is ignored.
 									 Default Value: NULL.
 			*/
 			void ClearSurfaceGrid(Dimensions2D<int>* portionToClear = NULL);
+			/*
+				Function: CollapseRows
+
+				Removes the rows [rowIndexes] from the grid, and moves every row above them
+				down to fill the gap. The rows freed at the top of the grid are left empty.
+				This is done in a single pass over the grid, from the bottom up.
+
+				Parameters:
+					rowIndexes - The indexes of the rows which will be removed. They may be
+								 given in any order, and duplicates are ignored.
+			*/
+			void CollapseRows(const vector<int>& rowIndexes);
 			/*
 				Function: GetSurface
 
@@ -221,6 +330,95 @@ namespace SDLInterfaceLibrary
 					The surface at the given position [position]
 			*/
 			SDL_Surface* GetSurface(const Vector2D<int>& position) const;
+			/*
+				Function: TryGetSurface
+
+				Non-throwing alternative to <SDLSurfaceGrid::GetSurface>.
+
+				Parameters:
+					position - The position of the surface you wish to retrieve.
+
+					surface - Receives the surface at [position]. Left untouched if
+							  [position] is outside the grid.
+
+				Returns:
+					True if [position] lies within the grid, false otherwise.
+			*/
+			bool TryGetSurface(const Vector2D<int>& position, SDL_Surface*& surface) const;
+			/*
+				Function: Clip
+
+				Parameters:
+					range - A rectangle of cells, which may lie partly or entirely outside the grid.
+
+				Returns:
+					The portion of [range] which lies within the grid. If the two do not overlap,
+					the returned rectangle has a width and height of 0.
+			*/
+			Dimensions2D<int> Clip(const Dimensions2D<int>& range) const;
+			/*
+				Function: CountFilledCells
+
+				Parameters:
+					portion - If not NULL, the portion of the grid in which to count. It must
+							  lie within the grid, see <SDLSurfaceGrid::Clip>.
+							  Default Value: NULL.
+
+				Returns:
+					The number of cells which hold a surface.
+			*/
+			int CountFilledCells(const Dimensions2D<int>* portion = NULL) const;
+			/*
+				Function: GetRowMask
+
+				Parameters:
+					row - The index of the row, which must be within the grid.
+
+				Returns:
+					A bitmask of the filled cells in row [row]. Bit x is set when
+					the cell at (x, [row]) holds a surface.
+			*/
+			Uint64 GetRowMask(int row) const;
+			/*
+				Function: GetFullRowMask
+
+				Returns:
+					The row mask of a row in which every cell holds a surface.
+			*/
+			Uint64 GetFullRowMask() const;
+			/*
+				Function: GetFullRowIndexes
+
+				Returns:
+					The indexes, from top to bottom, of the rows in which every cell
+					holds a surface.
+			*/
+			vector<int> GetFullRowIndexes() const;
+			/*
+				Function: Collides
+
+				Parameters:
+					target - The surface grid which will be compared to this one.
+
+					targetBlockPosition - The position of cell (0, 0) of [target] in
+										  this grid's cells. It may lie outside this grid.
+
+					treatOutsideBoundsAsCollision - If true, a filled cell of [target]
+													which falls outside this grid counts
+													as a collision.
+
+				Returns:
+					True if a filled cell of [target] overlaps a filled cell of this
+					grid (Or lies outside of it, see above).
+
+				Note:
+					The overlap of both grids is computed up front, and the cells of [target]
+					which lie outside it are counted rather than looked up, so no exceptions
+					are thrown at the edges. The overlap itself is tested a row at a time,
+					using the row masks of both grids.
+			*/
+			bool Collides(const SDLSurfaceGrid& target, const Vector2D<int>& targetBlockPosition,
+				bool treatOutsideBoundsAsCollision) const;
 			/*
 				Function: GetWidth
 
@@ -299,6 +497,17 @@ namespace SDLInterfaceLibrary
 			void SetAnchor(const Vector2D<int>& anchorBlockPosition, SDLSurfacePoint anchorPoint);
 
 	};
+	/*
+		Type: SharedSDLSurfaceGrid
+
+		A reference counted surface grid. Components which are built from the same shapes
+		(Such as the rotations of a tetromino) can share them through this type, rather
+		than each keeping a copy.
+
+		See Also:
+			<SDLSurfaceGridComponent>
+	*/
+	typedef shared_ptr<SDLSurfaceGrid> SharedSDLSurfaceGrid;
 }
 
 #endif
@@ -24,29 +24,152 @@
 
 #include <SDLInterface/SDLSurfaceGridComponent.h>
 #include <SDLInterface/SDLForm.h>
+#include <SDLInterface/SDLInstance.h>
 
 using namespace SDLInterfaceLibrary;
 
-void SDLSurfaceGridComponent::Blit()
+bool SDLSurfaceGridComponent::CanDrawIncrementally(Vector2D<int>& cellShift) const
 {
-	previousDimensions = Dimensions2D<int>(GetLeftFromParent() - GetCurrentSurfaceGrid().GetAnchor().x,
-		GetTopFromParent() - GetCurrentSurfaceGrid().GetAnchor().y, GetWidth(), GetHeight());
+	if(previouslyBlittedSurfaceGrid == NULL)
+	{
+		return false;
+	}
 
-	previousOffsetToOrigin = Vector2D<int>(GetLeftFromOrigin() - GetCurrentSurfaceGrid().GetAnchor().x,
-		GetTopFromOrigin() - GetCurrentSurfaceGrid().GetAnchor().y);
+	const SDLSurfaceGrid& currentSurfaceGrid = GetConstCurrentSurfaceGrid();
+	const Bounds2D<int>& cellSize = currentSurfaceGrid.GetSurfaceSize();
 
-	if(clearingMethod == SDL_CM_PRECISE)
+	if(cellSize != previouslyBlittedSurfaceGrid->GetSurfaceSize())
+	{
+		return false;
+	}
+
+	Vector2D<int> offsetToOrigin(GetLeftFromOrigin() - currentSurfaceGrid.GetAnchor().x,
+		GetTopFromOrigin() - currentSurfaceGrid.GetAnchor().y);
+
+	Vector2D<int> movement = offsetToOrigin - previousOffsetToOrigin;
+
+	if(movement.x % cellSize.width != 0 || movement.y % cellSize.height != 0)
+	{
+		return false;
+	}
+
+	//If anything was drawn over the previous position earlier in this frame (The parent
+	//being redrawn, for instance) then the cells which would be left in place are gone.
+	SDL_Rect previousArea;
+
+	previousArea.x = previousOffsetToOrigin.x;
+	previousArea.y = previousOffsetToOrigin.y;
+	previousArea.w = previousDimensions.size.width;
+	previousArea.h = previousDimensions.size.height;
+
+	if(SDLInstance::GetInstance().GetDamageList().Intersects(previousArea))
 	{
-		if(previouslyBlittedSurfaceGrid != NULL)
+		return false;
+	}
+
+	cellShift = Vector2D<int>(movement.x / cellSize.width, movement.y / cellSize.height);
+
+	return true;
+}
+
+void SDLSurfaceGridComponent::RestoreCell(const Vector2D<int>& cellPosition)
+{
+	const Bounds2D<int>& cellSize = previouslyBlittedSurfaceGrid->GetSurfaceSize();
+
+	Vector2D<int> surfaceDrawingOrigin(cellPosition.x * cellSize.width, cellPosition.y * cellSize.height);
+	Vector2D<int> surfacePositionOnParent = surfaceDrawingOrigin;
+
+	surfaceDrawingOrigin += previousOffsetToOrigin;
+	surfacePositionOnParent += previousDimensions.position;
+
+	SDL_Rect offset;
+
+	offset.x = surfaceDrawingOrigin.x;
+	offset.y = surfaceDrawingOrigin.y;
+
+	SDL_Rect segmentRect;
+
+	segmentRect.x = surfacePositionOnParent.x;
+	segmentRect.y = surfacePositionOnParent.y;
+
+	segmentRect.w = cellSize.width;
+	segmentRect.h = cellSize.height;
+
+	if(SDL_BlitSurface(GetParent()->GetImage(), &segmentRect, GetScreen(), &offset) == -1)
+	{
+		throw SDLException();
+	}
+
+	AddDamage(offset);
+}
+
+void SDLSurfaceGridComponent::BlitCell(const Vector2D<int>& cellPosition)
+{
+	const SDLSurfaceGrid& currentSurfaceGrid = GetConstCurrentSurfaceGrid();
+	const Bounds2D<int>& cellSize = currentSurfaceGrid.GetSurfaceSize();
+
+	SDL_Rect offset;
+
+	offset.x = GetLeftFromOrigin() - currentSurfaceGrid.GetAnchor().x + cellPosition.x * cellSize.width;
+	offset.y = GetTopFromOrigin() - currentSurfaceGrid.GetAnchor().y + cellPosition.y * cellSize.height;
+
+	if(SDL_BlitSurface(currentSurfaceGrid.GetSurface(cellPosition), NULL, GetScreen(), &offset) == -1)
+	{
+		throw SDLException();
+	}
+
+	AddDamage(offset);
+}
+
+void SDLSurfaceGridComponent::Blit()
+{
+	const SDLSurfaceGrid& currentSurfaceGrid = GetConstCurrentSurfaceGrid();
+
+	if(drawIncrementally)
+	{
+		//Only the cells which were not already on the screen, with the same surface, are drawn.
+		for(int y = 0; y < currentSurfaceGrid.GetHeight(); y++)
 		{
-			delete previouslyBlittedSurfaceGrid;
+			for(int x = 0; x < currentSurfaceGrid.GetWidth(); x++)
+			{
+				SDL_Surface* currentSurface = currentSurfaceGrid.GetSurface(Vector2D<int>(x, y));
+				SDL_Surface* previousSurface = NULL;
+
+				previouslyBlittedSurfaceGrid->TryGetSurface(Vector2D<int>(x, y) + incrementalCellShift, previousSurface);
+
+				if(currentSurface != NULL && currentSurface != previousSurface)
+				{
+					BlitCell(Vector2D<int>(x, y));
+				}
+			}
 		}
 
-		previouslyBlittedSurfaceGrid = new SDLSurfaceGrid(GetCurrentSurfaceGrid());
+		drawIncrementally = false;
+	}
+	else
+	{
+		surfaceGrids[currentSurfaceGridIndex]->Blit(Vector2D<int>(GetLeftFromOrigin(), GetTopFromOrigin()), GetScreen());
+
+		SDL_Rect drawnArea;
+
+		drawnArea.x = GetLeftFromOrigin() - currentSurfaceGrid.GetAnchor().x;
+		drawnArea.y = GetTopFromOrigin() - currentSurfaceGrid.GetAnchor().y;
+		drawnArea.w = GetWidth();
+		drawnArea.h = GetHeight();
+
+		AddDamage(drawnArea, currentSurfaceGrid.IsCached()? 1: currentSurfaceGrid.CountFilledCells());
 	}
 
+	previousDimensions = Dimensions2D<int>(GetLeftFromParent() - currentSurfaceGrid.GetAnchor().x,
+		GetTopFromParent() - currentSurfaceGrid.GetAnchor().y, GetWidth(), GetHeight());
+
+	previousOffsetToOrigin = Vector2D<int>(GetLeftFromOrigin() - currentSurfaceGrid.GetAnchor().x,
+		GetTopFromOrigin() - currentSurfaceGrid.GetAnchor().y);
 
-	GetCurrentSurfaceGrid().Blit(Vector2D<int>(GetLeftFromOrigin(), GetTopFromOrigin()), GetScreen());
+	if(clearingMethod == SDL_CM_PRECISE)
+	{
+		previouslyBlittedSurfaceGrid = surfaceGrids[currentSurfaceGridIndex];
+	}
 }
 
 void SDLSurfaceGridComponent::Clear()
@@ -57,40 +180,33 @@ void SDLSurfaceGridComponent::Clear()
 	}
 	else
 	{
+		drawIncrementally = CanDrawIncrementally(incrementalCellShift);
+
 		for(int x = 0; x < previouslyBlittedSurfaceGrid->GetWidth(); x++)
 		{
 			for(int y = 0; y < previouslyBlittedSurfaceGrid->GetHeight(); y++)
 			{
 				SDL_Surface* surfaceToClear = previouslyBlittedSurfaceGrid->GetSurface(Vector2D<int>(x, y));
 
-				if(surfaceToClear != NULL)
+				if(surfaceToClear == NULL)
 				{
-					Vector2D<int> surfaceDrawingOrigin(x * previouslyBlittedSurfaceGrid->GetSurfaceSize().width,
-						y * previouslyBlittedSurfaceGrid->GetSurfaceSize().height);
-
-					Vector2D<int> surfacePositionOnParent = surfaceDrawingOrigin;
-
-					surfaceDrawingOrigin += previousOffsetToOrigin;
-					surfacePositionOnParent += previousDimensions.position;
-
-					SDL_Rect offset;
-
-					offset.x = surfaceDrawingOrigin.x;
-					offset.y = surfaceDrawingOrigin.y;
-
-					SDL_Rect segmentRect;
+					continue;
+				}
 
-					segmentRect.x = surfacePositionOnParent.x;
-					segmentRect.y = surfacePositionOnParent.y;
+				if(drawIncrementally)
+				{
+					//A cell which stays under the component, with the same surface, is left alone.
+					SDL_Surface* currentSurface = NULL;
 
-					segmentRect.w = previouslyBlittedSurfaceGrid->GetSurfaceSize().width;
-					segmentRect.h =  previouslyBlittedSurfaceGrid->GetSurfaceSize().height;
+					GetConstCurrentSurfaceGrid().TryGetSurface(Vector2D<int>(x, y) - incrementalCellShift, currentSurface);
 
-					if(SDL_BlitSurface(GetParent()->GetImage(), &segmentRect, GetScreen(), &offset) == -1)
+					if(currentSurface == surfaceToClear)
 					{
-						throw SDLException();
+						continue;
 					}
 				}
+
+				RestoreCell(Vector2D<int>(x, y));
 			}
 		}
 	}
@@ -107,11 +223,30 @@ SDLSurfaceGridComponent::SDLSurfaceGridComponent(const string& name, const Vecto
 	}
 
 	this->clearingMethod = clearingMethod;
+	drawIncrementally = false;
+
+	for(unsigned int i = 0; i < surfaceGrids.size(); i++)
+	{
+		this->surfaceGrids.push_back(make_shared<SDLSurfaceGrid>(surfaceGrids[i]));
+	}
 
-	this->surfaceGrids = surfaceGrids;
 	currentSurfaceGridIndex = 0;
+}
 
-	previouslyBlittedSurfaceGrid = NULL;
+SDLSurfaceGridComponent::SDLSurfaceGridComponent(const string& name, const Vector2D<int>& position,
+	const vector<SharedSDLSurfaceGrid>& surfaceGrids, SDLClearingMethod clearingMethod):
+	SDLComponent(name, position, NULL)
+{
+	if(surfaceGrids.size() == 0)
+	{
+		string error = "Error when initializing " + name + ": Attempted to pass empty surface grid collection.";
+	}
+
+	this->clearingMethod = clearingMethod;
+	drawIncrementally = false;
+
+	this->surfaceGrids = surfaceGrids;
+	currentSurfaceGridIndex = 0;
 }
 
 void SDLSurfaceGridComponent::First()
@@ -149,14 +284,27 @@ void SDLSurfaceGridComponent::Previous()
 }
 
 
+SDLSurfaceGrid& SDLSurfaceGridComponent::GetWritableSurfaceGrid(unsigned int index)
+{
+	SharedSDLSurfaceGrid& surfaceGrid = surfaceGrids[index];
+
+	//Copy on write, so that other holders of this grid are unaffected.
+	if(surfaceGrid.use_count() > 1)
+	{
+		surfaceGrid = make_shared<SDLSurfaceGrid>(*surfaceGrid);
+	}
+
+	return *surfaceGrid;
+}
+
 SDLSurfaceGrid& SDLSurfaceGridComponent::GetCurrentSurfaceGrid()
 {
-	return surfaceGrids[currentSurfaceGridIndex];
+	return GetWritableSurfaceGrid(currentSurfaceGridIndex);
 }
 
 const SDLSurfaceGrid& SDLSurfaceGridComponent::GetConstCurrentSurfaceGrid() const
 {
-	return surfaceGrids[currentSurfaceGridIndex];
+	return *surfaceGrids[currentSurfaceGridIndex];
 }
 
 int	SDLSurfaceGridComponent::GetWidth() const
@@ -177,6 +325,22 @@ void SDLSurfaceGridComponent::ClearCurrentSurfaces(Dimensions2D<int>* portionToC
 	Update();
 }
 
+void SDLSurfaceGridComponent::CollapseCurrentRows(const vector<int>& rowIndexes)
+{
+	GetCurrentSurfaceGrid().CollapseRows(rowIndexes);
+	Update();
+}
+
+void SDLSurfaceGridComponent::SetCached(bool cached)
+{
+	for(unsigned int i = 0; i < surfaceGrids.size(); i++)
+	{
+		GetWritableSurfaceGrid(i).SetCached(cached);
+	}
+
+	Update();
+}
+
 void SDLSurfaceGridComponent::ReplaceCurrentSurfaces(const SDLSurfaceGrid& surfaceGrid,
 	const Vector2D<int>& positionToCopyTo, bool nullOverwrite, Dimensions2D<int>* portionToCopy)
 {
@@ -187,13 +351,13 @@ void SDLSurfaceGridComponent::ReplaceCurrentSurfaces(const SDLSurfaceGrid& surfa
 
 SDLSurfaceGrid SDLSurfaceGridComponent::CopyCurrentSurfaces(Dimensions2D<int>* portionToCopy)
 {
-	return GetCurrentSurfaceGrid().Copy(portionToCopy);
+	return GetConstCurrentSurfaceGrid().Copy(portionToCopy);
 }
 
 
 bool SDLSurfaceGridComponent::SurfacesCollide(const SDLSurfaceGridComponent& target, bool treatOutsideBoundsAsCollision)
 {
-	const Bounds2D<int> surfaceSize = this->GetCurrentSurfaceGrid().GetSurfaceSize();
+	const Bounds2D<int> surfaceSize = this->GetConstCurrentSurfaceGrid().GetSurfaceSize();
 
 	if(surfaceSize != target.GetConstCurrentSurfaceGrid().GetSurfaceSize())
 	{
@@ -203,7 +367,7 @@ bool SDLSurfaceGridComponent::SurfacesCollide(const SDLSurfaceGridComponent& tar
 	Vector2D<int> positionOnMainSurface(GetLeftFromOrigin(), GetTopFromOrigin());
 	Vector2D<int> targetPositionOnMainSurface(target.GetLeftFromOrigin(), target.GetTopFromOrigin());
 
-	positionOnMainSurface -= GetCurrentSurfaceGrid().GetAnchor();
+	positionOnMainSurface -= GetConstCurrentSurfaceGrid().GetAnchor();
 	targetPositionOnMainSurface -= target.GetConstCurrentSurfaceGrid().GetAnchor();
 
 
@@ -218,44 +382,6 @@ bool SDLSurfaceGridComponent::SurfacesCollide(const SDLSurfaceGridComponent& tar
 	distanceBetweenThisAndTarget.x /= surfaceSize.width;
 	distanceBetweenThisAndTarget.y /= surfaceSize.height;
 
-	const SDLSurfaceGrid& targetSurfaceGrid = target.GetConstCurrentSurfaceGrid();
-
-	for(int x = 0; x < targetSurfaceGrid.GetWidth(); x++)
-	{
-		for(int y = 0; y < targetSurfaceGrid.GetHeight(); y++)
-		{
-			SDL_Surface* targetSurface = targetSurfaceGrid.GetSurface(Vector2D<int>(x, y));
-			SDL_Surface* mySurface = NULL;
-
-
-			try
-			{
-				mySurface = GetCurrentSurfaceGrid().GetSurface(Vector2D<int>(x, y) +
-										distanceBetweenThisAndTarget);
-
-				if(mySurface != NULL && targetSurface != NULL)
-				{
-					return true;
-				}
-
-			}
-			catch(GridException& outOfBoundsError)
-			{
-				if(treatOutsideBoundsAsCollision && targetSurface != NULL)
-				{
-					return true;
-				}
-			}
-		}
-	}
-
-	return false;
-}
-
-SDLSurfaceGridComponent::~SDLSurfaceGridComponent()
-{
-	if(previouslyBlittedSurfaceGrid != NULL)
-	{
-		delete previouslyBlittedSurfaceGrid;
-	}
+	return GetConstCurrentSurfaceGrid().Collides(target.GetConstCurrentSurfaceGrid(),
+		distanceBetweenThisAndTarget, treatOutsideBoundsAsCollision);
 }
@@ -42,7 +42,9 @@ namespace SDLInterfaceLibrary
 		Defines the method which will be used to clear a surface grid component from the screen.
 
 		SDL_CM_PRECISE - The component will be cleared precisely, so that any only filled surfaces
-						 will be cleared. This is useful for complex shapes.
+						 will be cleared. This is useful for complex shapes. When the component
+						 moves by whole cells, only the cells it vacated are cleared and only
+						 those it newly occupies are blitted.
 
 		SDL_CM_BOUNDING_BOX - The component will be cleared using an area which covers all it's
 							  rows and columns. This method is a lot more efficient, but will include
@@ -72,15 +74,37 @@ namespace SDLInterfaceLibrary
 	class SDLSurfaceGridComponent: public SDLComponent
 	{
 		private:
-			//The surface grid which was blitted on the screen in the last drawing cycle.
-			SDLSurfaceGrid* previouslyBlittedSurfaceGrid;
+			//The surface grid which was blitted on the screen in the last drawing cycle. This
+			//shares the grid in surfaceGrids, which is copied before being modified, see
+			//GetCurrentSurfaceGrid.
+			shared_ptr<const SDLSurfaceGrid> previouslyBlittedSurfaceGrid;
 
-			vector<SDLSurfaceGrid> surfaceGrids;
+			vector<SharedSDLSurfaceGrid> surfaceGrids;
 			//The index of the surface grid currently displayed by this component.
 			unsigned int currentSurfaceGridIndex;
 
 			SDLClearingMethod clearingMethod;
 
+			//True if the last call to Clear only restored the cells which were vacated, in
+			//which case Blit only draws the cells which are newly occupied.
+			bool drawIncrementally;
+			//The offset, in cells, from a cell of the current surface grid to the cell of
+			//previouslyBlittedSurfaceGrid which lay at the same place on the screen.
+			Vector2D<int> incrementalCellShift;
+
+			//Returns the surface grid at [index], replacing it first with a private copy
+			//if it is shared.
+			SDLSurfaceGrid& GetWritableSurfaceGrid(unsigned int index);
+
+			//Returns true if the component can be redrawn by diffing the previous and current
+			//cells, and sets [cellShift] accordingly. This requires the component to have
+			//moved by whole cells, and nothing else to have been drawn over it this frame.
+			bool CanDrawIncrementally(Vector2D<int>& cellShift) const;
+			//Restores the background behind cell [cellPosition] of previouslyBlittedSurfaceGrid.
+			void RestoreCell(const Vector2D<int>& cellPosition);
+			//Blits cell [cellPosition] of the current surface grid.
+			void BlitCell(const Vector2D<int>& cellPosition);
+
 		protected:
 			/*
 				Function: Blit
@@ -115,6 +139,27 @@ namespace SDLInterfaceLibrary
 			*/
 			SDLSurfaceGridComponent(const string& name, const Vector2D<int>& position,
 					const vector<SDLSurfaceGrid>& surfaceGrids, SDLClearingMethod clearingMethod);
+			/*
+				Constructor: SDLSurfaceGridComponent
+
+				Parameters:
+					name - The name of the component--This is used to identify which
+							component has failed if an exception occurs.
+
+					position - The position of the component on the parent, not the screen.
+
+					surfaceGrids - A collection of surface grids which will be shared, rather than
+								   copied, by this component. They are only copied if this component
+								   modifies them while they are still shared.
+
+					clearingMethod - The method which will be used to clear this component from the screen.
+
+				See Also:
+					<SDLClearingMethod>
+					<SDLSurfaceGridComponent::GetCurrentSurfaceGrid>
+			*/
+			SDLSurfaceGridComponent(const string& name, const Vector2D<int>& position,
+					const vector<SharedSDLSurfaceGrid>& surfaceGrids, SDLClearingMethod clearingMethod);
 
 			/*
 				Function: First
@@ -141,6 +186,10 @@ namespace SDLInterfaceLibrary
 			/*
 				Function: GetCurrentSurfaceGrid
 
+				If the current surface grid is shared, with another component or with the record
+				of what was last drawn, it is first replaced by a private copy. Use
+				<SDLSurfaceGridComponent::GetConstCurrentSurfaceGrid> when only reading.
+
 				Returns:
 					A read/write reference to the surface grid this component is currently pointing to.
 			*/
@@ -176,6 +225,25 @@ namespace SDLInterfaceLibrary
 					<SDLSurfaceGrid::ClearSurfaces>
 			*/
 			void ClearCurrentSurfaces(Dimensions2D<int>* portionToClear);
+			/*
+				Function: CollapseCurrentRows
+
+				Calls the method "CollapseRows" for the current surface grid. This method
+				also informs the component that it must draw itself in the next cycle.
+
+				See Also:
+					<SDLSurfaceGrid::CollapseRows>
+			*/
+			void CollapseCurrentRows(const vector<int>& rowIndexes);
+			/*
+				Function: SetCached
+
+				Calls the method "SetCached" for every surface grid in this component.
+
+				See Also:
+					<SDLSurfaceGrid::SetCached>
+			*/
+			void SetCached(bool cached);
 			/*
 				Function: ReplaceCurrentSurfaces
 
@@ -237,14 +305,6 @@ namespace SDLInterfaceLibrary
 
 			*/
 			bool SurfacesCollide(const SDLSurfaceGridComponent& target, bool treatOutsideBoundsAsCollision = false);
-			/*
-				Destructor: SDLSurfaceGridComponent
-
-				This class keeps a copy of the previously drawn surface grid in memory (So that
-				it can later be cleared), therefore it needs to be removed from memory when this
-				component is destroyed.
-			*/
-			~SDLSurfaceGridComponent();
 	};
 }
 
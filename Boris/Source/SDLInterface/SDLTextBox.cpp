@@ -23,6 +23,7 @@
 */
 
 #include <SDLInterface/SDLTextBox.h>
+#include <SDLInterface/SDLInstance.h>
 
 using namespace SDLInterfaceLibrary;
 using namespace EventHandling;
@@ -63,23 +64,23 @@ void SDLTextBox::HandleInput(int keySymbol)
 		{
 			char convertedSymbol = keySymbol;
 
-			if(SDL_GetKeyState(NULL)[SDLK_LSHIFT] || SDL_GetModState() & KMOD_CAPS)
+			if(SDLInstance::GetInstance().KeyIsPressed(SDLK_LSHIFT) || SDLInstance::GetInstance().GetKeyModifiers() & KMOD_CAPS)
 			{
 				if(keySymbol >= SDLK_a && keySymbol <= SDLK_z)
 				{
-					if(SDL_GetKeyState(NULL)[SDLK_LSHIFT])
+					if(SDLInstance::GetInstance().KeyIsPressed(SDLK_LSHIFT))
 					{
-						if(SDL_GetModState() | KMOD_CAPS)
+						if(SDLInstance::GetInstance().GetKeyModifiers() | KMOD_CAPS)
 						{
 							convertedSymbol = keySymbol - 32;
 						}
 					}
-					else if(SDL_GetModState() & KMOD_CAPS)
+					else if(SDLInstance::GetInstance().GetKeyModifiers() & KMOD_CAPS)
 					{
 						convertedSymbol = keySymbol - 32;
 					}
 				}
-				else if(SDL_GetKeyState(NULL)[SDLK_LSHIFT])
+				else if(SDLInstance::GetInstance().KeyIsPressed(SDLK_LSHIFT))
 				{
 					map<char, char>::iterator foundSymbol = shiftMap.find(keySymbol);
 
@@ -23,16 +23,24 @@
 */
 
 #include <SDLInterface/SDLTimer.h>
+#include <SDLInterface/SDLInstance.h>
+#include <SDLInterface/SDLForm.h>
 
 using namespace SDLInterfaceLibrary;
 using namespace EventHandling;
 
-SDLTimer::SDLTimer(int interval)
+SDLTimer::SDLTimer(int interval, bool repeating)
 {
 	this->interval = interval;
+	this->repeating = repeating;
 	this->currentCycleProgress = 0;
-	
+
+	this->started = false;
 	this->paused = false;
+	this->suspended = false;
+
+	this->handle = 0;
+	this->form = NULL;
 }
 
 GenericEventHandlerCollection& SDLTimer::GetCycleCompleteEventHandlers()
@@ -40,32 +48,111 @@ GenericEventHandlerCollection& SDLTimer::GetCycleCompleteEventHandlers()
 	return cycleCompleteEventHandlers;
 }
 
+void SDLTimer::UpdateSchedule()
+{
+	SDLTimerWheel& timerWheel = SDLInstance::GetInstance().GetTimerWheel();
+
+	if(IsRunning() && handle == 0)
+	{
+		handle = timerWheel.Schedule(interval - currentCycleProgress, repeating? interval: 0,
+			new CPPGenericEventHandler<SDLTimer>(this, &SDLTimer::CompleteCycle));
+	}
+	else if(!IsRunning() && handle != 0)
+	{
+		currentCycleProgress = interval - timerWheel.GetTimeUntil(handle);
+
+		timerWheel.Cancel(handle);
+		handle = 0;
+	}
+}
+
+void SDLTimer::CompleteCycle()
+{
+	currentCycleProgress = 0;
+
+	//One-shot timers are taken off the wheel as they fire.
+	if(!repeating)
+	{
+		started = false;
+		handle = 0;
+	}
+
+	cycleCompleteEventHandlers.RaiseEvents();
+}
+
 void SDLTimer::SetInterval(int interval)
 {
+	SDLTimerWheel& timerWheel = SDLInstance::GetInstance().GetTimerWheel();
+
+	if(handle != 0)
+	{
+		currentCycleProgress = this->interval - timerWheel.GetTimeUntil(handle);
+
+		timerWheel.Cancel(handle);
+		handle = 0;
+	}
+
 	this->interval = interval;
+
+	//If the progress already exceeds the new interval, the timer fires on the next tick.
+	UpdateSchedule();
+}
+
+void SDLTimer::Start()
+{
+	Stop();
+
+	started = true;
+	UpdateSchedule();
+}
+
+void SDLTimer::Stop()
+{
+	started = false;
+	UpdateSchedule();
+
+	currentCycleProgress = 0;
 }
 
 void SDLTimer::Pause()
 {
 	paused = true;
+	UpdateSchedule();
 }
 
 void SDLTimer::Continue()
 {
 	paused = false;
+	UpdateSchedule();
+}
+
+void SDLTimer::SetSuspended(bool suspended)
+{
+	this->suspended = suspended;
+	UpdateSchedule();
+}
+
+bool SDLTimer::IsRunning() const
+{
+	return started && !paused && !suspended;
 }
 
+SDLForm* SDLTimer::GetForm() const
+{
+	return form;
+}
 
-void SDLTimer::Tick(int fps)
+void SDLTimer::SetForm(SDLForm* form)
 {
-	if(!paused)
-	{
-		currentCycleProgress += 1000/fps;
+	this->form = form;
+}
 
-		if(currentCycleProgress >= interval)
-		{
-			cycleCompleteEventHandlers.RaiseEvents();
-			currentCycleProgress = 0;
-		}
+SDLTimer::~SDLTimer()
+{
+	if(form != NULL)
+	{
+		form->RemoveTimer(*this);
 	}
+
+	SDLInstance::GetInstance().GetTimerWheel().Cancel(handle);
 }
@@ -26,40 +26,71 @@
 #define SDL_TIMER_H
 
 #include <EventHandling/GenericEventHandler.h>
+#include <SDLInterface/SDLTimerWheel.h>
 
 using namespace EventHandling;
 
 namespace SDLInterfaceLibrary
 {
+	class SDLForm;
+
 	/*
 		Class: SDLTimer
 
 		Objects derived from this class will raise a generic event when
-		an amount of time has elapsed. They are tied to SDLForms which
-		control their internal counting process using the application's
-		capped FPS.
+		an amount of time has elapsed. They are scheduled on the SDLInstance's
+		timer wheel, which is advanced in fixed simulation steps measured against
+		a real time clock, so that they keep time regardless of the frame rate.
+
+		A timer starts running once it is added to an SDLForm, and is suspended
+		whenever that form does not have the focus. Timers which are not needed
+		by any form can be started directly.
+
+		Note:
+			A timer created in lua is destroyed, and taken off the wheel, once it is
+			no longer referenced.
 
 		See Also:
 			<SDLForm>
+			<SDLTimerWheel>
 	*/
 	class SDLTimer
 	{
 		private:
-			//The amount (in milliseconds) the current cycle has progressed.
-			int currentCycleProgress;
+			//The interval in milliseconds.
 			int interval;
+			bool repeating;
 
+			bool started;
 			bool paused;
+			//True while the form this timer belongs to does not have the focus.
+			bool suspended;
+
+			//The amount (in milliseconds) the current cycle had progressed when the timer
+			//was last taken off the wheel.
+			int currentCycleProgress;
+			//The timer's entry on the wheel, 0 if it is not scheduled.
+			SDLTimerHandle handle;
 
 			GenericEventHandlerCollection cycleCompleteEventHandlers;
+
+			//The form this timer was added to, if any.
+			SDLForm* form;
+
+			//Schedules, or unschedules, the timer according to it's state.
+			void UpdateSchedule();
+			//Called by the wheel every time an interval elapses.
+			void CompleteCycle();
 		public:
 			/*
 				Constructor: SDLTimer
 
 				Parameters:
 					interval - The interval which should pass before an event is raised.
+
+					repeating - False if the event should only be raised once.
 			*/
-			SDLTimer(int interval);
+			SDLTimer(int interval, bool repeating = true);
 			/*
 				Function: GetCycleCompleteEventHandlers
 
@@ -82,18 +113,22 @@ namespace SDLInterfaceLibrary
 						- The time elapsed is currently 500.
 						- The new interval is 400.
 
-					An cycle completion event is fired.
+					An cycle completion event is fired on the next tick.
 			*/
 			void SetInterval(int interval);
 			/*
-				Function: Tick
+				Function: Start
 
-				Progresses the timer's internal clock.
+				Starts the timer from the beginning of a cycle. This is done automatically
+				by <SDLForm::AddTimer>.
+			*/
+			void Start();
+			/*
+				Function: Stop
 
-				Parameters:
-					fps - The current application's frame cap.
+				Stops the timer, and takes it off the timer wheel.
 			*/
-			void Tick(int fps);
+			void Stop();
 			/*
 				Function: Pause
 
@@ -106,6 +141,40 @@ namespace SDLInterfaceLibrary
 				Continues the timer's internal clock.
 			*/
 			void Continue();
+			/*
+				Function: SetSuspended
+
+				Suspends or resumes the timer's internal clock, independently of
+				<SDLTimer::Pause>. Used by forms as they lose and gain focus.
+			*/
+			void SetSuspended(bool suspended);
+			/*
+				Function: IsRunning
+
+				Returns:
+					True if the timer is started, and neither paused nor suspended.
+			*/
+			bool IsRunning() const;
+			/*
+				Function: GetForm
+
+				Returns:
+					The form which this timer was added to, or NULL.
+			*/
+			SDLForm* GetForm() const;
+			/*
+				Function: SetForm
+
+				Records the form which this timer belongs to. Called by <SDLForm::AddTimer>
+				and <SDLForm::RemoveTimer>, rather than directly.
+			*/
+			void SetForm(SDLForm* form);
+			/*
+				Destructor: SDLTimer
+
+				Takes the timer off the timer wheel, and removes it from it's form.
+			*/
+			~SDLTimer();
 	};
 }
 
@@ -0,0 +1,304 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLTimerWheel.h>
+
+using namespace SDLInterfaceLibrary;
+
+void SDLTimerWheel::InitializeSlot(Entry& slot)
+{
+	slot.previous = &slot;
+	slot.next = &slot;
+}
+
+void SDLTimerWheel::Link(Entry& slot, Entry* entry)
+{
+	entry->previous = slot.previous;
+	entry->next = &slot;
+
+	slot.previous->next = entry;
+	slot.previous = entry;
+}
+
+void SDLTimerWheel::Unlink(Entry* entry)
+{
+	entry->previous->next = entry->next;
+	entry->next->previous = entry->previous;
+
+	entry->previous = entry;
+	entry->next = entry;
+}
+
+void SDLTimerWheel::Delete(Entry* entry)
+{
+	delete entry->handler;
+	delete entry;
+}
+
+void SDLTimerWheel::Insert(Entry* entry)
+{
+	Uint64 delay = entry->expiryTime - currentTime;
+
+	if(delay < (Uint64)FIRST_LEVEL_SIZE)
+	{
+		Link(firstLevel[entry->expiryTime & (FIRST_LEVEL_SIZE - 1)], entry);
+		return;
+	}
+
+	for(int level = 0; level < NUMBER_OF_LEVELS - 1; level++)
+	{
+		int shift = FIRST_LEVEL_BITS + level * LEVEL_BITS;
+		bool lastLevel = (level == NUMBER_OF_LEVELS - 2);
+
+		if(delay < ((Uint64)1 << (shift + LEVEL_BITS)) || lastLevel)
+		{
+			Uint64 expiryTime = entry->expiryTime;
+
+			//Timers beyond the span of the wheel wait in the furthest slot, and are placed
+			//again every time it is cascaded.
+			if(delay >= ((Uint64)1 << (shift + LEVEL_BITS)))
+			{
+				expiryTime = currentTime + ((Uint64)1 << (shift + LEVEL_BITS)) - 1;
+			}
+
+			Link(upperLevels[level][(expiryTime >> shift) & (LEVEL_SIZE - 1)], entry);
+			return;
+		}
+	}
+}
+
+int SDLTimerWheel::Cascade(int level, int index)
+{
+	Entry& slot = upperLevels[level][index];
+
+	while(slot.next != &slot)
+	{
+		Entry* entry = slot.next;
+
+		Unlink(entry);
+		Insert(entry);
+	}
+
+	return index;
+}
+
+void SDLTimerWheel::Tick()
+{
+	currentTime++;
+
+	int index = (int)(currentTime & (FIRST_LEVEL_SIZE - 1));
+
+	//Every time the first level wraps around, the next slot of the level above is spread
+	//over it, and so on up the levels.
+	if(index == 0)
+	{
+		for(int level = 0; level < NUMBER_OF_LEVELS - 1; level++)
+		{
+			int shift = FIRST_LEVEL_BITS + level * LEVEL_BITS;
+
+			if(Cascade(level, (int)((currentTime >> shift) & (LEVEL_SIZE - 1))) != 0)
+			{
+				break;
+			}
+		}
+	}
+
+	//The slot is moved to a list of it's own first, since handlers may schedule timers
+	//which land on it again. It is appended to any entries which were left over by a
+	//handler breaking out of the last tick, with an exception or a lua error.
+	Entry& slot = firstLevel[index];
+
+	if(slot.next != &slot)
+	{
+		slot.next->previous = expiredEntries.previous;
+		expiredEntries.previous->next = slot.next;
+
+		slot.previous->next = &expiredEntries;
+		expiredEntries.previous = slot.previous;
+
+		InitializeSlot(slot);
+	}
+
+	while(expiredEntries.next != &expiredEntries)
+	{
+		Entry* entry = expiredEntries.next;
+		Unlink(entry);
+
+		if(entry->interval > 0)
+		{
+			entry->expiryTime += entry->interval;
+			Insert(entry);
+		}
+		else
+		{
+			entries.erase(entry->handle);
+		}
+
+		firingEntry = entry;
+		firingEntryCancelled = false;
+
+		try
+		{
+			entry->handler->RaiseEvent();
+		}
+		catch(...)
+		{
+			FinishFiring();
+			throw;
+		}
+
+		FinishFiring();
+	}
+}
+
+void SDLTimerWheel::FinishFiring()
+{
+	Entry* entry = firingEntry;
+	firingEntry = NULL;
+
+	if(entry->interval == 0 || firingEntryCancelled)
+	{
+		Delete(entry);
+	}
+}
+
+SDLTimerWheel::SDLTimerWheel()
+{
+	for(int index = 0; index < FIRST_LEVEL_SIZE; index++)
+	{
+		InitializeSlot(firstLevel[index]);
+	}
+
+	for(int level = 0; level < NUMBER_OF_LEVELS - 1; level++)
+	{
+		for(int index = 0; index < LEVEL_SIZE; index++)
+		{
+			InitializeSlot(upperLevels[level][index]);
+		}
+	}
+
+	InitializeSlot(expiredEntries);
+
+	currentTime = 0;
+	lastHandle = 0;
+
+	firingEntry = NULL;
+	firingEntryCancelled = false;
+}
+
+SDLTimerHandle SDLTimerWheel::Schedule(int delay, int interval, IGenericEventHandler* handler)
+{
+	Entry* entry = new Entry();
+
+	//Handles are only reused once every other value has been handed out.
+	do
+	{
+		lastHandle++;
+	}
+	while(lastHandle == 0 || entries.find(lastHandle) != entries.end());
+
+	entry->handle = lastHandle;
+	entry->expiryTime = currentTime + ((delay < 1)? 1: delay);
+	entry->interval = (interval < 0)? 0: interval;
+	entry->handler = handler;
+
+	entries[entry->handle] = entry;
+	Insert(entry);
+
+	return entry->handle;
+}
+
+bool SDLTimerWheel::Cancel(SDLTimerHandle handle)
+{
+	map<SDLTimerHandle, Entry*>::iterator entry = entries.find(handle);
+
+	if(entry == entries.end())
+	{
+		return false;
+	}
+
+	Entry* entryToCancel = entry->second;
+
+	entries.erase(entry);
+	Unlink(entryToCancel);
+
+	if(entryToCancel == firingEntry)
+	{
+		firingEntryCancelled = true;
+	}
+	else
+	{
+		Delete(entryToCancel);
+	}
+
+	return true;
+}
+
+void SDLTimerWheel::CancelAll()
+{
+	while(!entries.empty())
+	{
+		Cancel(entries.begin()->first);
+	}
+}
+
+bool SDLTimerWheel::IsScheduled(SDLTimerHandle handle) const
+{
+	return entries.find(handle) != entries.end();
+}
+
+int SDLTimerWheel::GetTimeUntil(SDLTimerHandle handle) const
+{
+	map<SDLTimerHandle, Entry*>::const_iterator entry = entries.find(handle);
+
+	if(entry == entries.end())
+	{
+		return -1;
+	}
+
+	return (int)(entry->second->expiryTime - currentTime);
+}
+
+int SDLTimerWheel::GetNumberOfTimers() const
+{
+	return entries.size();
+}
+
+void SDLTimerWheel::Advance(int numberOfTicks)
+{
+	for(int tick = 0; tick < numberOfTicks; tick++)
+	{
+		Tick();
+	}
+}
+
+SDLTimerWheel::~SDLTimerWheel()
+{
+	for(map<SDLTimerHandle, Entry*>::iterator entry = entries.begin();
+		entry != entries.end();
+		entry++)
+	{
+		Delete(entry->second);
+	}
+}
@@ -0,0 +1,208 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_TIMER_WHEEL_H
+#define SDL_TIMER_WHEEL_H
+
+#include <map>
+
+#include <SDL/SDL.h>
+
+#include <EventHandling/GenericEventHandler.h>
+#include <Helpers/IUncopyable.h>
+
+using std::map;
+using namespace EventHandling;
+using namespace Helpers;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Type: SDLTimerHandle
+
+		Identifies a timer scheduled on an <SDLTimerWheel>. 0 is never used as a handle, so it
+		can stand for no timer at all.
+	*/
+	typedef unsigned int SDLTimerHandle;
+
+	/*
+		Class: SDLTimerWheel
+
+		Schedules one-shot and repeating events, measured in ticks of the simulation clock.
+
+		Timers are kept in a hierarchical timing wheel: the first level has a slot for each of
+		the next 256 ticks, and each of the three levels above it has 64 slots which each
+		cover 64 times the span of a slot on the level below. Scheduling and cancelling take
+		constant time, and a tick only visits the timers which expire on it, bar the occasional
+		move of a slot's timers down to the level below. Timers due further ahead than the
+		wheel spans (Roughly 18 hours, at 1 millisecond per tick) are kept on the top level
+		until they are in range.
+
+		If several ticks pass in one call to <SDLTimerWheel::Advance>, a repeating timer
+		fires once for every interval which completed, in order.
+
+		See Also:
+			<SDLInstance::GetTimerWheel>
+	*/
+	class SDLTimerWheel: public IUncopyable
+	{
+		private:
+			//A scheduled timer. Every entry sits in a circular, doubly linked list, headed by
+			//the slot it waits in, so that it can be unlinked without a search.
+			struct Entry
+			{
+				Entry* previous;
+				Entry* next;
+
+				SDLTimerHandle handle;
+				Uint64 expiryTime;
+				//0 for one-shot timers.
+				int interval;
+
+				IGenericEventHandler* handler;
+			};
+
+			static const int FIRST_LEVEL_BITS = 8;
+			static const int LEVEL_BITS = 6;
+			static const int NUMBER_OF_LEVELS = 4;
+
+			static const int FIRST_LEVEL_SIZE = 1 << FIRST_LEVEL_BITS;
+			static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+
+			Entry firstLevel[FIRST_LEVEL_SIZE];
+			Entry upperLevels[NUMBER_OF_LEVELS - 1][LEVEL_SIZE];
+
+			//The number of ticks which have passed.
+			Uint64 currentTime;
+
+			map<SDLTimerHandle, Entry*> entries;
+			SDLTimerHandle lastHandle;
+
+			//The entries which expire on the current tick, and are yet to fire. Should a
+			//handler break out of the tick, those left over fire on the next one.
+			Entry expiredEntries;
+
+			//The entry whose handler is being raised, and whether it was cancelled meanwhile,
+			//in which case it is only deleted once the handler returns.
+			Entry* firingEntry;
+			bool firingEntryCancelled;
+
+			static void InitializeSlot(Entry& slot);
+			static void Link(Entry& slot, Entry* entry);
+			static void Unlink(Entry* entry);
+
+			//Places [entry] in the slot which matches it's expiry time.
+			void Insert(Entry* entry);
+			//Moves the entries in slot [index] of upper level [level] to the levels below.
+			//Returns [index].
+			int Cascade(int level, int index);
+			//Processes a single tick.
+			void Tick();
+			//Deletes the firing entry once its handler is done, unless it repeats and was
+			//not cancelled.
+			void FinishFiring();
+			//Frees [entry] and it's handler.
+			static void Delete(Entry* entry);
+		public:
+			/*
+				Constructor: SDLTimerWheel
+			*/
+			SDLTimerWheel();
+			/*
+				Function: Schedule
+
+				Parameters:
+					delay - The number of ticks after which the timer first fires. Values less
+							than 1 make it fire on the next tick.
+
+					interval - The number of ticks between subsequent firings, or 0 for a
+							   one-shot timer.
+
+					handler - The handler which is raised when the timer fires. The wheel takes
+							  ownership of it, and frees it once the timer is done or cancelled.
+
+				Returns:
+					A handle which can be used to cancel the timer.
+			*/
+			SDLTimerHandle Schedule(int delay, int interval, IGenericEventHandler* handler);
+			/*
+				Function: Cancel
+
+				Cancels timer [handle]. A timer may cancel itself, or any other timer, from it's
+				handler.
+
+				Returns:
+					False if [handle] does not refer to a scheduled timer, for instance because
+					it was a one-shot timer which has already fired.
+			*/
+			bool Cancel(SDLTimerHandle handle);
+			/*
+				Function: CancelAll
+
+				Cancels every timer, freeing their handlers. Handlers which refer to a lua state
+				must be freed this way before it is closed.
+			*/
+			void CancelAll();
+			/*
+				Function: IsScheduled
+
+				Returns:
+					True if timer [handle] is still scheduled.
+			*/
+			bool IsScheduled(SDLTimerHandle handle) const;
+			/*
+				Function: GetTimeUntil
+
+				Returns:
+					The number of ticks until timer [handle] next fires, or -1 if it is not
+					scheduled.
+			*/
+			int GetTimeUntil(SDLTimerHandle handle) const;
+			/*
+				Function: GetNumberOfTimers
+
+				Returns:
+					The number of timers which are scheduled.
+			*/
+			int GetNumberOfTimers() const;
+			/*
+				Function: Advance
+
+				Moves the wheel forward by [numberOfTicks], raising the handlers of the timers
+				which expire on the way.
+
+				Should a handler throw, the exception is passed on, and the timers which were
+				still to fire on that tick fire on the next one instead.
+			*/
+			void Advance(int numberOfTicks);
+			/*
+				Destructor: SDLTimerWheel
+
+				Frees every timer which is still scheduled.
+			*/
+			~SDLTimerWheel();
+	};
+}
+
+#endif
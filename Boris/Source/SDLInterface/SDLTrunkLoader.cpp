@@ -0,0 +1,179 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/SDLTrunkLoader.h>
+
+#include <exception>
+
+using namespace std;
+using namespace SDLInterfaceLibrary;
+
+SDLTrunkLoader::SDLTrunkLoader(ISDLResourceTrunk* trunk, const string& trunkName)
+{
+	this->trunk = trunk;
+	this->trunkName = trunkName;
+
+	finished = false;
+	cancelled = false;
+	decodePool = NULL;
+
+	thread = SDL_CreateThread(RunThread, this);
+
+	if(thread == NULL)
+	{
+		throw SDLException();
+	}
+}
+
+int SDLTrunkLoader::RunThread(void* loader)
+{
+	((SDLTrunkLoader*)loader)->LoadTrunk();
+
+	return 0;
+}
+
+void SDLTrunkLoader::LoadTrunk()
+{
+	string loadError;
+
+	try
+	{
+		trunk->LoadResources();
+
+		SDLDecodePool trunkDecodePool(*trunk, trunk->GetResourceList());
+
+		{
+			SDLMutexLock queueHeld(queueLock);
+
+			if(cancelled)
+			{
+				trunkDecodePool.Cancel();
+			}
+
+			decodePool = &trunkDecodePool;
+		}
+
+		try
+		{
+			trunkDecodePool.Run(0);
+		}
+		catch(exception&)
+		{
+			SDLMutexLock queueHeld(queueLock);
+			decodePool = NULL;
+
+			throw;
+		}
+
+		SDLMutexLock queueHeld(queueLock);
+
+		decodePool = NULL;
+		trunkDecodePool.TakeDecodedResources(decodedResources);
+	}
+	catch(exception& loadException)
+	{
+		loadError = "Error while loading trunk " + trunkName + ": " + loadException.what();
+	}
+
+	SDLMutexLock queueHeld(queueLock);
+
+	error = loadError;
+	finished = true;
+}
+
+bool SDLTrunkLoader::AddDecodedResources()
+{
+	vector<DecodedResource> resourcesToAdd;
+	bool loadFinished = false;
+
+	{
+		SDLMutexLock queueHeld(queueLock);
+
+		resourcesToAdd.swap(decodedResources);
+		loadFinished = finished;
+	}
+
+	for(vector<DecodedResource>::iterator currentResource = resourcesToAdd.begin();
+		currentResource != resourcesToAdd.end();
+		currentResource++)
+	{
+		trunk->AddResource(*currentResource);
+	}
+
+	if(!loadFinished)
+	{
+		return false;
+	}
+
+	if(thread != NULL)
+	{
+		SDL_WaitThread(thread, NULL);
+		thread = NULL;
+	}
+
+	//The thread is done with error, so it can be read without the lock.
+	if(!error.empty())
+	{
+		throw ResourceException(error.c_str());
+	}
+
+	return true;
+}
+
+void SDLTrunkLoader::Wait()
+{
+	if(thread != NULL)
+	{
+		SDL_WaitThread(thread, NULL);
+		thread = NULL;
+	}
+
+	AddDecodedResources();
+}
+
+SDLTrunkLoader::~SDLTrunkLoader()
+{
+	if(thread != NULL)
+	{
+		queueLock.Lock();
+
+		cancelled = true;
+
+		if(decodePool != NULL)
+		{
+			decodePool->Cancel();
+		}
+
+		queueLock.Unlock();
+
+		SDL_WaitThread(thread, NULL);
+	}
+
+	for(vector<DecodedResource>::iterator currentResource = decodedResources.begin();
+		currentResource != decodedResources.end();
+		currentResource++)
+	{
+		trunk->AddResource(*currentResource);
+	}
+}
@@ -0,0 +1,138 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef SDL_TRUNK_LOADER_H
+#define SDL_TRUNK_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_thread.h>
+
+#include <SDLInterface/ResourceException.h>
+#include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/SDLDecodePool.h>
+#include <SDLInterface/SDLMutex.h>
+#include <Helpers/IUncopyable.h>
+
+using namespace std;
+
+/*
+	File: SDLTrunkLoader.h
+	Contains the declaration of SDLTrunkLoader.
+*/
+namespace SDLInterfaceLibrary
+{
+	/*
+		Class: SDLTrunkLoader
+
+		Loads a trunk, and decodes all of its resources, on a thread of its own, which shares
+		the decoding with the threads of an <SDLDecodePool>. The resources are queued once they
+		have all been decoded, and are handed to the trunk by the main thread through
+		<SDLTrunkLoader::AddDecodedResources>, so that the trunk itself is only ever changed by
+		the main thread. Images are converted to the format of the screen by the
+		main thread too, when they are first requested.
+
+		See Also:
+			<SDLResourcePipeline::LoadResourceTrunkAsync>
+	*/
+	class SDLTrunkLoader: public IUncopyable
+	{
+		private:
+			//The trunk which is loaded. It is not owned by the loader.
+			ISDLResourceTrunk* trunk;
+			string trunkName;
+
+			SDL_Thread* thread;
+
+			//Held while the members below are used, since they are shared with the thread.
+			SDLMutex queueLock;
+			//The resources which have been decoded, but not handed to the trunk yet.
+			vector<DecodedResource> decodedResources;
+			//True once the thread has nothing left to do.
+			bool finished;
+			//True if the thread should stop before it has decoded everything.
+			bool cancelled;
+			//The pool which is decoding the resources, if the thread has got that far.
+			SDLDecodePool* decodePool;
+			//The error which stopped the thread, if one did.
+			string error;
+
+			//The function which the thread runs, [loader] being the SDLTrunkLoader.
+			static int RunThread(void* loader);
+			//Loads the trunk and decodes its resources, on the thread.
+			void LoadTrunk();
+
+		public:
+			/*
+				Constructor: SDLTrunkLoader
+
+				Starts loading [trunk], whose resources must not have been loaded yet. The trunk
+				must not be used until the loader is done with it; that is, until
+				<SDLTrunkLoader::AddDecodedResources> returns true, <SDLTrunkLoader::Wait> returns,
+				or the loader is deleted.
+
+				Parameters:
+					trunk - The trunk which will be loaded.
+					trunkName - The name of the trunk, used in error messages.
+
+				Throws:
+					SDLException - If the thread could not be created.
+			*/
+			SDLTrunkLoader(ISDLResourceTrunk* trunk, const string& trunkName);
+			/*
+				Function: AddDecodedResources
+
+				Hands the resources which have been decoded since it was last called to the trunk.
+				It must be called on the main thread.
+
+				Returns:
+					True if the trunk has been loaded completely.
+
+				Throws:
+					ResourceException - If the trunk could not be loaded.
+			*/
+			bool AddDecodedResources();
+			/*
+				Function: Wait
+
+				Waits for the trunk to be loaded completely, and hands the remaining resources to
+				it. It must be called on the main thread.
+
+				Throws:
+					ResourceException - If the trunk could not be loaded.
+			*/
+			void Wait();
+			/*
+				Destructor: ~SDLTrunkLoader
+
+				Stops the threads after the resources they are decoding, and hands the resources
+				which were decoded to the trunk so that they are freed with it.
+			*/
+			~SDLTrunkLoader();
+	};
+}
+
+#endif
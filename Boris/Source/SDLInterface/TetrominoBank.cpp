@@ -0,0 +1,174 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#include <SDLInterface/TetrominoBank.h>
+
+using namespace std;
+using namespace SDLInterfaceLibrary;
+using namespace Helpers;
+
+TetrominoBank::TetrominoBank()
+{
+	int numberOfShapes = sizeof(BuiltInTetrominoShapes)/sizeof(BuiltInTetrominoShapes[0]);
+
+	for(int shapeIndex = 0; shapeIndex < numberOfShapes; shapeIndex++)
+	{
+		const TetrominoShape& shape = BuiltInTetrominoShapes[shapeIndex];
+
+		vector< Grid<unsigned int> > placementMaps;
+		vector< Vector2D<int> > anchorBlockPositions;
+
+		for(int frameIndex = 0; frameIndex < shape.numberOfFrames; frameIndex++)
+		{
+			const TetrominoFrame& frame = shape.frames[frameIndex];
+			Grid<unsigned int> placementMap(frame.width, frame.height, 0);
+
+			for(int y = 0; y < frame.height; y++)
+			{
+				for(int x = 0; x < frame.width; x++)
+				{
+					placementMap(x, y) = (frame.rowMasks[y] >> x) & 1;
+				}
+			}
+
+			placementMaps.push_back(placementMap);
+			anchorBlockPositions.push_back(Vector2D<int>(frame.anchorX, frame.anchorY));
+		}
+
+		Define(shape.name, placementMaps, anchorBlockPositions, shape.clearingMethod);
+	}
+}
+
+TetrominoBank& TetrominoBank::GetInstance()
+{
+	static TetrominoBank instance;
+	return instance;
+}
+
+TetrominoBank::TetrominoDefinition& TetrominoBank::ConfirmTetromino(const string& name)
+{
+	map<string, TetrominoDefinition>::iterator tetromino = tetrominoes.find(name);
+
+	if(tetromino == tetrominoes.end())
+	{
+		stringstream exceptionString;
+		exceptionString << "Tetromino " << name << " has not been defined";
+
+		throw SDLInterfaceLibraryException(exceptionString.str().c_str());
+	}
+
+	return tetromino->second;
+}
+
+const TetrominoBank::TetrominoDefinition& TetrominoBank::ConfirmTetromino(const string& name) const
+{
+	return const_cast<TetrominoBank*>(this)->ConfirmTetromino(name);
+}
+
+void TetrominoBank::Define(const string& name, const vector< Grid<unsigned int> >& placementMaps,
+	const vector< Vector2D<int> >& anchorBlockPositions, SDLClearingMethod clearingMethod)
+{
+	if(placementMaps.size() == 0 || placementMaps.size() != anchorBlockPositions.size())
+	{
+		stringstream exceptionString;
+
+		exceptionString << "Error when defining tetromino " << name << ": ";
+		exceptionString << "expected at least one rotation, and exactly one anchor per rotation";
+
+		throw SDLInterfaceLibraryException(exceptionString.str().c_str());
+	}
+
+	TetrominoDefinition definition;
+
+	definition.clearingMethod = clearingMethod;
+	definition.placementMaps = placementMaps;
+	definition.anchorBlockPositions = anchorBlockPositions;
+	definition.blockSurface = NULL;
+
+	tetrominoes[name] = definition;
+}
+
+bool TetrominoBank::IsDefined(const string& name) const
+{
+	return tetrominoes.find(name) != tetrominoes.end();
+}
+
+SDLClearingMethod TetrominoBank::GetClearingMethod(const string& name) const
+{
+	return ConfirmTetromino(name).clearingMethod;
+}
+
+const vector<SharedSDLSurfaceGrid>& TetrominoBank::GetSurfaceGrids(const string& name, SDL_Surface* blockSurface)
+{
+	TetrominoDefinition& tetromino = ConfirmTetromino(name);
+
+	if(tetromino.blockSurface == blockSurface)
+	{
+		return tetromino.surfaceGrids;
+	}
+
+	if(tetromino.surfaceGrids.size() == 0)
+	{
+		vector<SDL_Surface*> surfaceList(1, blockSurface);
+
+		for(unsigned int frameIndex = 0; frameIndex < tetromino.placementMaps.size(); frameIndex++)
+		{
+			stringstream frameName;
+			frameName << name << "Tetra";
+
+			if(frameIndex > 0)
+			{
+				frameName << frameIndex;
+			}
+
+			tetromino.surfaceGrids.push_back(make_shared<SDLSurfaceGrid>(frameName.str(),
+				tetromino.placementMaps[frameIndex], surfaceList,
+				tetromino.anchorBlockPositions[frameIndex], SDL_SSP_UPPER_LEFT_CORNER));
+		}
+	}
+	else
+	{
+		//Refill the existing grids in place, so that every component sharing them
+		//picks up the new surface.
+		for(unsigned int frameIndex = 0; frameIndex < tetromino.placementMaps.size(); frameIndex++)
+		{
+			const Grid<unsigned int>& placementMap = tetromino.placementMaps[frameIndex];
+
+			for(int y = 0; y < placementMap.GetHeight(); y++)
+			{
+				for(int x = 0; x < placementMap.GetWidth(); x++)
+				{
+					if(placementMap(x, y) != 0)
+					{
+						tetromino.surfaceGrids[frameIndex]->Replace(blockSurface, Vector2D<int>(x, y));
+					}
+				}
+			}
+		}
+	}
+
+	tetromino.blockSurface = blockSurface;
+
+	return tetromino.surfaceGrids;
+}
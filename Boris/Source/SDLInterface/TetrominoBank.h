@@ -0,0 +1,236 @@
+/*
+	BORIS - Copyright (c) 2010 Robert Vella - robert.r.h.vella@gmail.com
+
+	This software is provided 'as-is', without any express or
+	implied warranty. In no event will the authors be held
+	liable for any damages arising from the use of this software.
+
+	Permission is granted to anyone to use this software for any purpose,
+	including commercial applications, and to alter it and redistribute
+	it freely, subject to the following restrictions:
+
+	1. The origin of this software must not be misrepresented;
+	   you must not claim that you wrote the original software.
+	   If you use this software in a product, an acknowledgment
+	   in the product documentation would be appreciated but
+	   is not required.
+
+	2. Altered source versions must be plainly marked as such,
+	   and must not be misrepresented as being the original software.
+
+	3. This notice may not be removed or altered from any
+	   source distribution.
+*/
+
+#ifndef TETROMINO_BANK_H
+#define TETROMINO_BANK_H
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <SDL/SDL.h>
+
+#include <Helpers/Grid.h>
+#include <Helpers/IUncopyable.h>
+#include <SDLInterface/SDLInterfaceLibraryException.h>
+#include <SDLInterface/SDLSurfaceGrid.h>
+#include <SDLInterface/SDLSurfaceGridComponent.h>
+
+using namespace std;
+using namespace Helpers;
+
+namespace SDLInterfaceLibrary
+{
+	/*
+		Function: TetrominoRowMask
+
+		Parameters:
+			row - A row of a shape, written as a string in which '#' is a filled cell and
+				  any other character is an empty one. For example "#.." or "###".
+
+		Returns:
+			The bitmask of [row], in which bit x is set when column x is filled.
+	*/
+	constexpr Uint8 TetrominoRowMask(const char* row, int column = 0)
+	{
+		return (*row == '\0')? 0:
+			(Uint8)(((*row == '#')? (1 << column): 0) | TetrominoRowMask(row + 1, column + 1));
+	}
+	/*
+		Struct: TetrominoFrame
+
+		A single rotation of a built-in tetromino.
+	*/
+	struct TetrominoFrame
+	{
+		//Bit x of rowMasks[y] is set when the cell (x, y) is filled.
+		Uint8 rowMasks[4];
+
+		int width;
+		int height;
+
+		//The cell which holds the anchor of this frame. The anchor is always the
+		//upper left corner of that cell.
+		int anchorX;
+		int anchorY;
+	};
+	/*
+		Struct: TetrominoShape
+
+		A built-in tetromino, with all of it's rotations.
+	*/
+	struct TetrominoShape
+	{
+		const char* name;
+		SDLClearingMethod clearingMethod;
+
+		int numberOfFrames;
+		TetrominoFrame frames[4];
+	};
+	/*
+		Constant: BuiltInTetrominoShapes
+
+		The seven standard tetrominoes. The rotations are listed in the order they are
+		cycled through by <SDLSurfaceGridComponent::Next>.
+	*/
+	constexpr TetrominoShape BuiltInTetrominoShapes[] =
+	{
+		{"L", SDL_CM_PRECISE, 4,
+		{
+			{{TetrominoRowMask("###"), TetrominoRowMask("#..")}, 3, 2, 1, 0},
+			{{TetrominoRowMask("##"), TetrominoRowMask(".#"), TetrominoRowMask(".#")}, 2, 3, 1, 1},
+			{{TetrominoRowMask("..#"), TetrominoRowMask("###")}, 3, 2, 1, 1},
+			{{TetrominoRowMask("#."), TetrominoRowMask("#."), TetrominoRowMask("##")}, 2, 3, 0, 1}
+		}},
+		{"T", SDL_CM_PRECISE, 4,
+		{
+			{{TetrominoRowMask("###"), TetrominoRowMask(".#.")}, 3, 2, 1, 0},
+			{{TetrominoRowMask(".#"), TetrominoRowMask("##"), TetrominoRowMask(".#")}, 2, 3, 1, 1},
+			{{TetrominoRowMask(".#."), TetrominoRowMask("###")}, 3, 2, 1, 1},
+			{{TetrominoRowMask("#."), TetrominoRowMask("##"), TetrominoRowMask("#.")}, 2, 3, 0, 1}
+		}},
+		{"J", SDL_CM_PRECISE, 4,
+		{
+			{{TetrominoRowMask("###"), TetrominoRowMask("..#")}, 3, 2, 1, 0},
+			{{TetrominoRowMask(".#"), TetrominoRowMask(".#"), TetrominoRowMask("##")}, 2, 3, 1, 1},
+			{{TetrominoRowMask("#.."), TetrominoRowMask("###")}, 3, 2, 1, 1},
+			{{TetrominoRowMask("##"), TetrominoRowMask("#."), TetrominoRowMask("#.")}, 2, 3, 0, 1}
+		}},
+		{"S", SDL_CM_PRECISE, 2,
+		{
+			{{TetrominoRowMask(".##"), TetrominoRowMask("##.")}, 3, 2, 1, 0},
+			{{TetrominoRowMask("#."), TetrominoRowMask("##"), TetrominoRowMask(".#")}, 2, 3, 0, 1}
+		}},
+		{"Z", SDL_CM_PRECISE, 2,
+		{
+			{{TetrominoRowMask("##."), TetrominoRowMask(".##")}, 3, 2, 1, 0},
+			{{TetrominoRowMask(".#"), TetrominoRowMask("##"), TetrominoRowMask("#.")}, 2, 3, 1, 1}
+		}},
+		{"O", SDL_CM_BOUNDING_BOX, 1,
+		{
+			{{TetrominoRowMask("##"), TetrominoRowMask("##")}, 2, 2, 1, 0}
+		}},
+		{"I", SDL_CM_BOUNDING_BOX, 2,
+		{
+			{{TetrominoRowMask("####")}, 4, 1, 2, 0},
+			{{TetrominoRowMask("#"), TetrominoRowMask("#"), TetrominoRowMask("#"), TetrominoRowMask("#")}, 1, 4, 0, 2}
+		}}
+	};
+	/*
+		Class: TetrominoBank
+
+		Holds the definition of every tetromino available to the game, and the surface
+		grids built from them. The built-in shapes (See <BuiltInTetrominoShapes>) are
+		defined when the bank is first used; further shapes can be added through
+		<TetrominoBank::Define>.
+
+		The surface grids of each shape are built once, the first time they are requested,
+		and are afterwards shared by everyone who asks for them. When they are requested
+		with a different block surface (For instance because the trunk holding the previous
+		one was unloaded and loaded again) the existing grids are refilled with the new
+		surface rather than rebuilt, so that components already sharing them remain valid.
+	*/
+	class TetrominoBank: public IUncopyable
+	{
+		private:
+			struct TetrominoDefinition
+			{
+				SDLClearingMethod clearingMethod;
+
+				//One placement map, and anchor cell, per rotation. See SDLSurfaceGrid's constructor.
+				vector< Grid<unsigned int> > placementMaps;
+				vector< Vector2D<int> > anchorBlockPositions;
+
+				//The surface the grids were last filled with, NULL if they haven't been built yet.
+				SDL_Surface* blockSurface;
+				vector<SharedSDLSurfaceGrid> surfaceGrids;
+			};
+
+			map<string, TetrominoDefinition> tetrominoes;
+
+			//Asserts that tetromino [name] has been defined, and returns it's definition.
+			TetrominoDefinition& ConfirmTetromino(const string& name);
+			const TetrominoDefinition& ConfirmTetromino(const string& name) const;
+
+			//Private initializor for this class.
+			TetrominoBank();
+		public:
+			/*
+				Function: GetInstance
+
+				Returns the single instance of this class.
+			*/
+			static TetrominoBank& GetInstance();
+			/*
+				Function: Define
+
+				Adds the tetromino [name] to the bank, replacing any previous definition with that
+				name. The placement maps are only kept as data here; surface grids are built from
+				them when first requested.
+
+				Parameters:
+					name - The name of the tetromino.
+
+					placementMaps - One map per rotation, in which a cell holds 1 if it is filled
+									and 0 otherwise.
+
+					anchorBlockPositions - The anchor cell of each rotation.
+
+					clearingMethod - The method which will be used to clear the tetromino from
+									 the screen.
+			*/
+			void Define(const string& name, const vector< Grid<unsigned int> >& placementMaps,
+				const vector< Vector2D<int> >& anchorBlockPositions, SDLClearingMethod clearingMethod);
+			/*
+				Function: IsDefined
+
+				Returns:
+					True if a tetromino named [name] has been defined.
+			*/
+			bool IsDefined(const string& name) const;
+			/*
+				Function: GetClearingMethod
+
+				Returns:
+					The clearing method of tetromino [name].
+			*/
+			SDLClearingMethod GetClearingMethod(const string& name) const;
+			/*
+				Function: GetSurfaceGrids
+
+				Parameters:
+					name - The name of the tetromino.
+
+					blockSurface - The surface used for every filled cell of the tetromino.
+
+				Returns:
+					The rotations of tetromino [name], as surface grids filled with [blockSurface].
+					These are shared, see the class description.
+			*/
+			const vector<SharedSDLSurfaceGrid>& GetSurfaceGrids(const string& name, SDL_Surface* blockSurface);
+	};
+}
+
+#endif
@@ -0,0 +1,240 @@
+#include <SDLInterface/SDLInstance.h>
+#include <SDLInterface/SDLSimulationClock.h>
+#include <SDLInterface/SDLTimer.h>
+#include <SDLInterface/SDLTimerWheel.h>
+#include <Helpers/ApplicationException.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::setw;
+using std::string;
+using std::vector;
+
+using namespace SDLInterfaceLibrary;
+
+//The step and frame lengths SDLInstance advances its timers with, in microseconds.
+const int STEP_LENGTH = 1000;
+const int MAXIMUM_FRAME_LENGTH = 250000;
+
+//The timer under test, which fires every TIMER_INTERVAL milli-seconds.
+const int TIMER_INTERVAL = 500;
+//How long, in microseconds, each run of the timer lasts.
+const int RUN_LENGTH = 60000000;
+
+/*
+	Class: FiringCounter
+
+	Counts the cycles completed by the timer under test.
+*/
+class FiringCounter
+{
+	public:
+		int numberOfFirings;
+
+		FiringCounter(): numberOfFirings(0) {}
+
+		void Fire()
+		{
+			numberOfFirings++;
+		}
+};
+
+/*
+Function: GetFrameLengths
+
+Returns:
+	The lengths of the frames between [timestamps], which are read from a fake time source
+	in microseconds.
+*/
+vector<int> GetFrameLengths(const vector<int>& timestamps)
+{
+	vector<int> frameLengths;
+
+	for(size_t i = 1; i < timestamps.size(); i++)
+	{
+		frameLengths.push_back(timestamps[i] - timestamps[i - 1]);
+	}
+
+	return frameLengths;
+}
+
+/*
+Function: GetEvenTimestamps
+
+Returns:
+	[numberOfFrames] + 1 timestamps spread evenly over RUN_LENGTH, rounded down to whole
+	microseconds, so that the frames are a microsecond apart in length when RUN_LENGTH does
+	not divide evenly.
+*/
+vector<int> GetEvenTimestamps(int numberOfFrames)
+{
+	vector<int> timestamps;
+
+	for(int i = 0; i <= numberOfFrames; i++)
+	{
+		timestamps.push_back((int)((long long)RUN_LENGTH * i / numberOfFrames));
+	}
+
+	return timestamps;
+}
+
+/*
+Function: GetUnevenTimestamps
+
+Returns:
+	Timestamps over RUN_LENGTH whose frames are of random lengths between 1 microsecond and
+	[longestFrame] microseconds.
+*/
+vector<int> GetUnevenTimestamps(int longestFrame)
+{
+	vector<int> timestamps(1, 0);
+
+	srand(0);
+
+	while(timestamps.back() < RUN_LENGTH)
+	{
+		int frameLength = 1 + (int)(((long long)rand() * rand()) % longestFrame);
+
+		timestamps.push_back(std::min(timestamps.back() + frameLength, RUN_LENGTH));
+	}
+
+	return timestamps;
+}
+
+/*
+Function: GetStalledTimestamps
+
+Returns:
+	Timestamps over RUN_LENGTH of 60 frames a second, broken every few seconds by a stall
+	longer than MAXIMUM_FRAME_LENGTH.
+*/
+vector<int> GetStalledTimestamps()
+{
+	vector<int> timestamps(1, 0);
+
+	for(int frame = 1; timestamps.back() < RUN_LENGTH; frame++)
+	{
+		int frameLength = (frame % 400 == 0)? 1300000: 16667;
+
+		timestamps.push_back(std::min(timestamps.back() + frameLength, RUN_LENGTH));
+	}
+
+	return timestamps;
+}
+
+/*
+Function: CountFirings
+
+Runs a repeating timer of TIMER_INTERVAL milli-seconds through [frameLengths], advancing the
+timer wheel of the SDLInstance by the steps an SDLSimulationClock counts in each frame, as
+<SDLInstance::Run> does.
+
+Returns:
+	The number of times the timer fired.
+*/
+int CountFirings(const vector<int>& frameLengths)
+{
+	SDLSimulationClock simulationClock(STEP_LENGTH, MAXIMUM_FRAME_LENGTH);
+	SDLTimerWheel& timerWheel = SDLInstance::GetInstance().GetTimerWheel();
+
+	FiringCounter firingCounter;
+	SDLTimer timer(TIMER_INTERVAL, true);
+
+	timer.GetCycleCompleteEventHandlers().AddCppEventHandler(&firingCounter, &FiringCounter::Fire);
+	timer.Start();
+
+	for(size_t i = 0; i < frameLengths.size(); i++)
+	{
+		timerWheel.Advance(simulationClock.Advance(frameLengths[i]));
+	}
+
+	return firingCounter.numberOfFirings;
+}
+
+/*
+Function: GetUnclampedTime
+
+Returns:
+	The time, in microseconds, which is left of [frameLengths] once each frame is clamped to
+	MAXIMUM_FRAME_LENGTH.
+*/
+long long GetUnclampedTime(const vector<int>& frameLengths)
+{
+	long long unclampedTime = 0;
+
+	for(size_t i = 0; i < frameLengths.size(); i++)
+	{
+		unclampedTime += std::min(frameLengths[i], MAXIMUM_FRAME_LENGTH);
+	}
+
+	return unclampedTime;
+}
+
+/*
+Function: Check
+
+Runs the timer through the frames between [timestamps], and writes whether it fired
+[expectedFirings] times.
+
+Returns:
+	True if it did.
+*/
+bool Check(const string& description, const vector<int>& timestamps, int expectedFirings)
+{
+	vector<int> frameLengths = GetFrameLengths(timestamps);
+	int firings = CountFirings(frameLengths);
+
+	cout << std::left << setw(32) << description << std::right << setw(8) << frameLengths.size();
+	cout << setw(10) << firings << setw(10) << expectedFirings;
+	cout << ((firings == expectedFirings)? "    passed": "    FAILED") << endl;
+
+	return firings == expectedFirings;
+}
+
+/*
+Runs a 500 milli-second timer for a minute of fake time, under even, uneven and clamped frames,
+and checks that it fires 120 times. Stalls beyond the clamp may only lose the time which was
+clamped away.
+*/
+int main()
+{
+	int error = 0;
+
+	try
+	{
+		const int expectedFirings = RUN_LENGTH / STEP_LENGTH / TIMER_INTERVAL;
+
+		cout << std::left << setw(32) << "Frames" << std::right << setw(8) << "Count";
+		cout << setw(10) << "Firings" << setw(10) << "Expected" << endl;
+
+		//None of these frames are longer than MAXIMUM_FRAME_LENGTH, so no time may be lost.
+		bool passed = Check("60 a second", GetEvenTimestamps(3600), expectedFirings);
+		passed = Check("Shorter than a step", GetEvenTimestamps(180001), expectedFirings) && passed;
+		passed = Check("Uneven", GetUnevenTimestamps(40000), expectedFirings) && passed;
+		passed = Check("Uneven, up to the clamp", GetUnevenTimestamps(MAXIMUM_FRAME_LENGTH), expectedFirings) && passed;
+		passed = Check("At the clamp", GetEvenTimestamps(RUN_LENGTH / MAXIMUM_FRAME_LENGTH), expectedFirings) && passed;
+
+		vector<int> stalledTimestamps = GetStalledTimestamps();
+		int expectedStalledFirings = (int)(GetUnclampedTime(GetFrameLengths(stalledTimestamps)) /
+			STEP_LENGTH / TIMER_INTERVAL);
+
+		passed = Check("Stalled past the clamp", stalledTimestamps, expectedStalledFirings) && passed;
+
+		error = passed? 0: 1;
+	}
+	catch(exception& checkException)
+	{
+		cout << checkException.what() << endl;
+		error = 1;
+	}
+
+	return error;
+}
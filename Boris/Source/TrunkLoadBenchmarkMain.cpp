@@ -0,0 +1,349 @@
+#include <SDLInterface/SDLResourceTrunk.h>
+#include <SDLInterface/SDLDecodePool.h>
+#include <SDLInterface/ResourcePack.h>
+#include <Helpers/ApplicationException.h>
+
+#include <SDL/SDL.h>
+#include <SDL/SDL_mixer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::exception;
+using std::fstream;
+using std::setw;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using namespace SDLInterfaceLibrary;
+
+//The trunks which ship with the game, under the names the release build loads them by.
+const char* SHIPPED_TRUNKS[] = {"Data/Global.dat", "Data/MainMenu.dat", "Data/Game.dat",
+	"Data/GameOver.dat", "Data/Score.dat"};
+
+//The synthetic trunk, which holds many small assets like those of the game.
+const char* SYNTHETIC_TRUNK_NAME = "SyntheticTrunk.dat";
+const int NUMBER_OF_SYNTHETIC_ASSETS = 1000;
+//Every SYNTHETIC_SOUND_INTERVAL'th synthetic asset is a sound, and the rest are images.
+const int SYNTHETIC_SOUND_INTERVAL = 4;
+const int SYNTHETIC_IMAGE_SIZE = 96;
+const int SYNTHETIC_SOUND_SAMPLES = 11025;
+
+//How many times each trunk is loaded at each thread count. The fastest load is reported.
+const int NUMBER_OF_REPETITIONS = 5;
+
+//The audio format of the game, which sounds are converted to as they are decoded.
+const int SAMPLE_RATE = 44100;
+const int AUDIO_BUFFER_SIZE = 1024;
+
+//The drivers are set through SDL_putenv, which keeps the strings it is given.
+char VIDEO_DRIVER_VARIABLE[] = "SDL_VIDEODRIVER=dummy";
+char AUDIO_DRIVER_VARIABLE[] = "SDL_AUDIODRIVER=dummy";
+
+/*
+Function: WriteLittleEndianString
+
+Appends the lowest [numberOfBytes] bytes of [value] to [data], least significant first.
+*/
+void WriteLittleEndianString(string& data, Uint32 value, int numberOfBytes)
+{
+	for(int i = 0; i < numberOfBytes; i++)
+	{
+		data += (char)((value >> (8 * i)) & 0xFF);
+	}
+}
+
+/*
+Function: CreateImage
+
+Returns a 24 bit bitmap file of SYNTHETIC_IMAGE_SIZE by SYNTHETIC_IMAGE_SIZE pixels, whose
+pixels depend on [seed].
+*/
+string CreateImage(int seed)
+{
+	int rowSize = (SYNTHETIC_IMAGE_SIZE * 3 + 3) & ~3;
+	int pixelDataSize = rowSize * SYNTHETIC_IMAGE_SIZE;
+
+	string image = "BM";
+
+	WriteLittleEndianString(image, 54 + pixelDataSize, 4);
+	WriteLittleEndianString(image, 0, 4);
+	WriteLittleEndianString(image, 54, 4);
+	WriteLittleEndianString(image, 40, 4);
+	WriteLittleEndianString(image, SYNTHETIC_IMAGE_SIZE, 4);
+	WriteLittleEndianString(image, SYNTHETIC_IMAGE_SIZE, 4);
+	WriteLittleEndianString(image, 1, 2);
+	WriteLittleEndianString(image, 24, 2);
+	WriteLittleEndianString(image, 0, 4);
+	WriteLittleEndianString(image, pixelDataSize, 4);
+	WriteLittleEndianString(image, 2835, 4);
+	WriteLittleEndianString(image, 2835, 4);
+	WriteLittleEndianString(image, 0, 4);
+	WriteLittleEndianString(image, 0, 4);
+
+	for(int y = 0; y < SYNTHETIC_IMAGE_SIZE; y++)
+	{
+		for(int x = 0; x < rowSize; x++)
+		{
+			image += (char)((x * 7 + y * 13 + seed * 31) & 0xFF);
+		}
+	}
+
+	return image;
+}
+
+/*
+Function: CreateSound
+
+Returns a wave file of SYNTHETIC_SOUND_SAMPLES mono, 16 bit samples at 22050Hz, so that it
+has to be converted to the format of the game when it is decoded.
+*/
+string CreateSound(int seed)
+{
+	int sampleDataSize = SYNTHETIC_SOUND_SAMPLES * 2;
+
+	string sound = "RIFF";
+
+	WriteLittleEndianString(sound, 36 + sampleDataSize, 4);
+	sound += "WAVEfmt ";
+	WriteLittleEndianString(sound, 16, 4);
+	WriteLittleEndianString(sound, 1, 2);
+	WriteLittleEndianString(sound, 1, 2);
+	WriteLittleEndianString(sound, 22050, 4);
+	WriteLittleEndianString(sound, 22050 * 2, 4);
+	WriteLittleEndianString(sound, 2, 2);
+	WriteLittleEndianString(sound, 16, 2);
+	sound += "data";
+	WriteLittleEndianString(sound, sampleDataSize, 4);
+
+	for(int i = 0; i < SYNTHETIC_SOUND_SAMPLES; i++)
+	{
+		WriteLittleEndianString(sound, (Uint32)(((i * (seed % 17 + 1)) % 2000 - 1000) * 16) & 0xFFFF, 2);
+	}
+
+	return sound;
+}
+
+/*
+Function: WriteSyntheticTrunk
+
+Writes a pack of NUMBER_OF_SYNTHETIC_ASSETS images and sounds to [fileName].
+*/
+void WriteSyntheticTrunk(const char* fileName)
+{
+	vector<string> files;
+	vector<ResourcePackEntry> entries;
+
+	for(int i = 0; i < NUMBER_OF_SYNTHETIC_ASSETS; i++)
+	{
+		ResourcePackEntry entry;
+		stringstream name;
+
+		if(i % SYNTHETIC_SOUND_INTERVAL == 0)
+		{
+			entry.type = RESOURCE_TYPE_SOUND;
+			name << "Sound" << i;
+			files.push_back(CreateSound(i));
+		}
+		else
+		{
+			entry.type = RESOURCE_TYPE_IMAGE;
+			name << "Image" << i;
+			files.push_back(CreateImage(i));
+		}
+
+		entry.name = name.str();
+		entry.offset = 0;
+		entry.size = files.back().size();
+		entry.hash = HashResourceData(files.back().data(), files.back().size());
+
+		entries.push_back(entry);
+	}
+
+	fstream trunkFile;
+	trunkFile.open(fileName, fstream::out | fstream::binary | fstream::trunc);
+
+	WriteResourcePackHeader(trunkFile, entries);
+
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		trunkFile.write(files[i].data(), files[i].size());
+	}
+
+	trunkFile.close();
+
+	if(!trunkFile)
+	{
+		string error = string("The synthetic trunk could not be written to ") + fileName;
+		throw ApplicationException(error.c_str());
+	}
+}
+
+/*
+Function: MeasureLoad
+
+Returns:
+	The fastest time, in milli-seconds, in which trunk [trunkName] was loaded and had all
+	of its resources decoded on [numberOfThreads] threads.
+*/
+template<class ResourceTrunkType>
+double MeasureLoad(const string& trunkName, int numberOfThreads)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	double fastestTime = 0;
+
+	for(int repetition = 0; repetition < NUMBER_OF_REPETITIONS; repetition++)
+	{
+		ResourceTrunkType trunk(trunkName);
+
+		Clock::time_point loadStart = Clock::now();
+
+		trunk.LoadResources();
+		trunk.DecodeAllResources(numberOfThreads);
+
+		double loadTime = std::chrono::duration<double, std::milli>(Clock::now() - loadStart).count();
+
+		if(repetition == 0 || loadTime < fastestTime)
+		{
+			fastestTime = loadTime;
+		}
+	}
+
+	return fastestTime;
+}
+
+/*
+Function: ReportTrunk
+
+Writes how long trunk [trunkName] takes to load at each of [threadCounts]. Packs are
+loaded as the release build loads them, and folders as the debug build does.
+*/
+void ReportTrunk(const string& trunkName, const vector<int>& threadCounts)
+{
+	bool isPack = trunkName.size() > 4 && trunkName.substr(trunkName.size() - 4) == ".dat";
+
+	cout << std::left << setw(24) << trunkName << std::right;
+
+	double singleThreadTime = 0;
+
+	for(size_t i = 0; i < threadCounts.size(); i++)
+	{
+		double loadTime = isPack?
+			MeasureLoad<MappedFileResourceTrunk>(trunkName, threadCounts[i]):
+			MeasureLoad<FolderResourceTrunk>(trunkName, threadCounts[i]);
+
+		if(i == 0)
+		{
+			singleThreadTime = loadTime;
+		}
+
+		cout << setw(10) << std::fixed << std::setprecision(2) << loadTime;
+		cout << " (" << std::setprecision(1) << singleThreadTime / loadTime << "x)";
+	}
+
+	cout << endl;
+}
+
+/*
+Loads the shipped trunks and a synthetic trunk of NUMBER_OF_SYNTHETIC_ASSETS assets, decoding
+every resource, and reports the wall time of each at 1, 2, 4... threads up to the number of
+processors. Other trunks, packs or folders, can be given instead of the shipped ones.
+
+Usage: TrunkLoadBenchmark [--threads N] [trunk...]
+*/
+int main(int argc, char** argv)
+{
+	int maximumNumberOfThreads = SDLDecodePool::GetNumberOfProcessors();
+	vector<string> trunkNames;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			maximumNumberOfThreads = std::max(1, atoi(argv[++i]));
+		}
+		else
+		{
+			trunkNames.push_back(argv[i]);
+		}
+	}
+
+	if(trunkNames.empty())
+	{
+		trunkNames.assign(SHIPPED_TRUNKS, SHIPPED_TRUNKS + sizeof(SHIPPED_TRUNKS) / sizeof(SHIPPED_TRUNKS[0]));
+	}
+
+	vector<int> threadCounts;
+
+	for(int numberOfThreads = 1; numberOfThreads < maximumNumberOfThreads; numberOfThreads *= 2)
+	{
+		threadCounts.push_back(numberOfThreads);
+	}
+
+	threadCounts.push_back(maximumNumberOfThreads);
+
+	SDL_putenv(VIDEO_DRIVER_VARIABLE);
+	SDL_putenv(AUDIO_DRIVER_VARIABLE);
+
+	int error = 0;
+
+	try
+	{
+		if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) == -1)
+		{
+			throw SDLException();
+		}
+
+		if(!(Mix_Init(MIX_INIT_OGG) & MIX_INIT_OGG) ||
+			Mix_OpenAudio(SAMPLE_RATE, AUDIO_S16, 2, AUDIO_BUFFER_SIZE) == -1)
+		{
+			throw MixException();
+		}
+
+		WriteSyntheticTrunk(SYNTHETIC_TRUNK_NAME);
+		trunkNames.push_back(SYNTHETIC_TRUNK_NAME);
+
+		cout << "Milli-seconds to load and decode each trunk, the fastest of " << NUMBER_OF_REPETITIONS;
+		cout << " loads, and the speed up over 1 thread:" << endl;
+
+		cout << std::left << setw(24) << "Threads" << std::right;
+
+		for(size_t i = 0; i < threadCounts.size(); i++)
+		{
+			cout << setw(17) << threadCounts[i];
+		}
+
+		cout << endl;
+
+		for(size_t i = 0; i < trunkNames.size(); i++)
+		{
+			ReportTrunk(trunkNames[i], threadCounts);
+		}
+	}
+	catch(exception& loadException)
+	{
+		cout << "Error: " << loadException.what() << endl;
+		error = 1;
+	}
+
+	remove(SYNTHETIC_TRUNK_NAME);
+
+	Mix_CloseAudio();
+	Mix_Quit();
+	SDL_Quit();
+
+	return error;
+}